@@ -0,0 +1,131 @@
+#pragma once
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+	Companion of TestRunner.h for performance measurements
+	Each benchmark function reports its own timings through bench::report()
+	Values are printed as "<name>: <items/s>" so runs can be compared by eye, and collected so that
+	"--json <file>" writes them as machine-readable JSON to diff runs across commits
+	Command line: [--json <file>] [--filter <substring of benchmark name>] [--max-size <n>]
+*/
+
+#define RUN_BENCH(br, func) {					\
+	br.runBenchmark((func), #func);				\
+}
+
+namespace bench {
+    class Timer {
+    private:
+        std::chrono::steady_clock::time_point start_;
+    public:
+        Timer() : start_(std::chrono::steady_clock::now()) {}
+
+        double seconds() const {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        }
+    };
+
+    struct Result {
+        std::string benchmark;
+        std::string name;
+        double items;
+        double seconds;
+        std::string unit;
+    };
+
+    inline std::vector<Result>& results() {
+        static std::vector<Result> results;
+        return results;
+    }
+
+    inline std::string& currentBenchmark() {
+        static std::string name;
+        return name;
+    }
+
+    // Largest workload size the benchmarks should generate, set by --max-size
+    inline size_t& maxSize() {
+        static size_t size = 10000000;
+        return size;
+    }
+
+    inline void report(const std::string& name, double items, double seconds, const std::string& unit = "points") {
+        std::cout << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(16) << items / seconds << " " << unit << "/s"
+                  << std::setw(12) << std::setprecision(3) << seconds * 1e3 << " ms" << std::endl;
+        results().push_back(Result{currentBenchmark(), name, items, seconds, unit});
+    }
+
+    inline std::string jsonString(const std::string& s) {
+        std::ostringstream os;
+        os << '"';
+        for (char c : s) {
+            if (c == '"' || c == '\\')
+                os << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20)
+                os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+            else
+                os << c;
+        }
+        os << '"';
+        return os.str();
+    }
+
+    class BenchmarkRunner {
+    private:
+        std::string json_;
+        std::string filter_;
+    public:
+        BenchmarkRunner(int argc = 0, char** argv = nullptr) {
+            for (int i = 1; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg == "--json" && i + 1 < argc) {
+                    json_ = argv[++i];
+                } else if (arg == "--filter" && i + 1 < argc) {
+                    filter_ = argv[++i];
+                } else if (arg == "--max-size" && i + 1 < argc) {
+                    maxSize() = std::strtoull(argv[++i], nullptr, 10);
+                } else {
+                    std::cerr << "Unknown argument " << arg << std::endl
+                              << "Usage: " << argv[0] << " [--json <file>] [--filter <name>] [--max-size <n>]"
+                              << std::endl;
+                    std::exit(2);
+                }
+            }
+        }
+
+        ~BenchmarkRunner() {
+            if (json_.empty())
+                return;
+            std::ofstream out(json_);
+            out << std::setprecision(17) << "{\n  \"max_size\": " << maxSize() << ",\n  \"results\": [";
+            for (size_t i = 0; i < results().size(); ++i) {
+                const Result& r = results()[i];
+                out << (i == 0 ? "\n" : ",\n")
+                    << "    {\"benchmark\": " << jsonString(r.benchmark) << ", \"name\": " << jsonString(r.name)
+                    << ", \"items\": " << r.items << ", \"seconds\": " << r.seconds
+                    << ", \"rate\": " << r.items / r.seconds << ", \"unit\": " << jsonString(r.unit) << "}";
+            }
+            out << "\n  ]\n}\n";
+            if (!out)
+                std::cerr << "Could not write " << json_ << std::endl;
+        }
+
+        template<typename BenchFunc>
+        void runBenchmark(BenchFunc func, const std::string& name) {
+            if (name.find(filter_) == std::string::npos)
+                return;
+            std::cout << "== " << name << std::endl;
+            currentBenchmark() = name;
+            func();
+        }
+    };
+}
@@ -72,6 +72,16 @@ namespace test {
         }
     };
 
+    std::ostream& operator<<(std::ostream& os, const lgm::Point& p) {
+        os << p.x << " " << p.y;
+        return os;
+    }
+
+    std::ostream& operator<<(std::ostream& os, lgm::Direction d) {
+        os << (d == lgm::Direction::CCW ? "CCW" : (d == lgm::Direction::CW ? "CW" : "COLLINEAR"));
+        return os;
+    }
+
     template<typename T>
     std::ostream& operator<<(std::ostream& os, const std::vector<T>& vec) {
         os << "{ ";
@@ -84,10 +94,6 @@ namespace test {
         return os;
     }
 
-    std::ostream& operator<<(std::ostream& os, const lgm::Point& p) {
-        os << p.x << " " << p.y;
-        return os;
-    }
 
 
 
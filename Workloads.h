@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "include/LGeometry.h"
+
+/*
+	Seeded workload generators for the benchmarks
+	Generators draw from their own splitmix64 source instead of std distributions, whose output differs between
+	standard libraries, so a (size, seed) pair describes the same geometry from run to run and commit to commit
+*/
+
+namespace bench {
+    namespace workload {
+        class Random {
+        private:
+            uint64_t state_;
+        public:
+            explicit Random(uint64_t seed) : state_(seed) {}
+
+            uint64_t next() {
+                uint64_t z = (state_ += 0x9e3779b97f4a7c15ull);
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+                return z ^ (z >> 31);
+            }
+
+            // Uniform in [lo, hi)
+            double uniform(double lo = 0, double hi = 1) {
+                return lo + (hi - lo) * static_cast<double>(next() >> 11) / 9007199254740992.0;
+            }
+
+            // Approximately standard normal (Irwin-Hall sum of 12 uniforms)
+            double normal() {
+                double sum = 0;
+                for (int i = 0; i < 12; ++i)
+                    sum += uniform();
+                return sum - 6;
+            }
+        };
+
+        // n points uniform in [-extent, extent]^2
+        inline std::vector<lgm::Point> uniformPoints(size_t n, uint64_t seed, double extent = 1e6) {
+            Random random(seed);
+            std::vector<lgm::Point> points(n);
+            for (auto& p : points)
+                p = lgm::Point(random.uniform(-extent, extent), random.uniform(-extent, extent));
+            return points;
+        }
+
+        // n points in normally distributed clusters around uniformly placed centers
+        inline std::vector<lgm::Point> clusteredPoints(size_t n, uint64_t seed, size_t clusters = 32,
+                                                       double extent = 1e6) {
+            Random random(seed);
+            std::vector<lgm::Point> centers = uniformPoints(clusters, random.next(), extent);
+            double spread = extent / (4 * std::sqrt(static_cast<double>(clusters)));
+            std::vector<lgm::Point> points(n);
+            for (auto& p : points) {
+                const lgm::Point& c = centers[random.next() % clusters];
+                p = lgm::Point(c.x + spread * random.normal(), c.y + spread * random.normal());
+            }
+            return points;
+        }
+
+        // Star-shaped simple polygon: n vertices at sorted random angles and random radii in [radius / 2, radius)
+        inline std::vector<lgm::Point> simplePolygon(size_t n, uint64_t seed, double radius = 1e6) {
+            Random random(seed);
+            const double pi = std::acos(-1.0);
+            std::vector<double> angles(n);
+            for (auto& angle : angles)
+                angle = random.uniform(0, 2 * pi);
+            std::sort(angles.begin(), angles.end());
+            std::vector<lgm::Point> vertices(n);
+            for (size_t i = 0; i < n; ++i) {
+                double r = random.uniform(radius / 2, radius);
+                vertices[i] = lgm::Point(r * std::cos(angles[i]), r * std::sin(angles[i]));
+            }
+            return vertices;
+        }
+
+        // Convex polygon through up to n random points of a circle (rounding may drop a few of them)
+        inline lgm::ConvexPolygon convexPolygon(size_t n, uint64_t seed, double radius = 1e6) {
+            Random random(seed);
+            const double pi = std::acos(-1.0);
+            std::vector<lgm::Point> points(std::max<size_t>(n, 3));
+            for (auto& p : points) {
+                double angle = random.uniform(0, 2 * pi);
+                p = lgm::Point(radius * std::cos(angle), radius * std::sin(angle));
+            }
+            return lgm::ModifiedGrahamScan(points);
+        }
+
+        // n segments with uniform start points in [-extent, extent]^2 and random directions of up to length
+        inline std::vector<lgm::Segment> segments(size_t n, uint64_t seed, double length, double extent = 1e6) {
+            Random random(seed);
+            std::vector<lgm::Segment> result(n);
+            for (auto& s : result) {
+                lgm::Point a(random.uniform(-extent, extent), random.uniform(-extent, extent));
+                lgm::Point d(random.uniform(-length, length), random.uniform(-length, length));
+                s = lgm::Segment(a, a + d);
+            }
+            return result;
+        }
+    }
+}
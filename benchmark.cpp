@@ -0,0 +1,1205 @@
+#include "include/LGeometry.h"
+#include "BenchmarkRunner.h"
+#include "Workloads.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+using namespace lgm;
+
+void BenchPolygonLocate();
+void BenchPolygonIndex();
+void BenchConvexContains();
+void BenchConvexHull();
+void BenchDynamicConvexHull();
+void BenchSegmentIntersections();
+void BenchOrientation();
+void BenchPolygonScan();
+void BenchPolygonRTree();
+void BenchPolygonStore();
+void BenchPolygonIO();
+void BenchConvexOperations();
+void BenchPolygonBoolean();
+void BenchRotatingCalipers();
+void BenchPointKDTree();
+void BenchTriangulation();
+void BenchBasicPolygon();
+void BenchPointInlining();
+void BenchSpatialHash();
+void BenchSimplification();
+void BenchPolygonSimplicity();
+void BenchContainmentGrid();
+void BenchPolygonProperties();
+void BenchSuiteAreaPerimeter();
+void BenchSuitePolygonContains();
+void BenchSuiteConvexContains();
+void BenchSuiteConvexHull();
+void BenchSuiteSegments();
+
+int main(int argc, char** argv) {
+    bench::BenchmarkRunner br(argc, argv);
+    RUN_BENCH(br, BenchPolygonLocate);
+    RUN_BENCH(br, BenchPolygonIndex);
+    RUN_BENCH(br, BenchConvexContains);
+    RUN_BENCH(br, BenchConvexHull);
+    RUN_BENCH(br, BenchDynamicConvexHull);
+    RUN_BENCH(br, BenchSegmentIntersections);
+    RUN_BENCH(br, BenchOrientation);
+    RUN_BENCH(br, BenchPolygonScan);
+    RUN_BENCH(br, BenchPolygonRTree);
+    RUN_BENCH(br, BenchPolygonStore);
+    RUN_BENCH(br, BenchPolygonIO);
+    RUN_BENCH(br, BenchConvexOperations);
+    RUN_BENCH(br, BenchPolygonBoolean);
+    RUN_BENCH(br, BenchRotatingCalipers);
+    RUN_BENCH(br, BenchPointKDTree);
+    RUN_BENCH(br, BenchTriangulation);
+    RUN_BENCH(br, BenchBasicPolygon);
+    RUN_BENCH(br, BenchPointInlining);
+    RUN_BENCH(br, BenchSpatialHash);
+    RUN_BENCH(br, BenchSimplification);
+    RUN_BENCH(br, BenchPolygonSimplicity);
+    RUN_BENCH(br, BenchContainmentGrid);
+    RUN_BENCH(br, BenchPolygonProperties);
+    RUN_BENCH(br, BenchSuiteAreaPerimeter);
+    RUN_BENCH(br, BenchSuitePolygonContains);
+    RUN_BENCH(br, BenchSuiteConvexContains);
+    RUN_BENCH(br, BenchSuiteConvexHull);
+    RUN_BENCH(br, BenchSuiteSegments);
+    return 0;
+}
+
+namespace {
+    // ccw() before it switched to orient2d(): the determinant truncated to int
+    Direction truncatedCcw(const Point &p, const Point &q, const Point &r) {
+        int det = static_cast<int>((q.x - p.x) * (r.y - p.y) - (r.x - p.x) * (q.y - p.y));
+        return (det > 0 ? Direction::CCW : (det < 0 ? Direction::CW : Direction::COLLINEAR));
+    }
+
+    // std::hash<Point> before it mixed the bits: only meaningful for non-negative coordinates
+    struct TruncatedPointHash {
+        size_t operator()(const Point& point) const {
+            return point.x + 31 * point.y;
+        }
+    };
+
+    bool isCollinearSet(const std::vector<Point>& points) {
+        for (const auto& p : points)
+            if (ccw(points[0], points[1], p) != Direction::COLLINEAR)
+                return false;
+        return true;
+    }
+
+    // Workload sizes 10, 100, ... up to --max-size
+    std::vector<size_t> suiteSizes() {
+        std::vector<size_t> sizes;
+        for (size_t n = 10; n <= bench::maxSize(); n *= 10)
+            sizes.push_back(n);
+        return sizes;
+    }
+
+    /*
+     * Star shaped (non-convex) polygon with n vertices alternating between two radii
+     */
+    std::vector<Point> makeStar(size_t n, double outer, double inner) {
+        const double pi = std::acos(-1.0);
+        std::vector<Point> vertices;
+        vertices.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            double angle = 2 * pi * i / n;
+            double r = (i % 2 == 0) ? outer : inner;
+            vertices.emplace_back(r * std::cos(angle), r * std::sin(angle));
+        }
+        return vertices;
+    }
+    // contains() throughput and vertex memory of BasicPolygon<T> over integer vertices and queries
+    template<typename T>
+    void benchBasicPolygon(const std::string& name, const std::vector<Point>& vertices,
+                           const std::vector<Point>& queries, size_t repeats) {
+        std::vector<BasicPoint<T>> rounded;
+        for (const auto& p : vertices)
+            rounded.emplace_back(static_cast<T>(p.x), static_cast<T>(p.y));
+        std::vector<BasicPoint<T>> points;
+        for (const auto& p : queries)
+            points.emplace_back(static_cast<T>(p.x), static_cast<T>(p.y));
+        BasicPolygon<T> polygon(rounded);
+        std::cout << "memory " << name << ": " << polygon.size() * sizeof(BasicPoint<T>) << " bytes" << std::endl;
+
+        size_t inside = 0;
+        bench::Timer timer;
+        for (size_t r = 0; r < repeats; ++r)
+            for (const auto& p : points)
+                inside += polygon.contains(p);
+        bench::report("contains, " + name, points.size() * repeats, timer.seconds(), "queries");
+        if (inside == 0)
+            std::cout << "(no points inside)" << std::endl;
+    }
+}
+
+void BenchPolygonLocate() {
+    const size_t points = 1000000;
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> coord(-12000, 12000);
+    std::vector<double> xs(points), ys(points);
+    for (size_t i = 0; i < points; ++i) {
+        xs[i] = coord(rng);
+        ys[i] = coord(rng);
+    }
+    std::vector<Location> result(points);
+
+    for (size_t n : {16, 64, 256, 1024}) {
+        Polygon polygon(makeStar(n, 10000, 5000));
+        size_t sample = points / (n / 16);
+
+        bench::Timer scalar;
+        size_t inside = 0;
+        for (size_t i = 0; i < sample; ++i)
+            inside += polygon.contains(Point(xs[i], ys[i]));
+        bench::report("contains, n = " + std::to_string(n), sample, scalar.seconds());
+
+        bench::Timer batch;
+        polygon.locate(xs.data(), ys.data(), sample, result.data());
+        bench::report("locate, n = " + std::to_string(n), sample, batch.seconds());
+
+        if (inside == 0)
+            std::cout << "(no points inside)" << std::endl;
+    }
+}
+
+void BenchPolygonIndex() {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> coord(-12000, 12000);
+
+    for (size_t n : {1000, 50000, 500000}) {
+        Polygon polygon(makeStar(n, 10000, 5000));
+        polygon.buildIndex();
+        std::cout << "n = " << n << ": index built in " << polygon.index()->buildTime() * 1e3 << " ms, "
+                  << polygon.index()->memoryUsage() / 1024 << " KiB" << std::endl;
+
+        const size_t queries = 200000;
+        std::vector<Point> points;
+        for (size_t i = 0; i < queries; ++i)
+            points.emplace_back(coord(rng), coord(rng));
+
+        bench::Timer indexed;
+        size_t inside = 0;
+        for (const auto& p : points)
+            inside += polygon.contains(p);
+        bench::report("indexed contains, n = " + std::to_string(n), queries, indexed.seconds());
+
+        polygon.dropIndex();
+        size_t sample = std::max<size_t>(100, queries / n * 100);
+        bench::Timer scan;
+        for (size_t i = 0; i < sample; ++i)
+            inside += polygon.contains(points[i]);
+        bench::report("linear contains, n = " + std::to_string(n), sample, scan.seconds());
+
+        if (inside == 0)
+            std::cout << "(no points inside)" << std::endl;
+    }
+}
+
+void BenchConvexContains() {
+    const size_t points = 1000000;
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> coord(-1.2e6, 1.2e6);
+    std::vector<double> xs(points), ys(points);
+    for (size_t i = 0; i < points; ++i) {
+        xs[i] = coord(rng);
+        ys[i] = coord(rng);
+    }
+    std::vector<Location> result(points);
+
+    for (size_t n : {16, 256, 4096, 65536}) {
+        ConvexPolygon convex(makeStar(n, 1e6, 1e6));
+
+        bench::Timer single;
+        size_t inside = 0;
+        for (size_t i = 0; i < points; ++i)
+            inside += convex.contains(Point(xs[i], ys[i]));
+        bench::report("ConvexPolygon::contains, n = " + std::to_string(n), points, single.seconds());
+
+        bench::Timer batch;
+        convex.locate(xs.data(), ys.data(), points, result.data());
+        bench::report("ConvexPolygon::locate, n = " + std::to_string(n), points, batch.seconds());
+
+        if (inside == 0)
+            std::cout << "(no points inside)" << std::endl;
+    }
+}
+
+void BenchConvexHull() {
+    const size_t n = 5000000;
+    std::mt19937_64 rng(13);
+    std::uniform_real_distribution<double> coord(-10000, 10000);
+    std::vector<Point> points(n);
+    for (auto& p : points)
+        p = Point(coord(rng), coord(rng));
+
+    bench::Timer graham;
+    size_t expected = ModifiedGrahamScan(points).size();
+    bench::report("ModifiedGrahamScan, n = " + std::to_string(n), n, graham.seconds());
+
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads : {size_t(1), hardware}) {
+        bench::Timer parallel;
+        size_t size = ParallelConvexHull(points, threads).size();
+        bench::report("ParallelConvexHull, threads = " + std::to_string(threads), n, parallel.seconds());
+        if (size != expected)
+            std::cout << "(hull size mismatch: " << size << " != " << expected << ")" << std::endl;
+        if (hardware == 1)
+            break;
+    }
+}
+
+void BenchDynamicConvexHull() {
+    const size_t n = 1000000;
+    std::mt19937_64 rng(17);
+    std::normal_distribution<double> coord(0, 3000);
+    std::vector<Point> points(n);
+    for (auto& p : points)
+        p = Point(coord(rng), coord(rng));
+
+    DynamicConvexHull hull;
+    bench::Timer insert;
+    for (const auto& p : points)
+        hull.add(p);
+    bench::report("DynamicConvexHull::add, n = " + std::to_string(n), n, insert.seconds());
+
+    bench::Timer query;
+    size_t inside = 0;
+    for (const auto& p : points)
+        inside += hull.contains(p * 1.5);
+    bench::report("DynamicConvexHull::contains, hull size = " + std::to_string(hull.size()), n, query.seconds());
+    if (inside == 0)
+        std::cout << "(no points inside)" << std::endl;
+}
+
+void BenchSegmentIntersections() {
+    std::mt19937_64 rng(23);
+    std::uniform_real_distribution<double> coord(0, 100000);
+    std::uniform_real_distribution<double> offset(-300, 300);
+    for (size_t n : {10000, 100000, 1000000}) {
+        std::vector<Segment> segments(n);
+        for (auto& s : segments) {
+            Point a(coord(rng), coord(rng));
+            s = Segment(a, a + Point(offset(rng), offset(rng)));
+        }
+
+        bench::Timer timer;
+        size_t found = 0;
+        calculateIntersections(segments, [&](const SegmentIntersection&) { found++; });
+        bench::report("calculateIntersections, n = " + std::to_string(n) + ", k = " + std::to_string(found),
+                      n, timer.seconds(), "segments");
+    }
+}
+
+void BenchOrientation() {
+    const size_t n = 4000000;
+    std::mt19937_64 rng(29);
+    std::uniform_real_distribution<double> coord(-10000, 10000);
+    std::uniform_real_distribution<double> unit(0, 1);
+
+    std::vector<Point> random(n + 2);
+    for (auto& p : random)
+        p = Point(coord(rng), coord(rng));
+    // Points on long segments, rounded to doubles: the filter can rarely prove their sign
+    std::vector<Point> nearCollinear(n + 2);
+    for (size_t i = 0; i < nearCollinear.size(); i += 3) {
+        Point a(coord(rng), coord(rng)), b(coord(rng), coord(rng));
+        nearCollinear[i] = a;
+        if (i + 1 < nearCollinear.size()) nearCollinear[i + 1] = b;
+        if (i + 2 < nearCollinear.size()) nearCollinear[i + 2] = a + (b - a) * unit(rng);
+    }
+
+    // Both are called through a pointer so that neither gets inlined into the loop
+    Direction (* volatile truncated)(const Point&, const Point&, const Point&) = truncatedCcw;
+    Direction (* volatile exact)(const Point&, const Point&, const Point&) = ccw;
+    for (const auto& workload : {std::make_pair("random", &random), std::make_pair("near collinear", &nearCollinear)}) {
+        const std::vector<Point>& points = *workload.second;
+        size_t counts[3] = {0, 0, 0};
+
+        Direction (*orientation)(const Point&, const Point&, const Point&) = truncated;
+        bench::Timer old;
+        for (size_t i = 0; i < n; ++i)
+            counts[static_cast<int>(orientation(points[i], points[i + 1], points[i + 2]))]++;
+        bench::report(std::string("truncated ccw, ") + workload.first, n, old.seconds(), "tests");
+
+        orientation = exact;
+        counts[0] = counts[1] = counts[2] = 0;
+        resetPredicateCounters();
+        bench::Timer filtered;
+        for (size_t i = 0; i < n; ++i)
+            counts[static_cast<int>(orientation(points[i], points[i + 1], points[i + 2]))]++;
+        bench::report(std::string("ccw, ") + workload.first, n, filtered.seconds(), "tests");
+
+        PredicateCounters counters = predicateCounters();
+        std::cout << "fallbacks: adaptive " << counters.adaptive << " (" << 100.0 * counters.adaptive / n
+                  << "%), exact " << counters.exact << ", collinear " << counts[1] << std::endl;
+    }
+}
+
+void BenchPolygonScan() {
+    const size_t count = 1000000;
+    std::mt19937_64 rng(31);
+    std::uniform_int_distribution<size_t> size(3, 16);
+
+    std::vector<Polygon> polygons;
+    polygons.reserve(count);
+    size_t vertices = 0, bytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        polygons.emplace_back(makeStar(size(rng) * 2, 100, 60));
+        vertices += polygons.back().size();
+        bytes += sizeof(Polygon) + polygons.back().vertices().capacity() * sizeof(Point);
+    }
+    std::cout << count << " polygons, " << vertices << " vertices: " << bytes / (1 << 20) << " MiB, "
+              << static_cast<double>(bytes) / vertices << " bytes per vertex" << std::endl;
+
+    bench::Timer measures;
+    double total = 0;
+    for (const auto& polygon : polygons)
+        total += polygon.area() + polygon.perimeter();
+    bench::report("area + perimeter", vertices, measures.seconds(), "vertices");
+
+    bench::Timer edges;
+    size_t crossings = 0;
+    for (const auto& polygon : polygons)
+        for (const auto& edge : polygon.edges())
+            crossings += edge.start().y < 0 && edge.end().y >= 0;
+    bench::report("edges() scan", vertices, edges.seconds(), "vertices");
+
+    bench::Timer contains;
+    size_t inside = 0;
+    for (const auto& polygon : polygons)
+        inside += polygon.contains(Point(10, 10));
+    bench::report("contains", vertices, contains.seconds(), "vertices");
+
+    if (total == 0 || crossings == 0 || inside == 0)
+        std::cout << "(degenerate workload)" << std::endl;
+}
+
+void BenchPolygonRTree() {
+    // Parcels: a 2000 x 1000 grid of quadrilaterals with jittered shared corners
+    const size_t columns = 2000, rows = 1000;
+    const double cell = 100;
+    std::mt19937_64 rng(37);
+    std::uniform_real_distribution<double> jitter(-30, 30);
+    std::vector<Point> corners((columns + 1) * (rows + 1));
+    for (size_t j = 0; j <= rows; ++j)
+        for (size_t i = 0; i <= columns; ++i)
+            corners[j * (columns + 1) + i] = Point(i * cell + jitter(rng), j * cell + jitter(rng));
+    std::vector<Polygon> parcels;
+    parcels.reserve(columns * rows);
+    for (size_t j = 0; j < rows; ++j) {
+        for (size_t i = 0; i < columns; ++i) {
+            size_t c = j * (columns + 1) + i;
+            parcels.emplace_back(std::vector<Point>{corners[c], corners[c + 1], corners[c + columns + 2],
+                                                    corners[c + columns + 1]});
+        }
+    }
+
+    PolygonRTree tree(parcels);
+    std::cout << parcels.size() << " parcels: tree built in " << tree.buildTime() * 1e3 << " ms, "
+              << tree.memoryUsage() / (1 << 20) << " MiB" << std::endl;
+
+    const size_t queries = 1000000;
+    std::uniform_real_distribution<double> x(0, columns * cell), y(0, rows * cell);
+    std::vector<Point> points(queries);
+    for (auto& p : points)
+        p = Point(x(rng), y(rng));
+
+    bench::Timer containing;
+    size_t found = 0;
+    for (const auto& p : points)
+        found += tree.containing(p).size();
+    double seconds = containing.seconds();
+    bench::report("containing", queries, seconds, "queries");
+    std::cout << "latency " << seconds / queries * 1e9 << " ns, " << static_cast<double>(found) / queries
+              << " polygons per query" << std::endl;
+
+    bench::Timer overlapping;
+    found = 0;
+    for (const auto& p : points)
+        found += tree.overlapping(BoundingBox(p.x, p.y, p.x + 3 * cell, p.y + 3 * cell)).size();
+    bench::report("overlapping, 3x3 cells", queries, overlapping.seconds(), "queries");
+
+    const size_t knnQueries = queries / 10;
+    bench::Timer nearest;
+    for (size_t i = 0; i < knnQueries; ++i)
+        found += tree.nearest(points[i], 8).size();
+    bench::report("nearest, k = 8", knnQueries, nearest.seconds(), "queries");
+
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    if (hardware > 1) {
+        std::vector<std::thread> workers;
+        bench::Timer parallel;
+        for (size_t t = 0; t < hardware; ++t) {
+            workers.emplace_back([&, t]() {
+                for (size_t i = t; i < queries; i += hardware)
+                    tree.containing(points[i]);
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+        bench::report("containing, threads = " + std::to_string(hardware), queries, parallel.seconds(), "queries");
+    }
+
+    if (found == 0)
+        std::cout << "(nothing found)" << std::endl;
+}
+
+void BenchPolygonStore() {
+    // 500k polygons of 12 vertices, about 100 MB on disk
+    const size_t count = std::min<size_t>(500000, bench::maxSize()), n = 12;
+    const std::string path = "polygon_store_bench.bin";
+    {
+        bench::Timer write;
+        PolygonStoreWriter writer(path);
+        for (size_t i = 0; i < count; ++i) {
+            std::vector<Point> vertices = bench::workload::simplePolygon(n, i, 50);
+            for (auto& v : vertices)
+                v = v + Point((i % 1000) * 100.0, (i / 1000) * 100.0);
+            writer.add(vertices);
+        }
+        writer.close();
+        bench::report("write", count, write.seconds(), "polygons");
+    }
+
+    bench::Timer open;
+    PolygonStore store(path);
+    bench::report("open", count, open.seconds(), "polygons");
+
+    bench::Timer scan;
+    double area = 0;
+    for (size_t i = 0; i < store.size(); ++i)
+        area += store[i].area();
+    bench::report("PolygonView::area, first pass", count, scan.seconds(), "polygons");
+
+    bench::Timer verify;
+    bool valid = store.verify();
+    bench::report("verify", store.vertexCount(), verify.seconds(), "vertices");
+
+    // What loading the collection costs without the store
+    bench::Timer load;
+    std::vector<Polygon> polygons;
+    polygons.reserve(count);
+    for (size_t i = 0; i < store.size(); ++i)
+        polygons.emplace_back(std::vector<Point>(store[i].begin(), store[i].end()));
+    bench::report("copy into std::vector<Polygon>", count, load.seconds(), "polygons");
+
+    const size_t queries = 2000000;
+    bench::workload::Random random(5);
+    std::vector<std::pair<size_t, Point>> points(queries);
+    for (auto& q : points) {
+        q.first = random.next() % count;
+        Point corner((q.first % 1000) * 100.0, (q.first / 1000) * 100.0);
+        q.second = corner + Point(random.uniform(-50, 50), random.uniform(-50, 50));
+    }
+
+    bench::Timer viewContains;
+    size_t inside = 0;
+    for (const auto& q : points)
+        inside += store[q.first].contains(q.second);
+    bench::report("PolygonView::contains", queries, viewContains.seconds(), "queries");
+
+    bench::Timer polygonContains;
+    for (const auto& q : points)
+        inside -= polygons[q.first].contains(q.second);
+    bench::report("Polygon::contains", queries, polygonContains.seconds(), "queries");
+
+    if (!valid || inside != 0 || area == 0)
+        std::cout << "(store mismatch)" << std::endl;
+    std::remove(path.c_str());
+}
+
+void BenchPolygonIO() {
+    const size_t count = std::min<size_t>(100000, bench::maxSize()), n = 16;
+    // Full double precision, and coordinates in centimetres as in survey data
+    std::vector<Polygon> full, rounded;
+    full.reserve(count);
+    rounded.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::vector<Point> vertices = bench::workload::simplePolygon(n, i, 1e6);
+        full.emplace_back(vertices);
+        for (auto& v : vertices)
+            v = Point(std::round(v.x * 100) / 100, std::round(v.y * 100) / 100);
+        rounded.emplace_back(vertices);
+    }
+
+    for (auto format : {GeometryFormat::WKT, GeometryFormat::GEOJSON}) {
+        for (const auto* polygons : {&full, &rounded}) {
+            std::string name = std::string(format == GeometryFormat::WKT ? "WKT" : "GeoJSON") +
+                               (polygons == &full ? ", full precision" : ", centimetres");
+            std::ostringstream out;
+            bench::Timer write;
+            writePolygons(out, *polygons, format);
+            double writeSeconds = write.seconds();
+            std::string text = out.str();
+            const double megabytes = text.size() / 1e6;
+            bench::report(name + " write", megabytes, writeSeconds, "MB");
+
+            // Stream in 64 KiB chunks, vertices only
+            std::istringstream in(text);
+            bench::Timer stream;
+            PolygonReader streamed(in, format);
+            size_t vertices = 0;
+            while (streamed.next())
+                vertices += streamed.vertices().size();
+            bench::report(name + " read, stream", megabytes, stream.seconds(), "MB");
+
+            bench::Timer buffer;
+            PolygonReader buffered(text.data(), text.size(), format);
+            std::vector<Polygon> read;
+            read.reserve(count);
+            while (buffered.next())
+                read.push_back(buffered.polygon());
+            bench::report(name + " read, buffer, into Polygon", megabytes, buffer.seconds(), "MB");
+
+            if (vertices != count * n || read.size() != count)
+                std::cout << "(read " << read.size() << " polygons)" << std::endl;
+        }
+    }
+}
+
+void BenchConvexOperations() {
+    for (size_t n : {8, 64, 1024}) {
+        // Pairs of footprints of radius 1 whose centres are up to 1.5 apart, most of them overlapping
+        const size_t pairs = 256;
+        bench::workload::Random random(n);
+        std::vector<ConvexPolygon> polygons;
+        for (size_t i = 0; i < 2 * pairs; ++i) {
+            ConvexPolygon footprint = bench::workload::convexPolygon(n, random.next(), 1);
+            std::vector<Point> vertices = footprint.vertices();
+            Point shift(random.uniform(-0.75, 0.75), random.uniform(-0.75, 0.75));
+            for (auto& v : vertices)
+                v = v + shift;
+            polygons.emplace_back(vertices);
+        }
+        const size_t repeats = std::max<size_t>(1, 1000000 / (n * pairs));
+        const std::string suffix = ", n = " + std::to_string(n);
+
+        ConvexPolygon result = polygons[0];
+        bench::Timer inPlace;
+        size_t overlapping = 0;
+        for (size_t r = 0; r < repeats; ++r)
+            for (size_t i = 0; i < pairs; ++i)
+                overlapping += intersection(polygons[2 * i], polygons[2 * i + 1], result);
+        bench::report("intersection, in place" + suffix, pairs * repeats, inPlace.seconds(), "pairs");
+
+        bench::Timer byValue;
+        double area = 0;
+        for (size_t r = 0; r < repeats; ++r)
+            for (size_t i = 0; i < pairs; ++i)
+                if (overlapping > 0)
+                    try {
+                        area += intersection(polygons[2 * i], polygons[2 * i + 1]).area();
+                    } catch (const std::logic_error&) {
+                    }
+        bench::report("intersection" + suffix, pairs * repeats, byValue.seconds(), "pairs");
+
+        // What callers did before: vertices of each polygon inside the other, hulled (crossings not even included)
+        bench::Timer hulled;
+        for (size_t r = 0; r < repeats; ++r) {
+            for (size_t i = 0; i < pairs; ++i) {
+                const ConvexPolygon& a = polygons[2 * i];
+                const ConvexPolygon& b = polygons[2 * i + 1];
+                std::vector<Point> inside;
+                for (const auto& v : a.vertices())
+                    if (b.contains(v))
+                        inside.push_back(v);
+                for (const auto& v : b.vertices())
+                    if (a.contains(v))
+                        inside.push_back(v);
+                if (inside.size() >= 3 && !isCollinearSet(inside))
+                    area += ModifiedGrahamScan(inside).area();
+            }
+        }
+        bench::report("contains + ModifiedGrahamScan" + suffix, pairs * repeats, hulled.seconds(), "pairs");
+
+        bench::Timer sumInPlace;
+        for (size_t r = 0; r < repeats; ++r)
+            for (size_t i = 0; i < pairs; ++i)
+                minkowskiSum(polygons[2 * i], polygons[2 * i + 1], result);
+        bench::report("minkowskiSum, in place" + suffix, pairs * repeats, sumInPlace.seconds(), "pairs");
+
+        bench::Timer sum;
+        for (size_t r = 0; r < repeats; ++r)
+            for (size_t i = 0; i < pairs; ++i)
+                area += minkowskiSum(polygons[2 * i], polygons[2 * i + 1]).area();
+        bench::report("minkowskiSum" + suffix, pairs * repeats, sum.seconds(), "pairs");
+
+        if (area == 0)
+            std::cout << "(no overlaps)" << std::endl;
+    }
+}
+
+void BenchPolygonBoolean() {
+    for (size_t n : {1000, 10000, 100000}) {
+        if (n > bench::maxSize())
+            break;
+        // Two star-shaped polygons around the same centre: their boundaries cross O(n) times
+        Polygon a(bench::workload::simplePolygon(n, 1)), b(bench::workload::simplePolygon(n, 2));
+        const std::string suffix = ", n = " + std::to_string(n);
+
+        for (auto operation : {BooleanOperation::UNION, BooleanOperation::INTERSECTION,
+                               BooleanOperation::DIFFERENCE}) {
+            const char* name = operation == BooleanOperation::UNION ? "union" :
+                               operation == BooleanOperation::INTERSECTION ? "intersection" : "difference";
+            bench::Timer timer;
+            std::vector<Polygon> rings = booleanOperation(a, b, operation);
+            bench::report(std::string("booleanOperation, ") + name + suffix, 2 * n, timer.seconds(), "vertices");
+            if (rings.empty())
+                std::cout << "(empty result)" << std::endl;
+        }
+    }
+}
+
+void BenchRotatingCalipers() {
+    for (size_t n : {16, 256, 4096}) {
+        const size_t hulls = 64;
+        std::vector<ConvexPolygon> polygons;
+        for (size_t i = 0; i < hulls; ++i)
+            polygons.push_back(bench::workload::convexPolygon(n, i + 1));
+        const size_t repeats = std::max<size_t>(1, 4000000 / (n * hulls));
+        const std::string suffix = ", n = " + std::to_string(n);
+        double sum = 0;
+
+        bench::Timer diameter;
+        for (size_t r = 0; r < repeats; ++r)
+            for (const auto& polygon : polygons)
+                sum += polygon.diameter().length();
+        bench::report("diameter" + suffix, hulls * repeats, diameter.seconds(), "hulls");
+
+        // What callers did before: every vertex pair
+        const size_t pairHulls = std::max<size_t>(1, std::min(hulls, hulls * 64 / n));
+        const size_t pairRepeats = std::max<size_t>(1, repeats * 16 / n);
+        bench::Timer pairs;
+        for (size_t r = 0; r < pairRepeats; ++r) {
+            for (size_t h = 0; h < pairHulls; ++h) {
+                const auto& v = polygons[h].vertices();
+                double best = 0;
+                for (size_t i = 0; i < v.size(); ++i)
+                    for (size_t j = i + 1; j < v.size(); ++j)
+                        best = std::max(best, dot(v[i] - v[j], v[i] - v[j]));
+                sum += std::sqrt(best);
+            }
+        }
+        bench::report("diameter, all pairs" + suffix, pairHulls * pairRepeats, pairs.seconds(), "hulls");
+
+        bench::Timer width;
+        for (size_t r = 0; r < repeats; ++r)
+            for (const auto& polygon : polygons)
+                sum += polygon.width();
+        bench::report("width" + suffix, hulls * repeats, width.seconds(), "hulls");
+
+        bench::Timer area;
+        for (size_t r = 0; r < repeats; ++r)
+            for (const auto& polygon : polygons)
+                sum += polygon.minimumAreaRectangle().area();
+        bench::report("minimumAreaRectangle" + suffix, hulls * repeats, area.seconds(), "hulls");
+
+        bench::Timer perimeter;
+        for (size_t r = 0; r < repeats; ++r)
+            for (const auto& polygon : polygons)
+                sum += polygon.minimumPerimeterRectangle().perimeter();
+        bench::report("minimumPerimeterRectangle" + suffix, hulls * repeats, perimeter.seconds(), "hulls");
+
+        if (sum == 0)
+            std::cout << "(degenerate hulls)" << std::endl;
+    }
+}
+
+void BenchPointKDTree() {
+    for (int clustered = 0; clustered < 2; ++clustered) {
+        for (size_t n = 1000; n <= std::min<size_t>(bench::maxSize(), 1000000); n *= 10) {
+            std::vector<Point> points = clustered ? bench::workload::clusteredPoints(n, 16)
+                                                  : bench::workload::uniformPoints(n, 16);
+            std::vector<Point> queries = bench::workload::uniformPoints(100000, 17);
+            const std::string suffix = std::string(clustered ? ", clustered" : ", uniform") + ", n = " +
+                                       std::to_string(n);
+
+            PointKDTree tree(points);
+            bench::report("build" + suffix, n, tree.buildTime(), "points");
+            std::cout << "memory " << tree.memoryUsage() / 1024 << " KiB" << std::endl;
+
+            size_t found = 0;
+            bench::Timer nearest;
+            for (const auto& q : queries)
+                found += tree.nearest(q, 1).size();
+            bench::report("nearest, k = 1" + suffix, queries.size(), nearest.seconds(), "queries");
+
+            bench::Timer nearest10;
+            for (const auto& q : queries)
+                found += tree.nearest(q, 10).size();
+            bench::report("nearest, k = 10" + suffix, queries.size(), nearest10.seconds(), "queries");
+
+            bench::Timer parallel;
+            for (const auto& result : tree.nearest(queries, 10))
+                found += result.size();
+            bench::report("nearest, k = 10, batched" + suffix, queries.size(), parallel.seconds(), "queries");
+
+            // What callers did before: a scan over all points, on a sample of the queries
+            const size_t scans = std::max<size_t>(1, 10000000 / n);
+            bench::Timer scan;
+            for (size_t i = 0; i < scans; ++i) {
+                double best = std::numeric_limits<double>::infinity();
+                for (const auto& p : points)
+                    best = std::min(best, dot(p - queries[i], p - queries[i]));
+                found += best > 0;
+            }
+            bench::report("nearest, k = 1, scan" + suffix, scans, scan.seconds(), "queries");
+
+            // About 10 points per query on average for uniform points
+            const double radius = 1e6 * std::sqrt(10 / (3.14159 * n));
+            bench::Timer around;
+            for (const auto& q : queries)
+                found += tree.withinRadius(q, radius).size();
+            bench::report("withinRadius" + suffix, queries.size(), around.seconds(), "queries");
+
+            bench::Timer inside;
+            for (const auto& q : queries)
+                found += tree.inside(BoundingBox(q.x, q.y, q.x + 2 * radius, q.y + 2 * radius)).size();
+            bench::report("inside" + suffix, queries.size(), inside.seconds(), "queries");
+
+            bench::Timer pair;
+            std::pair<size_t, size_t> closest = tree.closestPair();
+            bench::report("closestPair" + suffix, n, pair.seconds(), "points");
+            if (closest.first == closest.second || found == 0)
+                std::cout << "(unexpected result)" << std::endl;
+        }
+    }
+}
+
+void BenchTriangulation() {
+    for (size_t n : {8, 16, 32, 64, 256, 1000, 10000, 100000}) {
+        if (n > bench::maxSize())
+            break;
+        Polygon polygon(bench::workload::simplePolygon(n, n));
+        const size_t repeats = std::max<size_t>(1, 2000000 / n);
+        const std::string suffix = ", n = " + std::to_string(n);
+        size_t triangles = 0;
+
+        bench::Timer monotone;
+        for (size_t r = 0; r < repeats; ++r)
+            triangles += triangulateMonotone(polygon).size();
+        bench::report("triangulateMonotone" + suffix, n * repeats, monotone.seconds(), "vertices");
+
+        // Quadratic in the worst case; only worth timing on smaller polygons
+        if (n <= 10000) {
+            const size_t earRepeats = std::max<size_t>(1, repeats * 64 / std::max<size_t>(n, 64));
+            bench::Timer ears;
+            for (size_t r = 0; r < earRepeats; ++r)
+                triangles += triangulateEarClipping(polygon).size();
+            bench::report("triangulateEarClipping" + suffix, n * earRepeats, ears.seconds(), "vertices");
+        }
+
+        if (triangles == 0)
+            std::cout << "(no triangles)" << std::endl;
+    }
+}
+
+void BenchBasicPolygon() {
+    for (size_t n : {100, 10000}) {
+        std::vector<Point> vertices = bench::workload::simplePolygon(n, n);
+        for (auto& p : vertices)
+            p = Point(std::round(p.x), std::round(p.y));
+        std::vector<Point> queries = bench::workload::uniformPoints(10000, 18);
+        for (auto& p : queries)
+            p = Point(std::round(p.x), std::round(p.y));
+        // About 10^8 edge tests for each type
+        const size_t repeats = std::max<size_t>(1, 100000000 / (n * queries.size()));
+        const std::string suffix = ", n = " + std::to_string(n);
+
+        Polygon polygon(vertices);
+        std::cout << "memory Polygon" << suffix << ": " << polygon.size() * sizeof(Point) << " bytes" << std::endl;
+        size_t inside = 0;
+        bench::Timer timer;
+        for (size_t r = 0; r < repeats; ++r)
+            for (const auto& p : queries)
+                inside += polygon.contains(p);
+        bench::report("contains, Polygon" + suffix, queries.size() * repeats, timer.seconds(), "queries");
+        if (inside == 0)
+            std::cout << "(no points inside)" << std::endl;
+
+        benchBasicPolygon<float>("BasicPolygon<float>" + suffix, vertices, queries, repeats);
+        benchBasicPolygon<int32_t>("BasicPolygon<int32_t>" + suffix, vertices, queries, repeats);
+        benchBasicPolygon<int64_t>("BasicPolygon<int64_t>" + suffix, vertices, queries, repeats);
+    }
+}
+
+void BenchPointInlining() {
+    const size_t n = 1000000;
+    std::vector<Point> points = bench::workload::uniformPoints(n + 2, 19);
+    Polygon polygon(bench::workload::simplePolygon(n, 19));
+    const size_t repeats = 20;
+    double sum = 0;
+
+    // Loops as user code writes them, over Point operators and predicates
+    bench::Timer shoelace;
+    for (size_t r = 0; r < repeats; ++r)
+        for (size_t i = 0; i + 1 < n; ++i)
+            sum += cross(points[i], points[i + 1]);
+    bench::report("cross loop", n * repeats, shoelace.seconds(), "points");
+
+    std::vector<Point> moved(points);
+    bench::Timer transform;
+    for (size_t r = 0; r < repeats; ++r)
+        for (auto& p : moved)
+            p = (p - points[0]) * 0.5 + points[1];
+    bench::report("translate and scale", n * repeats, transform.seconds(), "points");
+    sum += moved[n / 2].x;
+
+    bench::Timer nearest;
+    for (size_t r = 0; r < repeats; ++r) {
+        double best = std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < n; ++i)
+            best = std::min(best, dot(points[i] - points[n], points[i] - points[n]));
+        sum += best;
+    }
+    bench::report("squared distance scan", n * repeats, nearest.seconds(), "points");
+
+    size_t counts[3] = {0, 0, 0};
+    bench::Timer orientation;
+    for (size_t r = 0; r < repeats; ++r)
+        for (size_t i = 0; i < n; ++i)
+            counts[static_cast<int>(ccw(points[i], points[i + 1], points[i + 2]))]++;
+    bench::report("ccw loop", n * repeats, orientation.seconds(), "tests");
+
+    // The same through the library
+    bench::Timer area;
+    for (size_t r = 0; r < repeats; ++r)
+        sum += polygon.area() + polygon.perimeter();
+    bench::report("Polygon area + perimeter", n * repeats, area.seconds(), "vertices");
+
+    bench::Timer edges;
+    size_t crossings = 0;
+    for (size_t r = 0; r < repeats; ++r)
+        for (const auto& edge : polygon.edges())
+            crossings += edge.start().y < 0 && edge.end().y >= 0;
+    bench::report("Polygon edges() scan", n * repeats, edges.seconds(), "vertices");
+
+    bench::Timer contains;
+    size_t inside = 0;
+    for (size_t r = 0; r < repeats; ++r)
+        inside += polygon.contains(points[r]);
+    bench::report("Polygon contains", n * repeats, contains.seconds(), "vertices");
+
+    if (sum == 0 || counts[0] == 0 || crossings == 0 || inside > repeats)
+        std::cout << "(degenerate workload)" << std::endl;
+}
+
+void BenchSpatialHash() {
+    for (size_t n = 100000; n <= std::min<size_t>(bench::maxSize(), 10000000); n *= 10) {
+        // Positive coordinates on a 0.01 grid of about n nodes, so a third of the points are repeats
+        bench::workload::Random random(20);
+        const double side = std::sqrt(static_cast<double>(n));
+        std::vector<Point> points(n);
+        for (auto& p : points)
+            p = Point(std::floor(random.uniform(0, side)) / 100, std::floor(random.uniform(0, side)) / 100);
+        const std::string suffix = ", n = " + std::to_string(n);
+        size_t unique = 0;
+
+        // What callers did before: unordered_set with x + 31 * y as the hash, quadratic beyond 10^5 points
+        if (n <= 100000) {
+            bench::Timer old;
+            std::unordered_set<Point, TruncatedPointHash> set;
+            for (const auto& p : points)
+                set.insert(p);
+            bench::report("unordered_set, x + 31 * y" + suffix, n, old.seconds(), "points");
+            unique += set.size();
+        }
+
+        bench::Timer hashed;
+        std::unordered_set<Point> set;
+        for (const auto& p : points)
+            set.insert(p);
+        bench::report("unordered_set, std::hash" + suffix, n, hashed.seconds(), "points");
+
+        bench::Timer exact;
+        std::vector<Point> kept = deduplicate(points);
+        bench::report("deduplicate" + suffix, n, exact.seconds(), "points");
+
+        bench::Timer tolerance;
+        SpatialHash grid(0.05);
+        for (const auto& p : points)
+            grid.insertUnique(p, 0.05);
+        bench::report("insertUnique, eps = 0.05" + suffix, n, tolerance.seconds(), "points");
+        std::cout << "memory " << grid.memoryUsage() / 1024 << " KiB, " << grid.size() << " points kept"
+                  << std::endl;
+
+        bench::Timer queries;
+        for (size_t i = 0; i < n; ++i)
+            unique += grid.containsWithin(Point(points[i].x + 0.003, points[i].y - 0.003), 0.01);
+        bench::report("containsWithin, eps = 0.01" + suffix, n, queries.seconds(), "queries");
+
+        if (unique == 0 || kept.size() != set.size())
+            std::cout << "(unexpected result)" << std::endl;
+    }
+}
+
+void BenchSimplification() {
+    for (size_t n = 10000; n <= std::min<size_t>(bench::maxSize(), 1000000); n *= 10) {
+        Polygon polygon(bench::workload::simplePolygon(n, n));
+        std::vector<Point> queries = bench::workload::uniformPoints(1000, 21);
+        const std::string suffix = ", n = " + std::to_string(n);
+        size_t inside = 0;
+
+        bench::Timer dp;
+        Polygon coarse = simplify(polygon, 1e4);
+        bench::report("simplify, Douglas-Peucker" + suffix, n, dp.seconds(), "vertices");
+        bench::Timer vw;
+        Polygon areas = simplify(polygon, 1e8, Simplification::VISVALINGAM_WHYATT);
+        bench::report("simplify, Visvalingam-Whyatt" + suffix, n, vw.seconds(), "vertices");
+
+        bench::Timer build;
+        PolygonLevels levels(polygon, {1e2, 1e3, 1e4, 1e5});
+        bench::report("PolygonLevels, 4 levels" + suffix, n, build.seconds(), "vertices");
+
+        bench::Timer full;
+        for (const auto& q : queries)
+            inside += polygon.contains(q);
+        bench::report("contains, full" + suffix, queries.size(), full.seconds(), "queries");
+        for (size_t i = 0; i < levels.size(); ++i) {
+            bench::Timer level;
+            for (const auto& q : queries)
+                inside += levels[i].contains(q);
+            bench::report("contains, tolerance " + std::to_string(static_cast<int>(levels.tolerance(i))) + ", " +
+                          std::to_string(levels[i].size()) + " vertices" + suffix,
+                          queries.size(), level.seconds(), "queries");
+        }
+        if (inside == 0 || coarse.size() == 0 || areas.size() == 0)
+            std::cout << "(no points inside)" << std::endl;
+    }
+}
+
+void BenchPolygonSimplicity() {
+    for (size_t n = 1000; n <= std::min<size_t>(bench::maxSize(), 1000000); n *= 10) {
+        std::vector<Point> vertices = bench::workload::simplePolygon(n, n);
+        const std::string suffix = ", n = " + std::to_string(n);
+        size_t simple = 0;
+
+        bench::Timer sweep;
+        simple += isSimple(vertices);
+        bench::report("isSimple, Shamos-Hoey" + suffix, n, sweep.seconds(), "vertices");
+
+        Polygon polygon(vertices);
+        bench::Timer all;
+        std::vector<Segment> edges(polygon.edges().begin(), polygon.edges().end());
+        simple += calculateIntersections(edges).size() == n;
+        bench::report("all intersections, Bentley-Ottmann" + suffix, n, all.seconds(), "vertices");
+
+        if (n <= 10000) {
+            bench::Timer pairwise;
+            bool crossing = false;
+            for (size_t i = 0; i < n && !crossing; ++i)
+                for (size_t j = i + 2; j < n && !crossing; ++j)
+                    crossing = (i != 0 || j != n - 1) && intersects(edges[i], edges[j]);
+            simple += !crossing;
+            bench::report("pairwise intersects()" + suffix, n, pairwise.seconds(), "vertices");
+        }
+
+        bench::Timer basic;
+        Polygon checked(vertices);
+        bench::report("Polygon(vertices)" + suffix, n, basic.seconds(), "vertices");
+        bench::Timer validated;
+        Polygon valid(vertices, Validation::SIMPLE);
+        bench::report("Polygon(vertices, Validation::SIMPLE)" + suffix, n, validated.seconds(), "vertices");
+        if (simple != (n <= 10000 ? 3u : 2u) || checked.size() != valid.size())
+            std::cout << "(polygon is not simple)" << std::endl;
+    }
+}
+
+void BenchContainmentGrid() {
+    const size_t queries = 1000000;
+    std::vector<Point> points = bench::workload::uniformPoints(queries, 24);
+    for (size_t n = 10000; n <= std::min<size_t>(bench::maxSize(), 1000000); n *= 10) {
+        Polygon polygon(bench::workload::simplePolygon(n, n));
+        const std::string suffix = ", n = " + std::to_string(n);
+        size_t inside = 0;
+
+        polygon.buildIndex();
+        bench::Timer indexed;
+        for (const auto& p : points)
+            inside += polygon.contains(p);
+        bench::report("indexed contains" + suffix, queries, indexed.seconds(), "queries");
+        polygon.dropIndex();
+
+        for (size_t bytesPerVertex : {16, 64, 256}) {
+            polygon.buildGrid(bytesPerVertex * n);
+            const ContainmentGrid& grid = *polygon.grid();
+            std::cout << "grid of " << bytesPerVertex << " bytes per vertex" << suffix << ": " << grid.columns()
+                      << " x " << grid.rows() << " cells, " << grid.boundaryCells() << " on the boundary, "
+                      << grid.memoryUsage() / 1024 << " KiB, built in " << grid.buildTime() * 1e3 << " ms"
+                      << std::endl;
+            bench::Timer gridded;
+            for (const auto& p : points)
+                inside += polygon.contains(p);
+            bench::report("grid contains, " + std::to_string(bytesPerVertex) + " bytes per vertex" + suffix,
+                          queries, gridded.seconds(), "queries");
+        }
+        polygon.dropGrid();
+
+        const size_t sample = std::max<size_t>(100, 10000000 / n);
+        bench::Timer scan;
+        for (size_t i = 0; i < sample; ++i)
+            inside += polygon.contains(points[i]);
+        bench::report("linear contains" + suffix, sample, scan.seconds(), "queries");
+        if (inside == 0)
+            std::cout << "(no points inside)" << std::endl;
+    }
+}
+
+void BenchPolygonProperties() {
+    for (size_t n = 1000; n <= std::min<size_t>(bench::maxSize(), 1000000); n *= 10) {
+        std::vector<Point> vertices = bench::workload::simplePolygon(n, n);
+        const std::string suffix = ", n = " + std::to_string(n);
+        const size_t calls = 1000000, sample = std::max<size_t>(10, 100000000 / n / 10);
+        PolygonView view(vertices.data(), n);
+        double total = 0;
+
+        bench::Timer recomputed;
+        for (size_t i = 0; i < sample; ++i)
+            total += view.area() + view.perimeter();
+        bench::report("area + perimeter, recomputed" + suffix, sample, recomputed.seconds(), "calls");
+
+        Polygon polygon(vertices);
+        bench::Timer first;
+        total += polygon.area();
+        bench::report("first area(), all properties" + suffix, 1, first.seconds(), "calls");
+        bench::Timer cached;
+        for (size_t i = 0; i < calls; ++i)
+            total += polygon.area() + polygon.perimeter();
+        bench::report("area + perimeter, cached" + suffix, calls, cached.seconds(), "calls");
+
+        // Growing a polygon and scoring it after every vertex
+        Polygon grown(std::vector<Point>(vertices.begin(), vertices.begin() + 3));
+        bench::Timer growing;
+        for (size_t i = 3; i < n; ++i) {
+            grown.add(vertices[i]);
+            total += grown.area();
+        }
+        bench::report("add() + area()" + suffix, n - 3, growing.seconds(), "vertices");
+
+        // Queries around the polygon, a quarter of them inside its bounding box
+        std::vector<Point> points = bench::workload::uniformPoints(sample, 25, 2e6);
+        size_t inside = 0;
+        bench::Timer rejecting;
+        for (const auto& p : points)
+            inside += polygon.contains(p);
+        bench::report("contains, bounding box first" + suffix, sample, rejecting.seconds(), "queries");
+        bench::Timer scanning;
+        for (const auto& p : points)
+            inside += view.contains(p);
+        bench::report("contains, edges only" + suffix, sample, scanning.seconds(), "queries");
+        if (total == 0 || inside == 1)
+            std::cout << "(degenerate)" << std::endl;
+    }
+}
+
+void BenchSuiteAreaPerimeter() {
+    for (size_t n : suiteSizes()) {
+        Polygon polygon(bench::workload::simplePolygon(n, n));
+        size_t repeats = std::max<size_t>(1, 10000000 / n);
+
+        bench::Timer area;
+        double total = 0;
+        for (size_t r = 0; r < repeats; ++r)
+            total += polygon.area();
+        bench::report("area, n = " + std::to_string(n), n * repeats, area.seconds(), "vertices");
+
+        bench::Timer perimeter;
+        for (size_t r = 0; r < repeats; ++r)
+            total += polygon.perimeter();
+        bench::report("perimeter, n = " + std::to_string(n), n * repeats, perimeter.seconds(), "vertices");
+
+        if (total == 0)
+            std::cout << "(degenerate polygon)" << std::endl;
+    }
+}
+
+void BenchSuitePolygonContains() {
+    for (size_t n : suiteSizes()) {
+        Polygon polygon(bench::workload::simplePolygon(n, n));
+        // About 2 * 10^7 edge tests per size
+        size_t queries = std::max<size_t>(10, 20000000 / n);
+        std::vector<Point> uniform = bench::workload::uniformPoints(queries, 1, 1.1e6);
+        std::vector<Point> clustered = bench::workload::clusteredPoints(queries, 2, 32, 1.1e6);
+
+        for (const auto& workload : {std::make_pair("uniform", &uniform), std::make_pair("clustered", &clustered)}) {
+            bench::Timer timer;
+            size_t inside = 0;
+            for (const auto& p : *workload.second)
+                inside += polygon.contains(p);
+            bench::report(std::string("Polygon::contains, ") + workload.first + ", n = " + std::to_string(n),
+                          queries, timer.seconds(), "queries");
+        }
+    }
+}
+
+void BenchSuiteConvexContains() {
+    const size_t queries = 1000000;
+    std::vector<Point> uniform = bench::workload::uniformPoints(queries, 3, 1.1e6);
+    std::vector<Point> clustered = bench::workload::clusteredPoints(queries, 4, 32, 1.1e6);
+    for (size_t n : suiteSizes()) {
+        ConvexPolygon convex = bench::workload::convexPolygon(n, n);
+
+        for (const auto& workload : {std::make_pair("uniform", &uniform), std::make_pair("clustered", &clustered)}) {
+            bench::Timer timer;
+            size_t inside = 0;
+            for (const auto& p : *workload.second)
+                inside += convex.contains(p);
+            bench::report(std::string("ConvexPolygon::contains, ") + workload.first + ", n = " + std::to_string(n),
+                          queries, timer.seconds(), "queries");
+        }
+    }
+}
+
+void BenchSuiteConvexHull() {
+    for (size_t n : suiteSizes()) {
+        std::vector<Point> uniform = bench::workload::uniformPoints(n, n);
+        std::vector<Point> clustered = bench::workload::clusteredPoints(n, n);
+        size_t repeats = std::max<size_t>(1, 1000000 / n);
+
+        for (const auto& workload : {std::make_pair("uniform", &uniform), std::make_pair("clustered", &clustered)}) {
+            bench::Timer timer;
+            size_t size = 0;
+            for (size_t r = 0; r < repeats; ++r)
+                size += ModifiedGrahamScan(*workload.second).size();
+            bench::report(std::string("ModifiedGrahamScan, ") + workload.first + ", n = " + std::to_string(n),
+                          n * repeats, timer.seconds());
+        }
+    }
+}
+
+void BenchSuiteSegments() {
+    for (size_t n : suiteSizes()) {
+        // Segments spanning up to half the extent, so that a fair share of consecutive pairs intersect
+        std::vector<Segment> segments = bench::workload::segments(n + 1, n, 1e6);
+        size_t repeats = std::max<size_t>(1, 1000000 / n);
+
+        std::vector<size_t> hits;
+        bench::Timer test;
+        for (size_t r = 0; r < repeats; ++r) {
+            hits.clear();
+            for (size_t i = 0; i < n; ++i)
+                if (intersects(segments[i], segments[i + 1]))
+                    hits.push_back(i);
+        }
+        bench::report("intersects, n = " + std::to_string(n), n * repeats, test.seconds(), "pairs");
+
+        bench::Timer compute;
+        double sum = 0;
+        for (size_t r = 0; r < repeats; ++r)
+            for (size_t i : hits)
+                sum += calculateIntersection(segments[i], segments[i + 1]).x;
+        bench::report("calculateIntersection, n = " + std::to_string(n), hits.size() * repeats,
+                      compute.seconds(), "pairs");
+    }
+}
@@ -1,6 +1,22 @@
 #pragma once
 
 #include "../src/headers/Point.h"
+#include "../src/headers/Predicates.h"
 #include "../src/headers/Segment.h"
+#include "../src/headers/PointLocationIndex.h"
 #include "../src/headers/Polygon.h"
-#include "../src/headers/ConvexPolygon.h"
\ No newline at end of file
+#include "../src/headers/ConvexPolygon.h"
+#include "../src/headers/DynamicConvexHull.h"
+#include "../src/headers/SegmentIntersections.h"
+#include "../src/headers/BoundingBox.h"
+#include "../src/headers/PolygonRTree.h"
+#include "../src/headers/PolygonStore.h"
+#include "../src/headers/PolygonIO.h"
+#include "../src/headers/BooleanOperations.h"
+#include "../src/headers/PointKDTree.h"
+#include "../src/headers/Triangulation.h"
+#include "../src/headers/BasicPolygon.h"
+#include "../src/headers/SpatialHash.h"
+#include "../src/headers/Simplification.h"
+#include "../src/headers/Metrics.h"
+#include "../src/headers/ContainmentGrid.h"
\ No newline at end of file
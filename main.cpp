@@ -2,6 +2,14 @@
 #include "TestRunner.h"
 
 #include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
 
 using namespace lgm;
 
@@ -12,6 +20,30 @@ void TestConvexContains();
 void TestConvexOnBoundary();
 void TestConvexHull();
 void TestSegmentIntersection();
+void TestPolygonLocateBatch();
+void TestPolygonIndex();
+void TestConvexLocateBatch();
+void TestParallelConvexHull();
+void TestDynamicConvexHull();
+void TestSegmentIntersections();
+void TestOrientation();
+void TestPolygonEdges();
+void TestPolygonRTree();
+void TestPolygonStore();
+void TestPolygonIO();
+void TestConvexOperations();
+void TestPolygonBoolean();
+void TestRotatingCalipers();
+void TestPointKDTree();
+void TestTriangulation();
+void TestBasicPolygon();
+void TestSpatialHash();
+void TestSimplification();
+void TestMetrics();
+void TestPolygonSimplicity();
+void TestContainmentGrid();
+void TestPolygonProperties();
+void TestSegmentIntersectionsNearDegenerate();
 
 int main() {
     {
@@ -23,6 +55,30 @@ int main() {
         RUN_TEST(tr, TestConvexOnBoundary);
         RUN_TEST(tr, TestConvexHull);
         RUN_TEST(tr, TestSegmentIntersection);
+        RUN_TEST(tr, TestPolygonLocateBatch);
+        RUN_TEST(tr, TestPolygonIndex);
+        RUN_TEST(tr, TestConvexLocateBatch);
+        RUN_TEST(tr, TestParallelConvexHull);
+        RUN_TEST(tr, TestDynamicConvexHull);
+        RUN_TEST(tr, TestSegmentIntersections);
+        RUN_TEST(tr, TestOrientation);
+        RUN_TEST(tr, TestPolygonEdges);
+        RUN_TEST(tr, TestPolygonRTree);
+        RUN_TEST(tr, TestPolygonStore);
+        RUN_TEST(tr, TestPolygonIO);
+        RUN_TEST(tr, TestConvexOperations);
+        RUN_TEST(tr, TestPolygonBoolean);
+        RUN_TEST(tr, TestRotatingCalipers);
+        RUN_TEST(tr, TestPointKDTree);
+        RUN_TEST(tr, TestTriangulation);
+        RUN_TEST(tr, TestBasicPolygon);
+        RUN_TEST(tr, TestSpatialHash);
+        RUN_TEST(tr, TestSimplification);
+        RUN_TEST(tr, TestMetrics);
+        RUN_TEST(tr, TestPolygonSimplicity);
+        RUN_TEST(tr, TestContainmentGrid);
+        RUN_TEST(tr, TestPolygonProperties);
+        RUN_TEST(tr, TestSegmentIntersectionsNearDegenerate);
     }
     return 0;
 }
@@ -180,4 +236,1824 @@ void TestConvexHull() {
     ConvexPolygon result = ModifiedGrahamScan(vertexes);
     ASSERT_EQ(result.size(), 8);
     ASSERT_EQ(isConvex(result.vertices()), true);
+}
+
+void TestPolygonLocateBatch() {
+    std::vector<Point> vertices(5);
+    vertices[0] = Point(-3, -1);
+    vertices[1] = Point(3, -1);
+    vertices[2] = Point(3, 5);
+    vertices[3] = Point(0, 2);
+    vertices[4] = Point(-3, 4);
+    Polygon polygon(vertices);
+
+    // Half-unit grid hits vertices, edges and points next to them; 195 points leave a SIMD tail
+    std::vector<double> xs, ys;
+    for (double x = -4; x <= 3; x += 0.5) {
+        for (double y = -2; y <= 4; y += 0.5) {
+            xs.push_back(x);
+            ys.push_back(y);
+        }
+    }
+    std::vector<Location> result(xs.size());
+    polygon.locate(xs.data(), ys.data(), xs.size(), result.data());
+    for (size_t i = 0; i < xs.size(); ++i) {
+        Point p(xs[i], ys[i]);
+        Location expected = polygon.isBoundary(p) ? Location::BOUNDARY :
+                            (polygon.contains(p) ? Location::INSIDE : Location::OUTSIDE);
+        ASSERT_EQ(static_cast<int>(result[i]), static_cast<int>(expected));
+    }
+
+    ConvexPolygon convex(std::vector<Point>{Point(-2, -3), Point(1, -4), Point(3, -2), Point(2, 1), Point(-2, 1)});
+    double x[] = {2, 3, 0, 2};
+    double y[] = {-3, 0, 0, -1};
+    Location convexResult[4];
+    convex.locate(x, y, 4, convexResult);
+    ASSERT_EQ(static_cast<int>(convexResult[0]), static_cast<int>(Location::BOUNDARY));
+    ASSERT_EQ(static_cast<int>(convexResult[1]), static_cast<int>(Location::OUTSIDE));
+    ASSERT_EQ(static_cast<int>(convexResult[2]), static_cast<int>(Location::INSIDE));
+    ASSERT_EQ(static_cast<int>(convexResult[3]), static_cast<int>(Location::INSIDE));
+}
+
+void TestPolygonIndex() {
+    // Comb-shaped polygon: many edges cross every horizontal line, including horizontal edges and shared y values
+    std::vector<Point> vertices;
+    vertices.emplace_back(0, 0);
+    vertices.emplace_back(20, 0);
+    for (int tooth = 4; tooth >= 0; --tooth) {
+        vertices.emplace_back(4 * tooth + 3, 10 + tooth);
+        vertices.emplace_back(4 * tooth + 2, 2);
+        vertices.emplace_back(4 * tooth + 1, 9);
+    }
+    Polygon polygon(vertices);
+    Polygon indexed = polygon;
+    indexed.buildIndex();
+    ASSERT_EQ(indexed.index() != nullptr, true);
+    ASSERT_EQ(indexed.index()->memoryUsage() > 0, true);
+
+    for (int x = -2; x <= 22; ++x) {
+        for (int y = -2; y <= 16; ++y) {
+            Point p(x, y);
+            ASSERT_EQ(indexed.contains(p), polygon.contains(p));
+            ASSERT_EQ(indexed.isBoundary(p), polygon.isBoundary(p));
+        }
+    }
+
+    indexed.add(Point(-1, 5));
+    ASSERT_EQ(indexed.index() == nullptr, true);
+}
+
+void TestConvexLocateBatch() {
+    std::vector<Point> ccwVertices = {Point(3, -9), Point(8, -6), Point(10, 0), Point(8, 6), Point(3, 9),
+                                      Point(-3, 9), Point(-8, 6), Point(-10, 0), Point(-8, -6), Point(-3, -9)};
+    // Start from an arbitrary vertex and traverse in both directions
+    std::rotate(ccwVertices.begin(), ccwVertices.begin() + 4, ccwVertices.end());
+    std::vector<Point> cwVertices(ccwVertices.rbegin(), ccwVertices.rend());
+
+    // Lattice polygon with one edge per primitive direction, large enough for the sorted sweep.
+    // Scaled by 3 so the pivot (centroid of three vertices) has integer coordinates as well
+    std::vector<Point> directions;
+    for (int dx = -5; dx <= 5; ++dx) {
+        for (int dy = -5; dy <= 5; ++dy) {
+            int a = std::abs(dx), b = std::abs(dy);
+            while (b != 0) {
+                int t = a % b;
+                a = b;
+                b = t;
+            }
+            if (a == 1)
+                directions.emplace_back(3 * dx, 3 * dy);
+        }
+    }
+    std::sort(directions.begin(), directions.end(), [](const Point& lhs, const Point& rhs) {
+        return std::atan2(lhs.y, lhs.x) < std::atan2(rhs.y, rhs.x);
+    });
+    std::vector<Point> latticeVertices;
+    Point current(0, 0);
+    for (const auto& d : directions) {
+        latticeVertices.push_back(current);
+        current = current + d;
+    }
+
+    for (const auto& vertices : {ccwVertices, cwVertices, latticeVertices}) {
+        ConvexPolygon convex(vertices);
+        Polygon polygon(vertices);
+
+        std::vector<double> xs, ys;
+        for (int x = -170; x <= 170; x += 2) {
+            for (int y = -340; y <= 11; y += 2) {
+                xs.push_back(x);
+                ys.push_back(y);
+            }
+        }
+        std::vector<Location> result(xs.size());
+        convex.locate(xs.data(), ys.data(), xs.size(), result.data());
+        for (size_t i = 0; i < xs.size(); ++i) {
+            Point p(xs[i], ys[i]);
+            ASSERT_EQ(convex.contains(p), polygon.contains(p));
+            ASSERT_EQ(convex.isBoundary(p), polygon.isBoundary(p));
+            Location expected = polygon.isBoundary(p) ? Location::BOUNDARY :
+                                (polygon.contains(p) ? Location::INSIDE : Location::OUTSIDE);
+            ASSERT_EQ(static_cast<int>(result[i]), static_cast<int>(expected));
+        }
+    }
+}
+
+void TestParallelConvexHull() {
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> coord(-1000, 1000);
+    std::vector<Point> points(20000);
+    for (auto& p : points)
+        p = Point(coord(rng), coord(rng));
+
+    ConvexPolygon expected = ModifiedGrahamScan(points);
+    for (size_t threads : {1, 2, 3, 8}) {
+        ConvexPolygon result = ParallelConvexHull(points, threads);
+        ASSERT_EQ(result.vertices(), expected.vertices());
+    }
+
+    std::vector<Point> small(points.begin(), points.begin() + 10);
+    ASSERT_EQ(ParallelConvexHull(small, 4).vertices(), ModifiedGrahamScan(small).vertices());
+}
+
+void TestDynamicConvexHull() {
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> coord(-50, 50);
+    std::vector<Point> points;
+    DynamicConvexHull hull;
+    for (int i = 0; i < 400; ++i) {
+        points.emplace_back(coord(rng), coord(rng));
+        hull.add(points.back());
+        if (i >= 10 && i % 30 == 0) {
+            ConvexPolygon expected = ModifiedGrahamScan(points);
+            ASSERT_EQ(hull.vertices(), expected.vertices());
+            Polygon polygon(expected.vertices());
+            for (int x = -52; x <= 52; x += 3) {
+                for (int y = -52; y <= 52; y += 3) {
+                    Point p(x, y);
+                    ASSERT_EQ(hull.contains(p), polygon.contains(p));
+                    ASSERT_EQ(hull.isBoundary(p), polygon.isBoundary(p));
+                }
+            }
+        }
+    }
+    ASSERT_EQ(hull.add(Point(0, 0)), false);
+    ASSERT_EQ(hull.add(Point(100, 100)), true);
+    ASSERT_EQ(hull.polygon().vertices(), ModifiedGrahamScan(hull.vertices()).vertices());
+}
+void TestSegmentIntersections() {
+    auto proper = [](const Segment& a, const Segment& b) {
+        Direction o1 = ccw(a, b.start()), o2 = ccw(a, b.end());
+        Direction o3 = ccw(b, a.start()), o4 = ccw(b, a.end());
+        return o1 != Direction::COLLINEAR && o2 != Direction::COLLINEAR && o1 != o2 &&
+               o3 != Direction::COLLINEAR && o4 != Direction::COLLINEAR && o3 != o4;
+    };
+
+    for (unsigned seed = 1; seed <= 20; ++seed) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> coord(-12, 12);
+        std::uniform_int_distribution<int> kind(0, 9);
+        std::vector<Segment> segments;
+        for (int i = 0; i < 120; ++i) {
+            Point a(coord(rng), coord(rng));
+            Point b(coord(rng), coord(rng));
+            switch (kind(rng)) {
+                case 0: b = a; break;                           // degenerate
+                case 1: b.x = a.x; break;                       // vertical
+                case 2: b.y = a.y; break;                       // horizontal
+                case 3: if (!segments.empty()) a = segments[rng() % segments.size()].end(); break;
+                default: break;
+            }
+            segments.emplace_back(a, b);
+        }
+
+        std::set<std::pair<size_t, size_t>> expected;
+        for (size_t i = 0; i < segments.size(); ++i)
+            for (size_t j = i + 1; j < segments.size(); ++j)
+                if (intersects(segments[i], segments[j]))
+                    expected.emplace(i, j);
+
+        std::set<std::pair<size_t, size_t>> found;
+        for (const auto& r : calculateIntersections(segments)) {
+            ASSERT_EQ(r.first < r.second, true);
+            ASSERT_EQ(found.emplace(r.first, r.second).second, true);
+            const Segment& a = segments[r.first];
+            const Segment& b = segments[r.second];
+            if (proper(a, b)) {
+                ASSERT_EQ(r.intersection.start(), calculateIntersection(a, b));
+                ASSERT_EQ(r.intersection.end(), calculateIntersection(a, b));
+            } else {
+                for (const Point& p : {r.intersection.start(), r.intersection.end()}) {
+                    ASSERT_EQ(intersects(a, Segment(p, p)), true);
+                    ASSERT_EQ(intersects(b, Segment(p, p)), true);
+                }
+            }
+        }
+        ASSERT_EQ(found.size(), expected.size());
+        ASSERT_EQ(found == expected, true);
+    }
+
+    std::vector<Segment> star;
+    for (int i = 0; i < 8; ++i)
+        star.emplace_back(Point(-i, -10), Point(i, 10));
+    star.emplace_back(Point(-5, 0), Point(5, 0));
+    auto result = calculateIntersections(star);
+    ASSERT_EQ(result.size(), 36);
+}
+
+void TestOrientation() {
+    // Determinants below 1 and large enough to overflow an int
+    ASSERT_EQ(ccw(Point(0, 0), Point(1, 0), Point(0.5, 0.1)), Direction::CCW);
+    ASSERT_EQ(ccw(Point(0, 0), Point(1, 0), Point(0.5, -0.1)), Direction::CW);
+    ASSERT_EQ(ccw(Point(0, 0), Point(1e6, 0), Point(0, 1e6)), Direction::CCW);
+    ASSERT_EQ(ccw(Point(0, 0), Point(1e9, 1e9), Point(3e9, 3e9)), Direction::COLLINEAR);
+    ASSERT_EQ(ccw(Point(0, 0), Point(1e9, 1e9), Point(3e9, 3e9 + 1e-6)), Direction::CCW);
+
+    // Points next to the line y = x: the sign of (b - a) x (c - a) is the sign of c.y - c.x,
+    // which the plain floating-point determinant gets wrong for many of them
+    resetPredicateCounters();
+    Point a(12, 12), b(24, 24);
+    double cx = 0.5;
+    for (int i = 0; i < 64; ++i, cx = std::nextafter(cx, 1.0)) {
+        double cy = 0.5;
+        for (int j = 0; j < 64; ++j, cy = std::nextafter(cy, 1.0)) {
+            Direction expected = j > i ? Direction::CCW : (j < i ? Direction::CW : Direction::COLLINEAR);
+            ASSERT_EQ(ccw(a, b, Point(cx, cy)), expected);
+            ASSERT_EQ(ccw(b, a, Point(cx, cy)), opposite(expected));
+        }
+    }
+    ASSERT_EQ(predicateCounters().adaptive > 0, true);
+    ASSERT_EQ(predicateCounters().exact <= predicateCounters().adaptive, true);
+
+    // Batch location has to agree with contains() next to the edges as well
+    std::vector<Point> vertices = {Point(0.1, 0.3), Point(1e5 + 0.7, 0.2), Point(3e5, 2e5 + 0.1), Point(0.3, 1e5)};
+    Polygon polygon(vertices);
+    std::vector<double> xs, ys;
+    for (size_t e = 0; e < vertices.size(); ++e) {
+        const Point& p = vertices[e];
+        const Point& q = vertices[(e + 1) % vertices.size()];
+        for (int k = 1; k < 50; ++k) {
+            Point m = p + (q - p) * (k / 50.0);
+            for (int step = -3; step <= 3; ++step) {
+                xs.push_back(m.x + step * std::abs(m.x) * 1e-16);
+                ys.push_back(m.y);
+            }
+        }
+    }
+    std::vector<Location> result(xs.size());
+    polygon.locate(xs.data(), ys.data(), xs.size(), result.data());
+    for (size_t i = 0; i < xs.size(); ++i) {
+        Point p(xs[i], ys[i]);
+        Location expected = polygon.isBoundary(p) ? Location::BOUNDARY
+                          : (polygon.contains(p) ? Location::INSIDE : Location::OUTSIDE);
+        ASSERT_EQ(static_cast<int>(result[i]), static_cast<int>(expected));
+    }
+}
+
+void TestPolygonEdges() {
+    std::vector<Point> vertices = {Point(0, 0), Point(4, 0), Point(4, 3), Point(0, 3)};
+    Polygon polygon(vertices);
+
+    ASSERT_EQ(polygon.edges().size(), 4);
+    ASSERT_EQ(polygon.edges()[1].start(), Point(4, 0));
+    ASSERT_EQ(polygon.edges()[1].end(), Point(4, 3));
+    ASSERT_EQ(polygon.edges().back().end(), Point(0, 0));
+    size_t i = 0;
+    for (const auto& edge : polygon.edges()) {
+        ASSERT_EQ(edge.start(), vertices[i]);
+        ASSERT_EQ(edge.end(), vertices[(i + 1) % vertices.size()]);
+        i++;
+    }
+    ASSERT_EQ(i, 4);
+    ASSERT_EQ(polygon.area(), 12.0);
+    ASSERT_EQ(polygon.perimeter(), 14.0);
+
+    static_assert(std::is_same<std::iterator_traits<EdgeView::iterator>::iterator_category,
+                               std::input_iterator_tag>::value, "edges are yielded by value");
+    std::vector<Segment> segments(polygon.edges().begin(), polygon.edges().end());
+    ASSERT_EQ(Polygon(segments).vertices(), vertices);
+
+    // Copies and growing polygons keep valid edges
+    Polygon copy = polygon;
+    polygon = Polygon(std::vector<Point>{Point(10, 10), Point(11, 10), Point(10, 11)});
+    for (int k = 1; k <= 100; ++k)
+        polygon.add(Point(10 - 0.01 * k, 11 + 0.001 * k * k));
+    ASSERT_EQ(copy.contains(Point(2, 2)), true);
+    ASSERT_EQ(copy.isBoundary(Point(4, 2)), true);
+    ASSERT_EQ(copy.area(), 12.0);
+    ASSERT_EQ(polygon.edges().back().start(), polygon.vertices().back());
+    ASSERT_EQ(polygon.edges().back().end(), Point(10, 10));
+}
+
+void TestPolygonRTree() {
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<double> coord(-1000, 1000);
+    std::uniform_real_distribution<double> radius(5, 80);
+    std::uniform_int_distribution<int> sides(3, 9);
+
+    std::vector<Polygon> polygons;
+    for (int i = 0; i < 700; ++i) {
+        Point center(coord(rng), coord(rng));
+        double r = radius(rng);
+        int n = sides(rng);
+        std::vector<Point> vertices;
+        for (int k = 0; k < n; ++k) {
+            double angle = 2 * std::acos(-1.0) * k / n;
+            vertices.push_back(center + Point(r * std::cos(angle), r * std::sin(angle) * (k % 2 ? 0.5 : 1)));
+        }
+        polygons.emplace_back(vertices);
+    }
+    std::vector<ConvexPolygon> convex;
+    for (size_t i = 0; i < 50; ++i)
+        convex.push_back(ModifiedGrahamScan(polygons[i].vertices()));
+
+    PolygonRTree tree(polygons);
+    ASSERT_EQ(tree.size(), polygons.size());
+
+    std::vector<Point> queries;
+    for (int i = 0; i < 2000; ++i)
+        queries.emplace_back(coord(rng), coord(rng));
+    queries.push_back(polygons[17].vertices()[1]);
+
+    auto polygonDistance = [](const Polygon& polygon, const Point& p) {
+        if (polygon.contains(p))
+            return 0.0;
+        double result = 1e18;
+        for (const auto& edge : polygon.edges()) {
+            Point d = edge.end() - edge.start();
+            double t = std::min(std::max(dot(p - edge.start(), d) / dot(d, d), 0.0), 1.0);
+            result = std::min(result, distance(p, edge.start() + t * d));
+        }
+        return result;
+    };
+
+    for (const auto& p : queries) {
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < polygons.size(); ++i)
+            if (polygons[i].contains(p))
+                expected.push_back(i);
+        ASSERT_EQ(tree.containing(p), expected);
+
+        BoundingBox box(p.x - 30, p.y - 10, p.x + 30, p.y + 10);
+        expected.clear();
+        for (size_t i = 0; i < polygons.size(); ++i)
+            if (BoundingBox(polygons[i].vertices()).intersects(box))
+                expected.push_back(i);
+        ASSERT_EQ(tree.overlapping(box), expected);
+
+        std::vector<std::pair<double, size_t>> byDistance;
+        for (size_t i = 0; i < polygons.size(); ++i)
+            byDistance.emplace_back(polygonDistance(polygons[i], p), i);
+        std::sort(byDistance.begin(), byDistance.end());
+        expected.clear();
+        for (size_t i = 0; i < 5; ++i)
+            expected.push_back(byDistance[i].second);
+        ASSERT_EQ(tree.nearest(p, 5), expected);
+    }
+    ASSERT_EQ(tree.nearest(queries[0], 1000).size(), polygons.size());
+
+    // Convex polygons use their own contains(), and queries may run concurrently
+    PolygonRTree convexTree(convex);
+    std::vector<std::vector<size_t>> results(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < results.size(); ++t) {
+        threads.emplace_back([&, t]() {
+            for (const auto& p : queries) {
+                auto found = convexTree.containing(p);
+                results[t].insert(results[t].end(), found.begin(), found.end());
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    std::vector<size_t> expected;
+    for (const auto& p : queries)
+        for (size_t i = 0; i < convex.size(); ++i)
+            if (convex[i].contains(p))
+                expected.push_back(i);
+    for (const auto& result : results)
+        ASSERT_EQ(result, expected);
+
+    ASSERT_EQ(PolygonRTree(std::vector<Polygon>()).containing(Point(0, 0)).size(), 0);
+}
+
+void TestPolygonStore() {
+    std::mt19937_64 rng(41);
+    std::uniform_real_distribution<double> unit(0, 1);
+    const double pi = std::acos(-1.0);
+    std::vector<Polygon> polygons;
+    for (size_t i = 0; i < 200; ++i) {
+        // Star-shaped polygons with 3..40 vertices around random centers
+        size_t n = 3 + i % 38;
+        Point center(unit(rng) * 100, unit(rng) * 100);
+        std::vector<Point> vertices;
+        for (size_t k = 0; k < n; ++k) {
+            double angle = 2 * pi * (k + unit(rng) * 0.5) / n;
+            double r = 5 + unit(rng) * 10;
+            vertices.emplace_back(center.x + r * std::cos(angle), center.y + r * std::sin(angle));
+        }
+        polygons.emplace_back(vertices);
+    }
+
+    const std::string path = "polygon_store_test.bin";
+    PolygonStore::write(path, polygons);
+    {
+        PolygonStore store(path);
+        ASSERT_EQ(store.size(), polygons.size());
+        ASSERT_EQ(store.verify(), true);
+        size_t vertices = 0;
+        for (size_t i = 0; i < store.size(); ++i) {
+            PolygonView view = store[i];
+            const Polygon& polygon = polygons[i];
+            vertices += view.size();
+            ASSERT_EQ(view.size(), polygon.size());
+            ASSERT_EQ(std::equal(view.begin(), view.end(), polygon.vertices().begin()), true);
+            ASSERT_EQ(view.area(), polygon.area());
+            ASSERT_EQ(view.perimeter(), polygon.perimeter());
+            for (size_t q = 0; q < 50; ++q) {
+                Point p(unit(rng) * 120 - 10, unit(rng) * 120 - 10);
+                ASSERT_EQ(view.contains(p), polygon.contains(p));
+                ASSERT_EQ(view.isBoundary(p), polygon.isBoundary(p));
+            }
+            // Vertices and edge midpoints are on the boundary
+            Point mid = (view[0] + view[1]) / 2;
+            ASSERT_EQ(view.isBoundary(view[0]), true);
+            ASSERT_EQ(view.contains(mid), polygon.contains(mid));
+            ASSERT_EQ(view.isBoundary(mid), polygon.isBoundary(mid));
+        }
+        ASSERT_EQ(store.vertexCount(), vertices);
+
+        PolygonStore moved(std::move(store));
+        ASSERT_EQ(moved.size(), polygons.size());
+        ASSERT_EQ(moved[7].area(), polygons[7].area());
+
+        bool thrown = false;
+        try {
+            moved[polygons.size()];
+        } catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        ASSERT_EQ(thrown, true);
+    }
+
+    // A flipped coordinate bit is caught by verify(), not by opening
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(64 + 3);
+        file.put('\x5a');
+    }
+    {
+        PolygonStore store(path);
+        ASSERT_EQ(store.verify(), false);
+    }
+
+    // Damaged headers and truncated files are rejected on open
+    auto opens = [&](const std::string& file) {
+        try {
+            PolygonStore store(file);
+            return true;
+        } catch (const std::invalid_argument&) {
+            return false;
+        }
+    };
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(16);
+        file.put(1);
+    }
+    ASSERT_EQ(opens(path), false);
+    PolygonStore::write(path, std::vector<Polygon>(polygons.begin(), polygons.begin() + 3));
+    ASSERT_EQ(opens(path), true);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file.put(0);
+    }
+    ASSERT_EQ(opens(path), false);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "not a polygon store";
+    }
+    ASSERT_EQ(opens(path), false);
+    ASSERT_EQ(opens("missing_polygon_store.bin"), false);
+
+    // Empty collections round-trip
+    PolygonStore::write(path, {});
+    ASSERT_EQ(PolygonStore(path).size(), 0u);
+    std::remove(path.c_str());
+}
+
+void TestPolygonIO() {
+    auto parse = [](const std::string& text, GeometryFormat format, size_t chunkSize) {
+        std::istringstream in(text);
+        PolygonReader reader(in, format, chunkSize);
+        std::vector<std::vector<Point>> result;
+        while (reader.next())
+            result.push_back(reader.vertices());
+        return result;
+    };
+    auto fails = [&](const std::string& text, GeometryFormat format) {
+        try {
+            parse(text, format, 7);
+            return false;
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+    };
+    const std::vector<Point> square = {Point(0, 0), Point(10, 0), Point(10, 10), Point(0, 10)};
+    const std::vector<Point> triangle = {Point(-1.5, 2e-3), Point(3, 4), Point(-7.25, 1e10)};
+
+    // Closing vertices are dropped, Z/M values ignored, tiny chunks split tokens anywhere
+    std::string wkt = "POLYGON ((0 0, 10 0, 10 10, 0 10, 0 0))\n"
+                      "polygon z ((-1.5 2e-3 7, 3 4 7, -7.25 1E10 7))\n"
+                      "POLYGON EMPTY MULTIPOLYGON (((0 0,10 0,10 10,0 10)), EMPTY, ((-1.5 2e-3, 3 4, -7.25 1e10, -1.5 0.002)))";
+    for (size_t chunk : {1, 3, 64, 1 << 16}) {
+        auto polygons = parse(wkt, GeometryFormat::WKT, chunk);
+        ASSERT_EQ(polygons.size(), 4u);
+        ASSERT_EQ(polygons[0] == square && polygons[2] == square, true);
+        ASSERT_EQ(polygons[1] == triangle && polygons[3] == triangle, true);
+    }
+
+    // Polygons are found anywhere in the document; other geometries, properties and unknown members are skipped
+    std::string geojson = R"({"type": "FeatureCollection", "features": [
+        {"type": "Feature", "properties": {"name": "sq\"uare", "coordinates": [[1, 2]], "type": "Parcel"},
+         "geometry": {"coordinates": [[[0, 0], [10, 0], [10, 10], [0, 10], [0, 0]]], "type": "Polygon"}},
+        {"type": "Feature", "geometry": {"type": "LineString", "coordinates": [[0, 0], [1, 1]]}, "properties": null},
+        {"type": "Feature", "geometry": {"type": "Point", "coordinates": [5, 5, 1]}, "properties": {"a": [true, false, -1.5e3]}},
+        {"type": "Feature", "geometry": {"type": "MultiPolygon", "coordinates": [
+            [[[-1.5, 2e-3, 9], [3, 4, 9], [-7.25, 1e10, 9], [-1.5, 0.002, 9]]], [[[0,0],[10,0],[10,10],[0,10]]]]}},
+        {"type": "Feature", "geometry": {"type": "GeometryCollection", "geometries": [
+            {"type": "Polygon", "coordinates": []}, {"type": "Polygon", "coordinates": [[[0,0],[10,0],[10,10],[0,10],[0,0]]]}]}}
+    ]}
+    {"type": "Polygon", "coordinates": [[[-1.5, 2e-3], [3, 4], [-7.25, 1e10]]]})";
+    for (size_t chunk : {1, 5, 64, 1 << 16}) {
+        auto polygons = parse(geojson, GeometryFormat::GEOJSON, chunk);
+        ASSERT_EQ(polygons.size(), 5u);
+        ASSERT_EQ(polygons[0] == square && polygons[2] == square && polygons[3] == square, true);
+        ASSERT_EQ(polygons[1] == triangle && polygons[4] == triangle, true);
+    }
+
+    ASSERT_EQ(fails("POLYGON ((0 0, 1 0, 0 1, 0 0), (0.1 0.1, 0.2 0.1, 0.1 0.2))", GeometryFormat::WKT), true);
+    ASSERT_EQ(fails("POINT (1 2)", GeometryFormat::WKT), true);
+    ASSERT_EQ(fails("POLYGON ((0 0, 1 0, 0 1)", GeometryFormat::WKT), true);
+    ASSERT_EQ(fails("POLYGON ((0 0, 1 x, 0 1))", GeometryFormat::WKT), true);
+    ASSERT_EQ(fails(R"({"type": "Polygon", "coordinates": [[[0,0],[1,0],[0,1]], [[0.1,0.1],[0.2,0.1],[0.1,0.2]]]})",
+                    GeometryFormat::GEOJSON), true);
+    ASSERT_EQ(fails(R"({"type": "Polygon", "coordinates": [[0,0],[1,0],[0,1]]})", GeometryFormat::GEOJSON), true);
+    ASSERT_EQ(fails(R"({"type": "Polygon", "coordinates": [[[0,0],[1,0],[0,1]]])", GeometryFormat::GEOJSON), true);
+    ASSERT_EQ(fails(R"([1, 2,])", GeometryFormat::GEOJSON), true);
+
+    // Writing and reading back gives the same doubles, through in-memory buffers too
+    std::mt19937_64 rng(43);
+    std::uniform_real_distribution<double> coord(-1e7, 1e7);
+    std::vector<Polygon> polygons;
+    for (size_t i = 0; i < 50; ++i) {
+        std::vector<Point> hull(20);
+        for (auto& p : hull)
+            p = Point(coord(rng), coord(rng) / 3);
+        polygons.push_back(ModifiedGrahamScan(hull));
+    }
+    // Short decimals, tiny and huge magnitudes
+    polygons.emplace_back(std::vector<Point>{Point(0.1, -0.05), Point(123456.789, 1e-7), Point(-1e300, 5e-324)});
+    polygons.emplace_back(std::vector<Point>{Point(-0.3, 0), Point(1e15, 1), Point(9007199254740993.0, 2.5e-16)});
+    for (GeometryFormat format : {GeometryFormat::WKT, GeometryFormat::GEOJSON}) {
+        std::ostringstream out;
+        writePolygons(out, polygons, format);
+        std::istringstream in(out.str());
+        std::vector<Polygon> read = readPolygons(in, format);
+        ASSERT_EQ(read.size(), polygons.size());
+        for (size_t i = 0; i < read.size(); ++i)
+            ASSERT_EQ(read[i].vertices() == polygons[i].vertices(), true);
+
+        std::string text = out.str();
+        PolygonReader reader(text.data(), text.size(), format);
+        size_t count = 0;
+        while (reader.next()) {
+            ConvexPolygon convex = reader.convexPolygon();
+            ASSERT_EQ(convex.area(), polygons[count++].area());
+        }
+        ASSERT_EQ(count, polygons.size());
+        ASSERT_EQ(reader.offset(), text.size());
+    }
+    std::ostringstream empty;
+    writePolygons(empty, {}, GeometryFormat::GEOJSON);
+    std::istringstream emptyIn(empty.str());
+    ASSERT_EQ(readPolygons(emptyIn, GeometryFormat::GEOJSON).size(), 0u);
+}
+
+void TestConvexOperations() {
+    // Reference: Sutherland-Hodgman clipping of a by every edge of b, O(N * M)
+    auto clippedArea = [](const ConvexPolygon& a, const ConvexPolygon& b) {
+        std::vector<Point> clip = b.vertices(), subject = a.vertices();
+        if (ccw(clip[0], clip[1], clip[2]) == Direction::CW)
+            std::reverse(clip.begin(), clip.end());
+        for (size_t i = 0; i < clip.size() && !subject.empty(); ++i) {
+            const Point& c = clip[i];
+            const Point& d = clip[(i + 1) % clip.size()];
+            std::vector<Point> kept;
+            for (size_t j = 0; j < subject.size(); ++j) {
+                const Point& p = subject[j];
+                const Point& q = subject[(j + 1) % subject.size()];
+                bool pIn = ccw(c, d, p) != Direction::CW, qIn = ccw(c, d, q) != Direction::CW;
+                if (pIn)
+                    kept.push_back(p);
+                if (pIn != qIn) {
+                    double t = cross(c - p, d - c) / cross(q - p, d - c);
+                    kept.push_back(p + t * (q - p));
+                }
+            }
+            subject = kept;
+        }
+        if (subject.size() < 3)
+            return 0.0;
+        double area = 0;
+        for (size_t i = 0; i < subject.size(); ++i)
+            area += cross(subject[i], subject[(i + 1) % subject.size()]);
+        return std::abs(area) / 2;
+    };
+    auto strictlyConvex = [](const ConvexPolygon& polygon) {
+        const auto& v = polygon.vertices();
+        for (size_t i = 0; i < v.size(); ++i)
+            if (ccw(v[i], v[(i + 1) % v.size()], v[(i + 2) % v.size()]) != Direction::CCW)
+                return false;
+        return true;
+    };
+    auto hull = [](std::mt19937_64& rng, double cx, double cy, double r, size_t n, bool integer, bool clockwise) {
+        std::uniform_real_distribution<double> offset(-r, r);
+        std::vector<Point> points(n);
+        // Rounded points may all be collinear, then draw again
+        auto degenerate = [&]() {
+            for (const auto& p : points)
+                if (ccw(points[0], points[1], p) != Direction::COLLINEAR)
+                    return false;
+            return true;
+        };
+        do {
+            for (auto& p : points) {
+                p = Point(cx + offset(rng), cy + offset(rng));
+                if (integer)
+                    p = Point(std::round(p.x), std::round(p.y));
+            }
+        } while (degenerate());
+        std::vector<Point> vertices = ModifiedGrahamScan(points).vertices();
+        if (clockwise)
+            std::reverse(vertices.begin(), vertices.end());
+        return ConvexPolygon(vertices);
+    };
+
+    std::mt19937_64 rng(47);
+    std::uniform_real_distribution<double> center(-10, 10);
+    size_t overlapping = 0;
+    ConvexPolygon reused = hull(rng, 0, 0, 1, 10, false, false);
+    for (size_t iteration = 0; iteration < 3000; ++iteration) {
+        // Small integer coordinates make shared vertices, collinear and identical edges common
+        bool integer = iteration % 2 == 0;
+        double r = integer ? 4 : 6;
+        ConvexPolygon a = hull(rng, center(rng), center(rng), r, 3 + iteration % 20, integer, iteration % 3 == 0);
+        ConvexPolygon b = iteration % 7 == 0 ? a : hull(rng, center(rng), center(rng), r, 3 + iteration % 13, integer,
+                                                        iteration % 5 == 0);
+        double expected = clippedArea(a, b);
+        bool found = intersection(a, b, reused);
+        ASSERT_EQ(found, expected > 1e-9);
+        if (found) {
+            ++overlapping;
+            ASSERT_EQ(std::abs(reused.area() - expected) <= 1e-9 * std::max(1.0, expected), true);
+            ASSERT_EQ(strictlyConvex(reused), true);
+            ConvexPolygon byValue = intersection(b, a);
+            ASSERT_EQ(std::abs(byValue.area() - expected) <= 1e-9 * std::max(1.0, expected), true);
+        } else {
+            bool thrown = false;
+            try {
+                intersection(a, b);
+            } catch (const std::logic_error&) {
+                thrown = true;
+            }
+            ASSERT_EQ(thrown, true);
+        }
+
+        // Minkowski sum: hull of all the pairwise sums
+        std::vector<Point> sums;
+        for (const auto& p : a.vertices())
+            for (const auto& q : b.vertices())
+                sums.push_back(p + q);
+        ConvexPolygon sum = minkowskiSum(a, b);
+        ConvexPolygon expectedSum = ModifiedGrahamScan(sums);
+        ASSERT_EQ(strictlyConvex(sum), true);
+        if (integer) {
+            std::vector<Point> got = sum.vertices(), want = expectedSum.vertices();
+            std::sort(got.begin(), got.end());
+            std::sort(want.begin(), want.end());
+            ASSERT_EQ(got == want, true);
+        } else {
+            ASSERT_EQ(std::abs(sum.area() - expectedSum.area()) <= 1e-9 * expectedSum.area(), true);
+        }
+        minkowskiSum(a, b, reused);
+        ASSERT_EQ(reused.area(), sum.area());
+    }
+    ASSERT_EQ(overlapping > 1000, true);
+
+    // Nested, touching along an edge, touching at a vertex, aliasing the result
+    ConvexPolygon big(std::vector<Point>{Point(0, 0), Point(10, 0), Point(10, 10), Point(0, 10)});
+    ConvexPolygon small(std::vector<Point>{Point(2, 2), Point(4, 2), Point(3, 5)});
+    ConvexPolygon right(std::vector<Point>{Point(10, 0), Point(20, 0), Point(20, 10), Point(10, 10)});
+    ConvexPolygon corner(std::vector<Point>{Point(10, 10), Point(12, 10), Point(12, 12)});
+    ASSERT_EQ(intersection(big, small).area(), small.area());
+    ASSERT_EQ(intersection(small, big).area(), small.area());
+    double before = reused.area();
+    ASSERT_EQ(intersection(big, right, reused), false);
+    ASSERT_EQ(intersection(big, corner, reused), false);
+    ASSERT_EQ(reused.area(), before);
+    ConvexPolygon shifted(std::vector<Point>{Point(5, 5), Point(15, 5), Point(15, 15), Point(5, 15)});
+    ASSERT_EQ(intersection(big, shifted, big), true);
+    ASSERT_EQ(big.area(), 25.0);
+    ASSERT_EQ(big.contains(Point(7, 7)), true);
+    ASSERT_EQ(big.contains(Point(4, 7)), false);
+    minkowskiSum(big, small, big);
+    ASSERT_EQ(big.area(), minkowskiSum(ConvexPolygon(std::vector<Point>{Point(5, 5), Point(10, 5), Point(10, 10),
+                                                                       Point(5, 10)}), small).area());
+}
+
+void TestPolygonBoolean() {
+    auto signedArea = [](const Polygon& polygon) {
+        const auto& v = polygon.vertices();
+        double area = 0;
+        for (size_t i = 0; i < v.size(); ++i)
+            area += cross(v[i], v[(i + 1) % v.size()]);
+        return area / 2;
+    };
+    auto total = [&](const std::vector<Polygon>& rings) {
+        double area = 0;
+        for (const auto& ring : rings)
+            area += signedArea(ring);
+        return area;
+    };
+    // Counter-clockwise rings around p minus clockwise ones
+    auto winding = [&](const std::vector<Polygon>& rings, const Point& p) {
+        int result = 0;
+        for (const auto& ring : rings)
+            if (ring.contains(p) && !ring.isBoundary(p))
+                result += signedArea(ring) > 0 ? 1 : -1;
+        return result;
+    };
+    auto square = [](double x0, double y0, double x1, double y1) {
+        return Polygon(std::vector<Point>{Point(x0, y0), Point(x1, y0), Point(x1, y1), Point(x0, y1)});
+    };
+    const auto UNION = BooleanOperation::UNION;
+    const auto INTERSECTION = BooleanOperation::INTERSECTION;
+    const auto DIFFERENCE = BooleanOperation::DIFFERENCE;
+
+    Polygon a = square(0, 0, 4, 4);
+    ASSERT_EQ(booleanOperation(a, a, UNION).size(), 1u);
+    ASSERT_EQ(total(booleanOperation(a, a, UNION)), 16.0);
+    ASSERT_EQ(total(booleanOperation(a, a, INTERSECTION)), 16.0);
+    ASSERT_EQ(booleanOperation(a, a, DIFFERENCE).empty(), true);
+
+    Polygon far = square(10, 10, 12, 12);
+    ASSERT_EQ(booleanOperation(a, far, UNION).size(), 2u);
+    ASSERT_EQ(booleanOperation(a, far, INTERSECTION).empty(), true);
+    ASSERT_EQ(total(booleanOperation(a, far, DIFFERENCE)), 16.0);
+
+    // A hole, and a square sharing an edge with a
+    Polygon inner = square(1, 1, 2, 2);
+    std::vector<Polygon> holed = booleanOperation(a, inner, DIFFERENCE);
+    ASSERT_EQ(holed.size(), 2u);
+    ASSERT_EQ(total(holed), 15.0);
+    ASSERT_EQ(winding(holed, Point(1.5, 1.5)), 0);
+    ASSERT_EQ(winding(holed, Point(3, 3)), 1);
+    ASSERT_EQ(total(booleanOperation(inner, a, UNION)), 16.0);
+    ASSERT_EQ(booleanOperation(inner, a, DIFFERENCE).empty(), true);
+
+    Polygon next = square(4, 0, 8, 4);
+    std::vector<Polygon> merged = booleanOperation(a, next, UNION);
+    ASSERT_EQ(merged.size(), 1u);
+    ASSERT_EQ(merged[0].size(), 4u);
+    ASSERT_EQ(total(merged), 32.0);
+    ASSERT_EQ(booleanOperation(a, next, INTERSECTION).empty(), true);
+    ASSERT_EQ(total(booleanOperation(a, next, DIFFERENCE)), 16.0);
+
+    // Clockwise input, partial overlap along a shared edge
+    Polygon shifted(std::vector<Point>{Point(2, 0), Point(2, 4), Point(6, 4), Point(6, 0)});
+    ASSERT_EQ(total(booleanOperation(a, shifted, UNION)), 24.0);
+    ASSERT_EQ(total(booleanOperation(a, shifted, INTERSECTION)), 8.0);
+    ASSERT_EQ(total(booleanOperation(a, shifted, DIFFERENCE)), 8.0);
+    ASSERT_EQ(booleanOperation(a, shifted, DIFFERENCE)[0].size(), 4u);
+
+    // Far from the origin, left of where the containment ray used to end
+    Polygon west = square(-2e6, 0, -1e6, 1e6), overlap = square(-1.5e6, 5e5, -5e5, 2e6);
+    ASSERT_EQ(west.contains(Point(-1.5e6, 2e5)), true);
+    ASSERT_EQ(total(booleanOperation(west, overlap, UNION)), 1e12 + 1.5e12 - 2.5e11);
+    ASSERT_EQ(total(booleanOperation(west, overlap, DIFFERENCE)), 1e12 - 2.5e11);
+
+    // Near (1e9, 1e9) a shoelace sum over absolute coordinates cancels; area() and orientation() do not
+    Polygon remote = square(1e9, 1e9, 1e9 + 2, 1e9 + 2), beside = square(1e9 + 1, 1e9 + 1, 1e9 + 3, 1e9 + 3);
+    Polygon remoteClockwise(std::vector<Point>(remote.vertices().rbegin(), remote.vertices().rend()));
+    for (const Polygon* first : {&remote, &remoteClockwise}) {
+        std::vector<Polygon> joined = booleanOperation(*first, beside, UNION);
+        ASSERT_EQ(joined.size(), 1u);
+        ASSERT_EQ(joined[0].area(), 7.0);
+        ASSERT_EQ(joined[0].orientation(), Direction::CCW);
+        std::vector<Polygon> common = booleanOperation(*first, beside, INTERSECTION);
+        ASSERT_EQ(common.size(), 1u);
+        ASSERT_EQ(common[0].area(), 1.0);
+        std::vector<Polygon> rest = booleanOperation(*first, beside, DIFFERENCE);
+        ASSERT_EQ(rest.size(), 1u);
+        ASSERT_EQ(rest[0].area(), 3.0);
+    }
+
+    // Random star-shaped polygons: area identities and membership of random points
+    std::mt19937_64 rng(2024);
+    auto star = [&](double cx, double cy, double r, size_t n, bool integer) {
+        std::uniform_real_distribution<double> angle(0, 2 * M_PI), radius(0.2 * r, r);
+        while (true) {
+            std::vector<double> angles(n);
+            for (auto& t : angles)
+                t = angle(rng);
+            std::sort(angles.begin(), angles.end());
+            std::vector<Point> vertices;
+            for (double t : angles) {
+                double l = radius(rng);
+                Point p(cx + l * std::cos(t), cy + l * std::sin(t));
+                if (integer)
+                    p = Point(std::round(p.x), std::round(p.y));
+                if (vertices.empty() || vertices.back() != p)
+                    vertices.push_back(p);
+            }
+            if (vertices.size() > 2 && vertices.back() == vertices.front())
+                vertices.pop_back();
+            // Rounding may make the boundary cross itself: then only neighbouring edges may meet, at a vertex
+            std::vector<Segment> edges;
+            for (size_t k = 0; k < vertices.size(); ++k)
+                edges.emplace_back(vertices[k], vertices[(k + 1) % vertices.size()]);
+            std::vector<SegmentIntersection> meetings = calculateIntersections(edges);
+            bool simple = vertices.size() >= 3 && meetings.size() == vertices.size();
+            for (const auto& meeting : meetings)
+                simple = simple && meeting.intersection.start() == meeting.intersection.end();
+            if (!simple)
+                continue;
+            try {
+                return Polygon(vertices);
+            } catch (const std::invalid_argument&) {
+            }
+        }
+    };
+    std::uniform_real_distribution<double> center(-3, 3), coordinate(-15, 15);
+    for (size_t iteration = 0; iteration < 300; ++iteration) {
+        // Integer coordinates make shared vertices and collinear edges common
+        bool integer = iteration % 2 == 0;
+        Polygon p = star(center(rng), center(rng), 10, 5 + iteration % 40, integer);
+        Polygon q = iteration % 11 == 0 ? p : star(center(rng), center(rng), 10, 5 + iteration % 23, integer);
+        std::vector<Polygon> u = booleanOperation(p, q, UNION);
+        std::vector<Polygon> i = booleanOperation(p, q, INTERSECTION);
+        std::vector<Polygon> d = booleanOperation(p, q, DIFFERENCE);
+        double tolerance = 1e-9 * (p.area() + q.area());
+        ASSERT_EQ(std::abs(total(u) + total(i) - p.area() - q.area()) <= tolerance, true);
+        ASSERT_EQ(std::abs(total(d) - p.area() + total(i)) <= tolerance, true);
+        for (size_t k = 0; k < 50; ++k) {
+            Point x(coordinate(rng), coordinate(rng));
+            if (p.isBoundary(x) || q.isBoundary(x))
+                continue;
+            bool inP = p.contains(x), inQ = q.contains(x);
+            ASSERT_EQ(winding(u, x), inP || inQ ? 1 : 0);
+            ASSERT_EQ(winding(i, x), inP && inQ ? 1 : 0);
+            ASSERT_EQ(winding(d, x), inP && !inQ ? 1 : 0);
+        }
+    }
+}
+
+void TestRotatingCalipers() {
+    ConvexPolygon square(std::vector<Point>{Point(0, 0), Point(2, 0), Point(2, 2), Point(0, 2)});
+    Segment diagonal = square.diameter();
+    ASSERT_EQ(distance(diagonal.start(), diagonal.end()), std::sqrt(8.0));
+    ASSERT_EQ(square.width(), 2.0);
+    ASSERT_EQ(square.minimumAreaRectangle().area(), 4.0);
+    ASSERT_EQ(square.minimumPerimeterRectangle().perimeter(), 8.0);
+
+    // A diamond: the best rectangle is the diamond itself, not its axis-aligned box
+    ConvexPolygon diamond(std::vector<Point>{Point(0, -1), Point(1, 0), Point(0, 1), Point(-1, 0)});
+    ASSERT_EQ(std::abs(diamond.minimumAreaRectangle().area() - 2) < 1e-12, true);
+    ASSERT_EQ(std::abs(diamond.width() - std::sqrt(2.0)) < 1e-12, true);
+
+    // Reference: every vertex pair for the diameter, every edge against every vertex for the rest, O(N^2)
+    std::mt19937_64 rng(15);
+    std::uniform_real_distribution<double> coordinate(-100, 100);
+    for (size_t iteration = 0; iteration < 2000; ++iteration) {
+        std::vector<Point> points(3 + iteration % 50);
+        bool integer = iteration % 2 == 0;
+        for (auto& p : points) {
+            p = Point(coordinate(rng), coordinate(rng) * (iteration % 3 == 0 ? 0.01 : 1));
+            if (integer)
+                p = Point(std::round(p.x), std::round(p.y));
+        }
+        bool collinear = true;
+        for (const auto& p : points)
+            collinear = collinear && ccw(points[0], points[1], p) == Direction::COLLINEAR;
+        if (collinear)
+            continue;
+        std::vector<Point> vertices = ModifiedGrahamScan(points).vertices();
+        if (iteration % 4 == 0)
+            std::reverse(vertices.begin(), vertices.end());
+        ConvexPolygon hull(vertices);
+        const size_t n = vertices.size();
+
+        double diameter = 0;
+        for (const auto& p : vertices)
+            for (const auto& q : vertices)
+                diameter = std::max(diameter, distance(p, q));
+        Segment farthest = hull.diameter();
+        ASSERT_EQ(distance(farthest.start(), farthest.end()), diameter);
+
+        double width = INFINITY, area = INFINITY, perimeter = INFINITY;
+        for (size_t i = 0; i < n; ++i) {
+            Point e = vertices[(i + 1) % n] - vertices[i];
+            double length = std::sqrt(dot(e, e));
+            double low = INFINITY, high = -INFINITY, height = 0;
+            for (const auto& p : vertices) {
+                double along = dot(p - vertices[i], e) / length;
+                low = std::min(low, along);
+                high = std::max(high, along);
+                height = std::max(height, std::abs(cross(e, p - vertices[i])) / length);
+            }
+            width = std::min(width, height);
+            area = std::min(area, (high - low) * height);
+            perimeter = std::min(perimeter, 2 * (high - low + height));
+        }
+        const double eps = 1e-9;
+        ASSERT_EQ(std::abs(hull.width() - width) <= eps * diameter, true);
+        OrientedRectangle byArea = hull.minimumAreaRectangle();
+        OrientedRectangle byPerimeter = hull.minimumPerimeterRectangle();
+        ASSERT_EQ(std::abs(byArea.area() - area) <= eps * diameter * diameter, true);
+        ASSERT_EQ(std::abs(byPerimeter.perimeter() - perimeter) <= eps * diameter, true);
+
+        // Both rectangles are counter-clockwise and hold every vertex
+        for (const auto& rectangle : {byArea, byPerimeter}) {
+            for (size_t k = 0; k < 4; ++k) {
+                const Point& a = rectangle.corners[k];
+                const Point& b = rectangle.corners[(k + 1) % 4];
+                ASSERT_EQ(cross(b - a, rectangle.corners[(k + 2) % 4] - a) > 0, true);
+                for (const auto& p : vertices)
+                    ASSERT_EQ(cross(b - a, p - a) >= -eps * diameter * distance(a, b), true);
+            }
+        }
+    }
+}
+
+void TestPointKDTree() {
+    std::mt19937_64 rng(16);
+    std::uniform_real_distribution<double> coordinate(-1000, 1000);
+    std::uniform_int_distribution<int> grid(-20, 20);
+    auto squared = [](const Point& a, const Point& b) {
+        return dot(a - b, a - b);
+    };
+
+    for (size_t n : {0, 1, 2, 9, 100, 5000}) {
+        for (bool integer : {false, true}) {
+            // Integer points repeat often: duplicates and equal distances exercise the ties
+            std::vector<Point> points(n);
+            for (auto& p : points)
+                p = integer ? Point(grid(rng), grid(rng)) : Point(coordinate(rng), coordinate(rng));
+            PointKDTree tree(points);
+            ASSERT_EQ(tree.size(), n);
+
+            std::vector<Point> queries;
+            for (size_t q = 0; q < 50; ++q)
+                queries.push_back(integer ? Point(grid(rng), grid(rng)) : Point(coordinate(rng), coordinate(rng)));
+            if (n > 0)
+                queries.push_back(points[0]);
+            const double radius = integer ? 3 : 150;
+            for (const auto& q : queries) {
+                std::vector<size_t> order(n);
+                for (size_t i = 0; i < n; ++i)
+                    order[i] = i;
+                std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                    return std::make_pair(squared(points[a], q), a) < std::make_pair(squared(points[b], q), b);
+                });
+                for (size_t k : {1, 5, 20}) {
+                    std::vector<size_t> expected(order.begin(), order.begin() + std::min(k, n));
+                    ASSERT_EQ(tree.nearest(q, k) == expected, true);
+                }
+
+                std::vector<size_t> close, boxed;
+                BoundingBox box(q.x - radius, q.y - radius / 2, q.x + radius / 2, q.y + radius);
+                for (size_t i = 0; i < n; ++i) {
+                    if (squared(points[i], q) <= radius * radius)
+                        close.push_back(i);
+                    if (box.contains(points[i]))
+                        boxed.push_back(i);
+                }
+                ASSERT_EQ(tree.withinRadius(q, radius) == close, true);
+                ASSERT_EQ(tree.inside(box) == boxed, true);
+            }
+
+            std::vector<std::vector<size_t>> batched = tree.nearest(queries, 3, 4);
+            std::vector<std::vector<size_t>> around = tree.withinRadius(queries, radius, 4);
+            for (size_t q = 0; q < queries.size(); ++q) {
+                ASSERT_EQ(batched[q] == tree.nearest(queries[q], 3), true);
+                ASSERT_EQ(around[q] == tree.withinRadius(queries[q], radius), true);
+            }
+
+            if (n < 2) {
+                bool thrown = false;
+                try {
+                    tree.closestPair();
+                } catch (const std::logic_error&) {
+                    thrown = true;
+                }
+                ASSERT_EQ(thrown, true);
+            } else {
+                std::pair<size_t, size_t> expected(0, 1);
+                for (size_t i = 0; i < n; ++i)
+                    for (size_t j = i + 1; j < n; ++j)
+                        if (squared(points[i], points[j]) < squared(points[expected.first], points[expected.second]))
+                            expected = std::make_pair(i, j);
+                ASSERT_EQ(tree.closestPair() == expected, true);
+            }
+        }
+    }
+}
+
+void TestTriangulation() {
+    std::mt19937_64 rng(17);
+    auto check = [](const Polygon& polygon, const std::vector<Triangle>& triangles) {
+        const auto& v = polygon.vertices();
+        ASSERT_EQ(triangles.size(), v.size() - 2);
+        double area = 0, expected = 2 * polygon.area();
+        std::set<std::vector<uint32_t>> distinct;
+        for (const auto& t : triangles) {
+            ASSERT_EQ(t.a < v.size() && t.b < v.size() && t.c < v.size(), true);
+            ASSERT_EQ(ccw(v[t.a], v[t.b], v[t.c]) != Direction::CW, true);
+            area += cross(v[t.b] - v[t.a], v[t.c] - v[t.a]);
+            ASSERT_EQ(polygon.contains(Point((v[t.a].x + v[t.b].x + v[t.c].x) / 3,
+                                             (v[t.a].y + v[t.b].y + v[t.c].y) / 3)), true);
+            std::vector<uint32_t> key{t.a, t.b, t.c};
+            std::sort(key.begin(), key.end());
+            distinct.insert(key);
+        }
+        ASSERT_EQ(distinct.size(), triangles.size());
+        ASSERT_EQ(std::abs(area - expected) <= 1e-9 * expected, true);
+
+        // The triangles cover the polygon without overlapping
+        BoundingBox box;
+        for (const auto& p : v)
+            box.add(p);
+        std::mt19937_64 sample(v.size());
+        std::uniform_real_distribution<double> x(box.minX, box.maxX), y(box.minY, box.maxY);
+        for (size_t s = 0; s < 200; ++s) {
+            Point p(x(sample), y(sample));
+            size_t inside = 0;
+            for (const auto& t : triangles)
+                if (ccw(v[t.a], v[t.b], p) == Direction::CCW && ccw(v[t.b], v[t.c], p) == Direction::CCW &&
+                    ccw(v[t.c], v[t.a], p) == Direction::CCW)
+                    ++inside;
+            ASSERT_EQ(inside <= 1, true);
+            if (inside == 1)
+                ASSERT_EQ(polygon.contains(p), true);
+        }
+    };
+    auto both = [&](std::vector<Point> vertices) {
+        for (bool reversed : {false, true}) {
+            if (reversed)
+                std::reverse(vertices.begin(), vertices.end());
+            Polygon polygon(vertices);
+            check(polygon, triangulateMonotone(polygon));
+            check(polygon, triangulateEarClipping(polygon));
+            check(polygon, triangulate(polygon));
+        }
+    };
+
+    both({Point(0, 0), Point(1, 0), Point(0, 1)});
+    both({Point(0, 0), Point(4, 0), Point(4, 4), Point(0, 4)});
+    /*
+     * Combs with teeth up and down: every gap is a merge or split vertex, and many vertices are level.
+     * Moved near (1e10, 1e10) too, where a shoelace sum over absolute coordinates cannot tell the orientation
+     */
+    for (size_t teeth : {2, 5, 40, 41}) {
+        const double offset = teeth == 41 ? 1e10 : 0;
+        std::vector<Point> comb;
+        for (size_t i = 0; i < teeth; ++i) {
+            comb.emplace_back(3.0 * i, 0);
+            comb.emplace_back(3.0 * i + 1, -5.0 - i % 3);
+            comb.emplace_back(3.0 * i + 2, 0);
+        }
+        for (size_t i = teeth; i-- > 0;) {
+            comb.emplace_back(3.0 * i + 2, 2);
+            comb.emplace_back(3.0 * i + 1, 7.0 + i % 2);
+            comb.emplace_back(3.0 * i, 2);
+        }
+        for (auto& p : comb)
+            p = p + Point(offset, offset);
+        both(comb);
+    }
+    // Square spiral
+    {
+        std::vector<Point> outer, inner;
+        for (int i = 0; i < 12; ++i) {
+            double r = 2.0 * i + 2;
+            int side = i % 4;
+            Point corner = side == 0 ? Point(r, -r + 2) : side == 1 ? Point(r, r) : side == 2 ? Point(-r, r)
+                                                                                            : Point(-r, -r);
+            outer.push_back(corner);
+            Point shrink = corner - Point(corner.x > 0 ? 1 : -1, corner.y > 0 ? 1 : -1);
+            inner.push_back(shrink);
+        }
+        outer.insert(outer.end(), inner.rbegin(), inner.rend());
+        both(outer);
+    }
+
+    // Random x-monotone polygons: the sweep from the top meets a split or merge vertex at nearly every spike
+    std::uniform_real_distribution<double> unit(0, 1);
+    for (size_t iteration = 0; iteration < 100; ++iteration) {
+        size_t n = 4 + iteration * 3;
+        std::vector<double> xs(n);
+        for (auto& x : xs)
+            x = unit(rng);
+        std::sort(xs.begin(), xs.end());
+        std::vector<Point> lower, upper;
+        for (size_t i = 0; i < n; ++i) {
+            if (i % 2 == 0)
+                lower.emplace_back(xs[i], unit(rng) / 2);
+            else
+                upper.emplace_back(xs[i], 0.5 + unit(rng));
+        }
+        lower.insert(lower.end(), upper.rbegin(), upper.rend());
+        both(lower);
+    }
+
+    // Random star-shaped polygons with deep reflex vertices; integer ones have level and collinear vertices
+    std::uniform_real_distribution<double> angle(0, 2 * M_PI), radius(0.1, 1);
+    for (size_t iteration = 0; iteration < 400; ++iteration) {
+        bool integer = iteration % 2 == 0;
+        size_t n = 3 + iteration % 120;
+        std::vector<double> angles(n);
+        for (auto& t : angles)
+            t = angle(rng);
+        std::sort(angles.begin(), angles.end());
+        std::vector<Point> vertices;
+        for (double t : angles) {
+            double l = 100 * radius(rng);
+            Point p(l * std::cos(t), l * std::sin(t));
+            if (integer)
+                p = Point(std::round(p.x), std::round(p.y));
+            if (vertices.empty() || vertices.back() != p)
+                vertices.push_back(p);
+        }
+        if (vertices.size() > 2 && vertices.back() == vertices.front())
+            vertices.pop_back();
+        std::vector<Segment> edges;
+        for (size_t k = 0; k < vertices.size(); ++k)
+            edges.emplace_back(vertices[k], vertices[(k + 1) % vertices.size()]);
+        std::vector<SegmentIntersection> meetings = calculateIntersections(edges);
+        bool simple = vertices.size() >= 3 && meetings.size() == vertices.size();
+        for (const auto& meeting : meetings)
+            simple = simple && meeting.intersection.start() == meeting.intersection.end();
+        if (!simple)
+            continue;
+        try {
+            Polygon(std::vector<Point>(vertices));
+        } catch (const std::invalid_argument&) {
+            continue;
+        }
+        both(vertices);
+    }
+}
+
+void TestBasicPolygon() {
+    static_assert(sizeof(BasicPoint<float>) == 8 && sizeof(BasicPoint<int32_t>) == 8, "compact points");
+    static_assert(sizeof(BasicSegment<int32_t>) == 16, "compact segments");
+    std::mt19937_64 rng(18);
+
+#ifdef __SIZEOF_INT128__
+    // Exact orientation where doubles cannot even hold the coordinates
+    const int64_t big = 3000000000000000000;
+    BasicPoint<int64_t> o(0, 0), q(big, big / 3), onLine(big - 3, big / 3 - 1), off(big - 3, big / 3);
+    ASSERT_EQ(ccw(o, q, onLine) == Direction::COLLINEAR, true);
+    ASSERT_EQ(ccw(o, q, off) == Direction::CCW, true);
+    ASSERT_EQ(ccw(o, off, q) == Direction::CW, true);
+#endif
+    BasicPoint<int32_t> a(INT32_MIN, INT32_MIN), b(INT32_MAX, INT32_MAX), c(INT32_MAX - 1, INT32_MAX - 1);
+    ASSERT_EQ(ccw(a, b, c) == Direction::COLLINEAR, true);
+    ASSERT_EQ(ccw(a, b, BasicPoint<int32_t>(INT32_MAX - 1, INT32_MAX)) == Direction::CCW, true);
+    ASSERT_EQ(intersects(BasicSegment<int32_t>(a, b), BasicSegment<int32_t>(BasicPoint<int32_t>(0, 5),
+                                                                          BasicPoint<int32_t>(5, 0))), true);
+
+    // Same answers as Polygon and ConvexPolygon over the same vertices
+    std::uniform_int_distribution<int> grid(-30, 30);
+    std::uniform_real_distribution<double> angle(0, 2 * M_PI), radius(5, 30);
+    for (size_t iteration = 0; iteration < 300; ++iteration) {
+        size_t n = 3 + iteration % 30;
+        std::vector<double> angles(n);
+        for (auto& t : angles)
+            t = angle(rng);
+        std::sort(angles.begin(), angles.end());
+        std::vector<Point> vertices;
+        for (double t : angles) {
+            double l = radius(rng);
+            Point p(std::round(l * std::cos(t)), std::round(l * std::sin(t)));
+            if (vertices.empty() || vertices.back() != p)
+                vertices.push_back(p);
+        }
+        if (vertices.size() > 2 && vertices.back() == vertices.front())
+            vertices.pop_back();
+        std::vector<Segment> edges;
+        for (size_t k = 0; k < vertices.size(); ++k)
+            edges.emplace_back(vertices[k], vertices[(k + 1) % vertices.size()]);
+        std::vector<SegmentIntersection> meetings = calculateIntersections(edges);
+        bool simple = vertices.size() >= 3 && meetings.size() == vertices.size();
+        for (const auto& meeting : meetings)
+            simple = simple && meeting.intersection.start() == meeting.intersection.end();
+        if (!simple)
+            continue;
+        std::unique_ptr<Polygon> polygon;
+        try {
+            polygon.reset(new Polygon(vertices));
+        } catch (const std::invalid_argument&) {
+            continue;
+        }
+        std::vector<BasicPoint<int32_t>> integer;
+        std::vector<BasicPoint<int64_t>> wide;
+        std::vector<BasicPoint<float>> single;
+        for (const auto& p : vertices) {
+            integer.emplace_back(static_cast<int32_t>(p.x), static_cast<int32_t>(p.y));
+            wide.emplace_back(static_cast<int64_t>(p.x), static_cast<int64_t>(p.y));
+            single.emplace_back(static_cast<float>(p.x), static_cast<float>(p.y));
+        }
+        BasicPolygon<int32_t> p32(integer);
+        BasicPolygon<int64_t> p64(wide);
+        BasicPolygon<float> pf(single);
+        ASSERT_EQ(p32.area(), polygon->area());
+        ASSERT_EQ(p64.area(), polygon->area());
+        ASSERT_EQ(pf.area(), polygon->area());
+        ASSERT_EQ(std::abs(p32.perimeter() - polygon->perimeter()) < 1e-9, true);
+
+        ConvexPolygon hull = ModifiedGrahamScan(vertices);
+        std::vector<BasicPoint<int32_t>> corners;
+        for (const auto& p : hull.vertices())
+            corners.emplace_back(static_cast<int32_t>(p.x), static_cast<int32_t>(p.y));
+        BasicConvexPolygon<int32_t> convex(corners);
+
+        for (size_t s = 0; s < 200; ++s) {
+            int x = grid(rng), y = grid(rng);
+            Point p(x, y);
+            bool inside = polygon->contains(p), boundary = polygon->isBoundary(p);
+            ASSERT_EQ(p32.contains(BasicPoint<int32_t>(x, y)), inside);
+            ASSERT_EQ(p32.isBoundary(BasicPoint<int32_t>(x, y)), boundary);
+            ASSERT_EQ(p64.contains(BasicPoint<int64_t>(x, y)), inside);
+            ASSERT_EQ(pf.contains(BasicPoint<float>(x, y)), inside);
+            ASSERT_EQ(pf.isBoundary(BasicPoint<float>(x, y)), boundary);
+            ASSERT_EQ(convex.contains(BasicPoint<int32_t>(x, y)), hull.contains(p));
+            ASSERT_EQ(convex.isBoundary(BasicPoint<int32_t>(x, y)), hull.isBoundary(p));
+        }
+    }
+
+    bool thrown = false;
+    try {
+        BasicConvexPolygon<int32_t>(std::vector<BasicPoint<int32_t>>{BasicPoint<int32_t>(0, 0),
+                BasicPoint<int32_t>(4, 0), BasicPoint<int32_t>(1, 1), BasicPoint<int32_t>(0, 4)});
+    } catch (const std::logic_error&) {
+        thrown = true;
+    }
+    ASSERT_EQ(thrown, true);
+}
+
+void TestSpatialHash() {
+    // Fractional and negative coordinates no longer collide
+    std::hash<Point> hash;
+    std::set<size_t> hashes;
+    for (int i = -50; i < 50; ++i)
+        for (int j = -50; j < 50; ++j)
+            hashes.insert(hash(Point(i * 0.1, j * 0.01)));
+    ASSERT_EQ(hashes.size(), 10000u);
+    ASSERT_EQ(hash(Point(0.0, -0.0)), hash(Point(-0.0, 0.0)));
+
+    std::mt19937_64 rng(20);
+    std::uniform_int_distribution<int> grid(-40, 40);
+    std::uniform_real_distribution<double> coordinate(-10, 10);
+    std::vector<Point> points;
+    for (size_t i = 0; i < 5000; ++i)
+        points.push_back(i % 2 ? Point(grid(rng) * 0.25, grid(rng) * 0.25) : Point(coordinate(rng), coordinate(rng)));
+
+    // Exact: the first occurrence of every point, in order
+    std::vector<Point> expected;
+    std::set<Point> seen;
+    for (const auto& p : points)
+        if (seen.insert(p).second)
+            expected.push_back(p);
+    ASSERT_EQ(deduplicate(points) == expected, true);
+    SpatialHash exact;
+    for (const auto& p : points)
+        exact.insert(p);
+    ASSERT_EQ(exact.size(), points.size());
+    ASSERT_EQ(exact.find(points[7]), size_t(std::find(points.begin(), points.end(), points[7]) - points.begin()));
+    ASSERT_EQ(exact.find(Point(0.3, 0.3)), SpatialHash::NONE);
+
+    // Within eps: the lowest index at distance <= eps, as a scan finds it
+    for (double eps : {0.0, 0.05, 0.25, 0.5}) {
+        SpatialHash within(0.5, 16);
+        for (const auto& p : points)
+            within.insert(p);
+        for (size_t q = 0; q < 300; ++q) {
+            Point p = q % 3 ? Point(coordinate(rng), coordinate(rng)) : points[q];
+            size_t first = SpatialHash::NONE;
+            for (size_t i = 0; i < points.size() && first == SpatialHash::NONE; ++i)
+                if (dot(points[i] - p, points[i] - p) <= eps * eps)
+                    first = i;
+            ASSERT_EQ(within.find(p, eps), first);
+            ASSERT_EQ(within.containsWithin(p, eps), first != SpatialHash::NONE);
+        }
+
+        std::vector<Point> kept = deduplicate(points, eps);
+        for (size_t i = 0; i < kept.size(); ++i)
+            for (size_t j = i + 1; j < kept.size(); ++j)
+                ASSERT_EQ(dot(kept[i] - kept[j], kept[i] - kept[j]) > eps * eps, true);
+    }
+
+    std::vector<Point> snapped = snapToGrid(points, 0.5);
+    std::set<Point> unique;
+    for (const auto& p : snapped) {
+        ASSERT_EQ(std::fmod(p.x, 0.5) == 0 && std::fmod(p.y, 0.5) == 0, true);
+        unique.insert(p);
+    }
+    ASSERT_EQ(unique.size(), snapped.size());
+    ASSERT_EQ(snap(Point(1.26, -0.74), 0.5) == Point(1.5, -0.5), true);
+
+    bool thrown = false;
+    try {
+        SpatialHash(0.5).find(Point(0, 0), 1);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    ASSERT_EQ(thrown, true);
+}
+
+void TestSimplification() {
+    std::mt19937_64 rng(21);
+    auto isSimple = [](const std::vector<Point>& v) {
+        std::vector<Segment> edges;
+        for (size_t k = 0; k < v.size(); ++k)
+            edges.emplace_back(v[k], v[(k + 1) % v.size()]);
+        std::vector<SegmentIntersection> meetings = calculateIntersections(edges);
+        bool simple = meetings.size() == v.size();
+        for (const auto& meeting : meetings)
+            simple = simple && meeting.intersection.start() == meeting.intersection.end();
+        return simple;
+    };
+    auto segmentDistance = [](const Point& p, const Point& a, const Point& b) {
+        double t = std::max(0.0, std::min(1.0, dot(p - a, b - a) / dot(b - a, b - a)));
+        return distance(p, a + t * (b - a));
+    };
+    // Positions of the simplified vertices in the original ring; they must come in the same cyclic order
+    auto positions = [](const Polygon& original, const Polygon& simplified) {
+        const auto& v = original.vertices();
+        std::vector<size_t> result;
+        for (const auto& p : simplified.vertices())
+            result.push_back(std::find(v.begin(), v.end(), p) - v.begin());
+        size_t descents = 0;
+        for (size_t k = 0; k < result.size(); ++k) {
+            ASSERT_EQ(result[k] < v.size(), true);
+            descents += result[(k + 1) % result.size()] < result[k];
+        }
+        ASSERT_EQ(descents, 1u);
+        return result;
+    };
+
+    std::uniform_real_distribution<double> angle(0, 2 * M_PI), noise(0.6, 1);
+    for (size_t iteration = 0; iteration < 60; ++iteration) {
+        // Noisy star: deep notches next to each other make naive simplification cross itself
+        size_t n = 20 + iteration * 15;
+        std::vector<double> angles(n);
+        for (auto& t : angles)
+            t = angle(rng);
+        std::sort(angles.begin(), angles.end());
+        angles.erase(std::unique(angles.begin(), angles.end()), angles.end());
+        std::vector<Point> vertices;
+        for (double t : angles) {
+            double r = 100 * (iteration % 2 ? noise(rng) : (vertices.size() % 2 ? 0.3 : 1) * noise(rng));
+            vertices.emplace_back(r * std::cos(t), r * std::sin(t));
+        }
+        if (!isSimple(vertices))
+            continue;
+        Polygon polygon(vertices);
+
+        for (double tolerance : {0.0, 1.0, 5.0, 20.0, 60.0}) {
+            Polygon dp = simplify(polygon, tolerance);
+            ASSERT_EQ(isSimple(dp.vertices()), true);
+            std::vector<size_t> at = positions(polygon, dp);
+            if (tolerance == 0)
+                ASSERT_EQ(dp.size(), polygon.size());
+            // Every removed vertex is within tolerance of the edge that replaced it
+            for (size_t k = 0; k < at.size(); ++k) {
+                size_t from = at[k], to = at[(k + 1) % at.size()];
+                for (size_t i = (from + 1) % n; i != to; i = (i + 1) % n)
+                    ASSERT_EQ(segmentDistance(vertices[i], vertices[from], vertices[to]) <= tolerance + 1e-9,
+                              true);
+            }
+
+            Polygon vw = simplify(polygon, tolerance * tolerance, Simplification::VISVALINGAM_WHYATT);
+            ASSERT_EQ(isSimple(vw.vertices()), true);
+            positions(polygon, vw);
+            if (tolerance == 0)
+                ASSERT_EQ(vw.size(), polygon.size());
+        }
+
+        std::vector<double> tolerances{20.0, 1.0, 5.0};
+        PolygonLevels levels(polygon, tolerances);
+        ASSERT_EQ(levels.size(), 3u);
+        ASSERT_EQ(levels.tolerance(0), 1.0);
+        ASSERT_EQ(levels[2].vertices() == simplify(polygon, 20).vertices(), true);
+        ASSERT_EQ(&levels.forTolerance(0.5) == &levels.forTolerance(0), true);
+        ASSERT_EQ(levels.forTolerance(0.5).size(), polygon.size());
+        ASSERT_EQ(&levels.forTolerance(7), &levels[1]);
+        ASSERT_EQ(&levels.forTolerance(100), &levels[2]);
+    }
+
+    // A notch reaching below the chord that would replace the bulge at the bottom: the bulge has to stay
+    Polygon notched(std::vector<Point>{Point(0, 0), Point(50, -5), Point(100, 0), Point(100, 100), Point(56, 100),
+                                       Point(55, -1), Point(45, -1), Point(44, 100), Point(0, 100)});
+    for (const Polygon& simplified : {simplify(notched, 6), simplify(notched, 10),
+                                      simplify(notched, 300, Simplification::VISVALINGAM_WHYATT)}) {
+        ASSERT_EQ(isSimple(simplified.vertices()), true);
+        ASSERT_EQ(std::find(simplified.vertices().begin(), simplified.vertices().end(), Point(50, -5)) !=
+                  simplified.vertices().end(), true);
+    }
+
+    // Collinear vertices left behind are dropped
+    Polygon square(std::vector<Point>{Point(0, 0), Point(2, 0.01), Point(4, 0), Point(4, 4), Point(0, 4)});
+    ASSERT_EQ(simplify(square, 0.1).size(), 4u);
+}
+
+
+void TestMetrics() {
+    resetMetrics();
+    Polygon square({Point(0, 0), Point(10, 0), Point(10, 10), Point(0, 10)});
+    ConvexPolygon octagon({Point(3, 0), Point(7, 0), Point(10, 3), Point(10, 7),
+                           Point(7, 10), Point(3, 10), Point(0, 7), Point(0, 3)});
+    // Fresh threads, so that each one times its first call of every operation
+    std::vector<bool> answers;
+    bool thrown = false;
+    std::thread([&] {
+        answers.push_back(square.contains(Point(5, 5)));
+        answers.push_back(square.contains(Point(15, 5)));     // outside the bounding box, no edge tested
+        answers.push_back(square.contains(Point(10, 5)));     // on the third edge tested, after (0, 10)-(0, 0)
+        for (int i = 0; i < 10; ++i)
+            answers.push_back(octagon.contains(Point(i, 5)));
+        answers.push_back(ModifiedGrahamScan({Point(0, 0), Point(2, 0), Point(1, 1), Point(1, 3)}).size() == 3);
+        try {
+            ModifiedGrahamScan({Point(0, 0), Point(1, 1), Point(2, 2)});
+        } catch (const std::exception&) {
+            thrown = true;
+        }
+    }).join();
+    std::thread([&] { square.contains(Point(1, 1)); }).join();
+    ASSERT_EQ(answers, std::vector<bool>({true, false, true, true, true, true, true, true, true, true, true, true,
+                                          true, true}));
+    ASSERT_EQ(thrown, true);
+
+    MetricsSnapshot snapshot = metricsSnapshot();
+    const OperationMetrics& polygon = snapshot[Operation::POLYGON_CONTAINS];
+    const OperationMetrics& convex = snapshot[Operation::CONVEX_POLYGON_CONTAINS];
+    const OperationMetrics& hull = snapshot[Operation::MODIFIED_GRAHAM_SCAN];
+    if (!metricsEnabled()) {
+        for (const auto& m : snapshot.operations) {
+            ASSERT_EQ(m.calls, 0u);
+            ASSERT_EQ(m.predicates, 0u);
+            ASSERT_EQ(m.latency.total(), 0u);
+        }
+        return;
+    }
+
+    // Threads that have exited still count; the crossing-number test takes one orientation per edge
+    ASSERT_EQ(polygon.calls, 4u);
+    ASSERT_EQ(polygon.edges, 4u + 3u + 4u);
+    ASSERT_EQ(polygon.predicates, polygon.edges);
+    ASSERT_EQ(polygon.collinear >= 1, true);
+    ASSERT_EQ(polygon.exceptions, 0u);
+    ASSERT_EQ(polygon.latency.total(), 2u);
+
+    // One orientation for the half-turn, the binary search, one for the edge of the wedge
+    ASSERT_EQ(convex.calls, 10u);
+    ASSERT_EQ(convex.searchSteps >= 10 && convex.searchSteps <= 10 * 3, true);
+    ASSERT_EQ(convex.predicates, convex.searchSteps + 2 * convex.calls);
+    ASSERT_EQ(convex.edges, 0u);
+    ASSERT_EQ(convex.latency.total(), 1u);
+
+    ASSERT_EQ(hull.calls, 2u);
+    ASSERT_EQ(hull.exceptions, 1u);
+    ASSERT_EQ(hull.collinear >= 1, true);
+    ASSERT_EQ(hull.latency.total(), 1u);
+    ASSERT_EQ(hull.latency.quantile(1) >= hull.latency.quantile(0), true);
+    ASSERT_EQ(hull.latency.quantile(1) >= hull.nanoseconds, true);
+
+    std::string json = snapshot.toJson();
+    ASSERT_EQ(json.find("\"modified_graham_scan\": {\"calls\": 2, \"exceptions\": 1,") != std::string::npos, true);
+
+    resetMetrics();
+    ASSERT_EQ(metricsSnapshot()[Operation::POLYGON_CONTAINS].calls, 0u);
+    std::thread([&] {
+        for (uint64_t i = 0; i < 4 * LATENCY_SAMPLING; ++i)
+            square.contains(Point(5, 5));
+    }).join();
+    ASSERT_EQ(metricsSnapshot()[Operation::POLYGON_CONTAINS].calls, 4 * LATENCY_SAMPLING);
+    ASSERT_EQ(metricsSnapshot()[Operation::POLYGON_CONTAINS].latency.total(), 4u);
+    ASSERT_EQ(LatencyHistogram::bucket(0), 0u);
+    ASSERT_EQ(LatencyHistogram::bucket(1), 1u);
+    ASSERT_EQ(LatencyHistogram::bucket(1000), 10u);
+}
+
+
+void TestPolygonSimplicity() {
+    // Every pair of edges, as isSimple() defines it
+    auto bruteForce = [](const std::vector<Point>& v, size_t i, size_t j) {
+        const size_t n = v.size();
+        Segment a(v[i], v[(i + 1) % n]), b(v[j], v[(j + 1) % n]);
+        if ((i + 1) % n == j || (j + 1) % n == i) {
+            size_t k = (i + 1) % n == j ? i : j;
+            const Point& p = v[k];
+            const Point& q = v[(k + 1) % n];
+            const Point& r = v[(k + 2) % n];
+            return ccw(p, q, r) == Direction::COLLINEAR && (onSegment(Segment(p, q), r) || onSegment(Segment(q, r), p));
+        }
+        return intersects(a, b);
+    };
+    auto simple = [&](const std::vector<Point>& v) {
+        for (size_t i = 0; i < v.size(); ++i)
+            for (size_t j = i + 1; j < v.size(); ++j)
+                if (bruteForce(v, i, j))
+                    return false;
+        return true;
+    };
+
+    EdgePair pair{};
+    ASSERT_EQ(isSimple({Point(0, 0), Point(1, 0), Point(1, 1), Point(0, 1)}), true);
+    ASSERT_EQ(isSimple({Point(0, 0), Point(1, 1), Point(1, 0), Point(0, 1)}, &pair), false);
+    ASSERT_EQ(pair.first, 0u);
+    ASSERT_EQ(pair.second, 2u);
+    // Two vertices at the same point
+    ASSERT_EQ(isSimple({Point(0, 0), Point(2, 0), Point(1, 1), Point(2, 2), Point(0, 2), Point(1, 1)}), false);
+    // A vertex on an edge that is not next to it
+    ASSERT_EQ(isSimple({Point(0, 0), Point(4, 0), Point(4, 3), Point(2, 0), Point(0, 3)}, &pair), false);
+    ASSERT_EQ(pair.first == 0 && (pair.second == 2 || pair.second == 3), true);
+    // Consecutive edges folding back over each other, a repeated vertex, a straight angle that is fine
+    ASSERT_EQ(isSimple({Point(0, 0), Point(2, 0), Point(1, 0), Point(1, 1)}, &pair), false);
+    ASSERT_EQ(pair.first, 0u);
+    ASSERT_EQ(pair.second, 1u);
+    ASSERT_EQ(isSimple({Point(0, 0), Point(1, 0), Point(1, 0), Point(0, 1)}), false);
+    ASSERT_EQ(isSimple({Point(0, 0), Point(1, 0), Point(2, 0), Point(0, 1)}), true);
+    // Vertical edges and a spike touching the opposite side
+    ASSERT_EQ(isSimple({Point(0, 0), Point(0, 4), Point(2, 4), Point(2, 1), Point(1, 4), Point(1, 0)}), false);
+    ASSERT_EQ(isSimple({Point(0, 0), Point(0, 4), Point(2, 4), Point(2, 1), Point(1, 3), Point(1, 0)}), true);
+
+    // Small integer coordinates, full of shared vertices, touching and overlapping edges
+    std::mt19937 rng(23);
+    std::uniform_int_distribution<int> coordinate(0, 4);
+    size_t simpleCount = 0;
+    for (int iteration = 0; iteration < 20000; ++iteration) {
+        std::vector<Point> v(3 + iteration % 8);
+        for (auto& p : v)
+            p = Point(coordinate(rng), coordinate(rng));
+        bool expected = simple(v);
+        simpleCount += expected;
+        ASSERT_EQ(isSimple(v, &pair), expected);
+        if (!expected) {
+            ASSERT_EQ(pair.first < pair.second && pair.second < v.size(), true);
+            ASSERT_EQ(bruteForce(v, pair.first, pair.second), true);
+        }
+    }
+    ASSERT_EQ(simpleCount > 1000, true);
+
+    // Random stars are simple until one vertex is moved across the polygon
+    std::uniform_real_distribution<double> unit(0, 1);
+    for (int iteration = 0; iteration < 200; ++iteration) {
+        const size_t n = 5 + iteration * 7;
+        std::vector<Point> v;
+        for (size_t i = 0; i < n; ++i) {
+            double angle = 2 * M_PI * i / n, r = 0.5 + unit(rng);
+            v.emplace_back(r * std::cos(angle), r * std::sin(angle));
+        }
+        ASSERT_EQ(isSimple(v), true);
+        v[n / 2] = Point(2, 0.01);
+        ASSERT_EQ(isSimple(v), simple(v));
+    }
+
+    // Validating construction
+    std::vector<Point> bowTie = {Point(0, 0), Point(2, 2), Point(2, 0), Point(0, 2)};
+    ASSERT_EQ(Polygon(bowTie).isSimple(), false);
+    bool thrown = false;
+    try {
+        Polygon polygon(bowTie, Validation::SIMPLE);
+    } catch (const std::invalid_argument& e) {
+        thrown = std::string(e.what()) == "Polygon is not simple: edges 0 and 2 intersect.";
+    }
+    ASSERT_EQ(thrown, true);
+    ASSERT_EQ(Polygon({Point(0, 0), Point(2, 0), Point(2, 2), Point(0, 2)}, Validation::SIMPLE).size(), 4u);
+
+    const std::string wkt = "POLYGON ((0 0, 2 2, 2 0, 0 2, 0 0))";
+    PolygonReader reader(wkt.data(), wkt.size(), GeometryFormat::WKT);
+    ASSERT_EQ(reader.next(), true);
+    ASSERT_EQ(reader.polygon().size(), 4u);
+    thrown = false;
+    try {
+        reader.polygon(Validation::SIMPLE);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    ASSERT_EQ(thrown, true);
+}
+
+
+void TestContainmentGrid() {
+    // The comb of TestPolygonIndex, with lattice points on its vertices, edges and cell borders
+    std::vector<Point> comb;
+    comb.emplace_back(0, 0);
+    comb.emplace_back(20, 0);
+    for (int tooth = 4; tooth >= 0; --tooth) {
+        comb.emplace_back(4 * tooth + 3, 10 + tooth);
+        comb.emplace_back(4 * tooth + 2, 2);
+        comb.emplace_back(4 * tooth + 1, 9);
+    }
+    Polygon polygon(comb);
+    for (size_t budget : {100u, 400u, 2000u, 20000u, 1000000u}) {
+        Polygon gridded = polygon;
+        gridded.buildGrid(budget);
+        ASSERT_EQ(gridded.grid() != nullptr && polygon.grid() == nullptr, true);
+        ASSERT_EQ(gridded.grid()->memoryUsage() <= budget, true);
+        for (int x = -4; x <= 44; ++x) {
+            for (int y = -4; y <= 32; ++y) {
+                Point p(x / 2.0, y / 2.0);
+                ASSERT_EQ(gridded.contains(p), polygon.contains(p));
+                ASSERT_EQ(gridded.isBoundary(p), polygon.isBoundary(p));
+            }
+        }
+    }
+    bool thrown = false;
+    try {
+        polygon.buildGrid(64);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    ASSERT_EQ(thrown, true);
+
+    // Noisy stars far from the origin, with vertices, points on edges and random points, against the plain test
+    std::mt19937 rng(24);
+    std::uniform_real_distribution<double> unit(0, 1);
+    for (size_t n : {50u, 2000u}) {
+        std::vector<Point> vertices;
+        for (size_t i = 0; i < n; ++i) {
+            double angle = 2 * M_PI * i / n, r = 100 + 100 * unit(rng);
+            vertices.emplace_back(1e6 + r * std::cos(angle), -3e5 + r * std::sin(angle));
+        }
+        Polygon star(vertices);
+        Polygon gridded = star;
+        gridded.buildGrid(64 * n);
+        ASSERT_EQ(gridded.grid()->boundaryCells() > 0, true);
+        ASSERT_EQ(gridded.grid()->columns() * gridded.grid()->rows() > gridded.grid()->boundaryCells(), true);
+
+        std::vector<Point> queries(vertices);
+        for (size_t i = 0; i < n; ++i) {
+            const Point& a = vertices[i];
+            const Point& b = vertices[(i + 1) % n];
+            queries.emplace_back((a.x + b.x) / 2, (a.y + b.y) / 2);
+            queries.emplace_back(a.x, b.y);
+        }
+        for (int i = 0; i < 20000; ++i)
+            queries.emplace_back(1e6 - 250 + 500 * unit(rng), -3e5 - 250 + 500 * unit(rng));
+        std::vector<double> xs, ys;
+        std::vector<Location> expected;
+        for (const auto& q : queries) {
+            ASSERT_EQ(gridded.contains(q), star.contains(q));
+            ASSERT_EQ(gridded.isBoundary(q), star.isBoundary(q));
+            xs.push_back(q.x);
+            ys.push_back(q.y);
+            expected.push_back(star.isBoundary(q) ? Location::BOUNDARY
+                                                  : (star.contains(q) ? Location::INSIDE : Location::OUTSIDE));
+        }
+
+        // Batches from several threads at once
+        std::vector<std::vector<Location>> results(4, std::vector<Location>(queries.size()));
+        std::vector<std::thread> threads;
+        for (auto& result : results)
+            threads.emplace_back([&] { gridded.locate(xs.data(), ys.data(), xs.size(), result.data()); });
+        for (auto& thread : threads)
+            thread.join();
+        for (const auto& result : results)
+            ASSERT_EQ(result == expected, true);
+
+        gridded.add(Point(1e6, -3e5 - 50));
+        ASSERT_EQ(gridded.grid() == nullptr, true);
+    }
+}
+
+void TestPolygonProperties() {
+    // L-shape turning left at its first three vertices but clockwise overall
+    Polygon shape({Point(0, 0), Point(0, 4), Point(2, 4), Point(2, 2), Point(4, 2), Point(4, 0)});
+    ASSERT_EQ(ccw(shape.vertices()[0], shape.vertices()[1], shape.vertices()[2]) == Direction::CW, true);
+    ASSERT_EQ(shape.orientation() == Direction::CW, true);
+    ASSERT_EQ(shape.area(), 12.0);
+    ASSERT_EQ(shape.perimeter(), 16.0);
+    ASSERT_EQ(shape.centroid(), Point(5.0 / 3, 5.0 / 3));
+    const BoundingBox& box = shape.boundingBox();
+    ASSERT_EQ(box.minX == 0 && box.minY == 0 && box.maxX == 4 && box.maxY == 4, true);
+    ASSERT_EQ(shape.contains(Point(5, 1)), false);
+    ASSERT_EQ(shape.isBoundary(Point(-1, 0)), false);
+    ASSERT_EQ(shape.contains(Point(4, 1)), true);
+    std::vector<Point> reversed(shape.vertices().rbegin(), shape.vertices().rend());
+    ASSERT_EQ(Polygon(reversed).orientation() == Direction::CCW, true);
+
+    // Random stars grown vertex by vertex give bit for bit the answers of polygons built at once
+    std::mt19937 rng(25);
+    std::uniform_real_distribution<double> unit(0, 1);
+    for (int round = 0; round < 50; ++round) {
+        const size_t n = 3 + rng() % 200;
+        std::vector<Point> vertices;
+        for (size_t i = 0; i < n; ++i) {
+            double angle = 2 * M_PI * (i + 0.5 * unit(rng)) / n, r = 1 + 1000 * unit(rng);
+            vertices.emplace_back(5e5 + r * std::cos(angle), -2e5 + r * std::sin(angle));
+        }
+        if (round % 2)
+            std::reverse(vertices.begin(), vertices.end());
+        Polygon grown(std::vector<Point>(vertices.begin(), vertices.begin() + 3));
+        grown.area();
+        Polygon unread = grown;
+        for (size_t i = 3; i < n; ++i) {
+            grown.add(vertices[i]);
+            unread.add(vertices[i]);
+            Polygon fresh(std::vector<Point>(vertices.begin(), vertices.begin() + i + 1));
+            ASSERT_EQ(grown.area(), fresh.area());
+            ASSERT_EQ(grown.perimeter(), fresh.perimeter());
+            ASSERT_EQ(grown.centroid(), fresh.centroid());
+            ASSERT_EQ(grown.orientation() == fresh.orientation(), true);
+            const BoundingBox& a = grown.boundingBox();
+            const BoundingBox b(fresh.vertices());
+            ASSERT_EQ(a.minX == b.minX && a.minY == b.minY && a.maxX == b.maxX && a.maxY == b.maxY, true);
+        }
+        ASSERT_EQ(unread.area(), grown.area());
+        ASSERT_EQ(grown.orientation() == (round % 2 ? Direction::CW : Direction::CCW), true);
+
+        // Against the textbook formulas, in absolute coordinates
+        double area = 0, perimeter = 0, cx = 0, cy = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const Point& p = vertices[i];
+            const Point& q = vertices[(i + 1) % n];
+            const double c = cross(p, q);
+            area += c;
+            cx += (p.x + q.x) * c;
+            cy += (p.y + q.y) * c;
+            perimeter += distance(p, q);
+        }
+        ASSERT_EQ(std::abs(grown.area() - std::abs(area) / 2) <= 1e-6 * grown.area(), true);
+        ASSERT_EQ(std::abs(grown.perimeter() - perimeter) <= 1e-12 * perimeter, true);
+        ASSERT_EQ(distance(grown.centroid(), Point(cx / (3 * area), cy / (3 * area))) <= 1e-3, true);
+        PolygonView view(vertices.data(), n);
+        ASSERT_EQ(view.area(), grown.area());
+        ASSERT_EQ(view.perimeter(), grown.perimeter());
+    }
+
+    // First use from several threads at once, half of them reading through copies taken meanwhile
+    Polygon shared(reversed);
+    std::vector<double> areas(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < areas.size(); ++t) {
+        threads.emplace_back([&, t] {
+            if (t % 2) {
+                Polygon copy = shared;
+                copy = shared;
+                areas[t] = copy.area() + copy.boundingBox().maxX;
+            } else {
+                areas[t] = shared.area() + shared.boundingBox().maxX;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (double area : areas)
+        ASSERT_EQ(area, 16.0);
+}
+
+
+void TestSegmentIntersectionsNearDegenerate() {
+    // Segments through one point, moved by about 1e-12: their crossings are distinct but closer than rounding
+    for (int n : {7, 20, 40}) {
+        for (unsigned seed = 1; seed <= 100; ++seed) {
+            std::mt19937 rng(seed);
+            std::uniform_real_distribution<double> unit(-1, 1);
+            Point center(10 * unit(rng), 10 * unit(rng));
+            std::vector<Segment> segments;
+            for (int i = 0; i < n; ++i) {
+                double angle = 3.2 * unit(rng);
+                double back = 1 + 0.5 * unit(rng), forth = 1 + 0.5 * unit(rng);
+                Point d(std::cos(angle), std::sin(angle));
+                Point a(center.x - back * d.x + 1e-12 * unit(rng), center.y - back * d.y + 1e-12 * unit(rng));
+                Point b(center.x + forth * d.x + 1e-12 * unit(rng), center.y + forth * d.y + 1e-12 * unit(rng));
+                segments.emplace_back(a, b);
+            }
+
+            std::set<std::pair<size_t, size_t>> expected;
+            for (size_t i = 0; i < segments.size(); ++i)
+                for (size_t j = i + 1; j < segments.size(); ++j)
+                    if (intersects(segments[i], segments[j]))
+                        expected.emplace(i, j);
+
+            std::set<std::pair<size_t, size_t>> found;
+            for (const auto& r : calculateIntersections(segments))
+                ASSERT_EQ(found.emplace(r.first, r.second).second, true);
+            ASSERT_EQ(found == expected, true);
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+#include <stdexcept>
+#include "Point.h"
+#include "Polygon.h"
+#include "Ring.h"
+
+namespace lgm {
+    /*
+     * Simple polygon over BasicPoint<T>, for coordinates that fit in a float or an integer grid: half the memory of
+     * Polygon for float and int32_t. Vertices are checked, and area(), perimeter(), contains() and isBoundary()
+     * computed, by the ring kernels of Polygon (see Ring.h) with the exact ccw() of T.
+     * Polygon remains the full version, with indexes, batched locate() and the algorithms built on it.
+     */
+    template<typename T>
+    class BasicPolygon {
+    public:
+        explicit BasicPolygon(std::vector<BasicPoint<T>> vertices) : vertices_(std::move(vertices)) {
+            detail::checkRing(vertices_.data(), vertices_.size());
+        }
+
+        double area() const {
+            return detail::ringArea(vertices_.data(), vertices_.size());
+        }
+
+        double perimeter() const {
+            return detail::ringPerimeter(vertices_.data(), vertices_.size());
+        }
+
+        bool contains(const BasicPoint<T>& p) const {
+            return locate(p) != Location::OUTSIDE;
+        }
+
+        bool isBoundary(const BasicPoint<T>& p) const {
+            return locate(p) == Location::BOUNDARY;
+        }
+
+        virtual Location locate(const BasicPoint<T>& p) const {
+            return detail::ringLocate(vertices_.data(), vertices_.size(), p);
+        }
+
+        const std::vector<BasicPoint<T>>& vertices() const { return vertices_; }
+        size_t size() const { return vertices_.size(); }
+
+        virtual ~BasicPolygon() = default;
+    protected:
+        std::vector<BasicPoint<T>> vertices_;
+    };
+
+    // Convex BasicPolygon, located in O(logN) by a binary search over the fan of triangles around the first vertex
+    template<typename T>
+    class BasicConvexPolygon : public BasicPolygon<T> {
+    public:
+        explicit BasicConvexPolygon(std::vector<BasicPoint<T>> vertices) : BasicPolygon<T>(std::move(vertices)) {
+            const auto& v = this->vertices_;
+            turn_ = ccw(v[0], v[1], v[2]);
+            for (size_t i = 0; i < v.size(); ++i)
+                if (ccw(v[i], v[(i + 1) % v.size()], v[(i + 2) % v.size()]) != turn_)
+                    throw std::logic_error("ConvexPolygon is not convex.");
+            // Turning the same way at every vertex, the boundary could still wind around more than once
+            for (size_t i = 1; i + 1 < v.size(); ++i)
+                if (ccw(v[0], v[i], v[i + 1]) != turn_)
+                    throw std::logic_error("ConvexPolygon is not convex.");
+        }
+
+        Location locate(const BasicPoint<T>& p) const override {
+            const auto& v = this->vertices_;
+            const size_t n = v.size();
+            const Direction outward = opposite(turn_);
+            Direction first = ccw(v[0], v[1], p), last = ccw(v[0], v[n - 1], p);
+            if (first == outward || last == turn_)
+                return Location::OUTSIDE;
+            // Last fan edge v[0] -> v[lo] that p does not lie beyond
+            size_t lo = 1, hi = n - 1;
+            while (hi - lo > 1) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (ccw(v[0], v[mid], p) == outward)
+                    hi = mid;
+                else
+                    lo = mid;
+            }
+            Direction side = ccw(v[lo], v[hi], p);
+            if (side == outward)
+                return Location::OUTSIDE;
+            if (side == Direction::COLLINEAR || (lo == 1 && first == Direction::COLLINEAR) ||
+                (hi == n - 1 && last == Direction::COLLINEAR))
+                return Location::BOUNDARY;
+            return Location::INSIDE;
+        }
+    private:
+        Direction turn_;
+    };
+}
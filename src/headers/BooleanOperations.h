@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+#include "Polygon.h"
+
+namespace lgm {
+    enum class BooleanOperation {
+        UNION, INTERSECTION, DIFFERENCE
+    };
+
+    /*
+     * Union, intersection or difference (a minus b) of two simple polygons, in O((N + K) logN) for K edge crossings.
+     * The result is a set of rings, each one a Polygon: counter-clockwise rings bound it from outside, clockwise ones
+     * are holes, so a point belongs to the result when the rings around it wind once counter-clockwise.
+     * Rings touching at a vertex are returned separately; edges shared by both polygons are handled exactly.
+     * Crossing points are rounded like calculateIntersection() rounds them.
+     */
+    std::vector<Polygon> booleanOperation(const Polygon& a, const Polygon& b, BooleanOperation operation);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+#include "Point.h"
+
+namespace lgm {
+    /*
+     * Axis-aligned bounding box, closed on all sides.
+     * A default constructed box is empty: it contains nothing and add() turns it into the box of the added point.
+     */
+    struct BoundingBox {
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+
+        BoundingBox();
+        BoundingBox(double minX, double minY, double maxX, double maxY);
+        explicit BoundingBox(const std::vector<Point>&);
+
+        void add(const Point&);
+        void add(const BoundingBox&);
+
+        bool empty() const;
+        bool contains(const Point&) const;
+        bool intersects(const BoundingBox&) const;
+        Point center() const;
+        // Euclidean distance from p to the closest point of the box, 0 if p is inside
+        double distance(const Point& p) const;
+    };
+}
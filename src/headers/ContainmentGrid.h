@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Point.h"
+
+namespace lgm {
+    enum class Location;
+
+    /*
+     * Uniform grid over the bounding box of a polygon, for point location on huge, static polygons.
+     * Every cell touched by an edge is a boundary cell: it keeps those edges and a reference point of known location.
+     * Every other cell is classified INSIDE or OUTSIDE at construction. A point in a classified cell is located with
+     * one array lookup, a point in a boundary cell by the parity of the edges of the cell crossing the segment from
+     * the reference point. The answers are exactly those of Polygon::contains()/isBoundary().
+     * The grid does not own the vertices: it is built for and queried with the same vertex array. It is never
+     * modified after construction, so any number of threads may query it at once.
+     */
+    class ContainmentGrid {
+    public:
+        /*
+         * Picks square cells as small as the memory budget allows, with the memory counted as memoryUsage() does.
+         * Throws std::invalid_argument when not even a single row of cells fits
+         */
+        ContainmentGrid(const std::vector<Point>& vertices, size_t memoryBudget);
+
+        Location locate(const std::vector<Point>& vertices, const Point& p) const;
+
+        size_t columns() const;
+        size_t rows() const;
+        // Number of cells touched by an edge
+        size_t boundaryCells() const;
+        // Time spent in the constructor, in seconds
+        double buildTime() const;
+        // Heap memory held by the grid, in bytes
+        size_t memoryUsage() const;
+    private:
+        // Values of cells_ for the classified cells; any other value is an index into offsets_
+        static const uint32_t INSIDE = UINT32_MAX;
+        static const uint32_t OUTSIDE = UINT32_MAX - 1;
+
+        size_t column(double x) const;
+        size_t row(double y) const;
+        // Candidate reference point k of a cell, k = 0 being its centre
+        Point candidate(size_t row, size_t column, uint32_t k) const;
+        bool listed(size_t cell, uint32_t edge) const;
+        /*
+         * Parity of the number of edges of boundary cell id, except those listed in cell skip, that cross the segment
+         * from r to p; neither r nor p may lie on an edge
+         */
+        bool crossings(const std::vector<Point>& vertices, uint32_t id, const Point& r, const Point& p,
+                       size_t skip = SIZE_MAX) const;
+
+        double minX_;
+        double minY_;
+        double maxX_;
+        double maxY_;
+        double cellSize_;
+        size_t columns_;
+        size_t rows_;
+        std::vector<uint32_t> cells_;       // row-major
+        std::vector<uint32_t> offsets_;     // edges of boundary cell i are edges_[offsets_[i], offsets_[i + 1])
+        std::vector<uint32_t> edges_;       // ascending within a cell
+        std::vector<uint8_t> references_;   // per boundary cell: candidate of the reference point << 1 | inside
+        double buildTime_;
+    };
+}
@@ -3,6 +3,14 @@
 #include "Polygon.h"
 
 namespace lgm {
+    // Rectangle in any orientation, corners in counter-clockwise order
+    struct OrientedRectangle {
+        Point corners[4];
+
+        double area() const;
+        double perimeter() const;
+    };
+
     class ConvexPolygon : public Polygon {
     public:
         explicit ConvexPolygon(std::vector<Point>);
@@ -11,14 +19,77 @@ namespace lgm {
         bool contains(const Point &point) const override;
         bool isBoundary(const Point &point) const override;
 
+        /*
+         * Sorts the points by angle around the pivot and merges them against the wedges in one sweep,
+         * so a batch of M points costs O(N + M log M) instead of M binary searches.
+         * Batches much larger than the polygon are swept in chunks of 4N points
+         */
+        void locate(const double* x, const double* y, size_t count, Location* result) const override;
+
         void add(const Point &point) override;
+
+        /*
+         * Rotating calipers, O(N) over the ordered vertices without allocating.
+         * diameter() is the farthest pair of vertices, width() the least distance between two parallel lines
+         * enclosing the polygon. The smallest enclosing rectangles, by area and by perimeter, have a side along
+         * an edge of the polygon (Freeman-Shapira, Toussaint), so only N candidates are compared.
+         */
+        Segment diameter() const;
+        double width() const;
+        OrientedRectangle minimumAreaRectangle() const;
+        OrientedRectangle minimumPerimeterRectangle() const;
+
+        friend bool intersection(const ConvexPolygon&, const ConvexPolygon&, ConvexPolygon&);
+        friend ConvexPolygon intersection(const ConvexPolygon&, const ConvexPolygon&);
+        friend void minkowskiSum(const ConvexPolygon&, const ConvexPolygon&, ConvexPolygon&);
+        friend ConvexPolygon minkowskiSum(const ConvexPolygon&, const ConvexPolygon&);
     private:
+        // Strictly convex vertices produced by the operations below
+        ConvexPolygon(std::vector<Point>, Unchecked);
+        void assign(std::vector<Point>& vertices);
+
         /*
          * While Polygon determines vertex position in O(N), ConvexPolygon can do this in O(logN) using binary search
-         * with O(N) pre-processing step
+         * with O(N) pre-processing step.
+         * Wedge i is the angle between rays pivot->vertices_[i] and pivot->vertices_[i + 1]; vertices are ordered by
+         * angle starting at vertices_[0], the ones in [secondHalf_, N) lie more than a half-turn away from it.
+         * Only orientation tests are used, no trigonometry.
          */
         void calculateWedges();
-        std::vector<double> wedges_;
+        int half(const Point& p) const;
+        // Wedge of p, with the number of binary search probes in steps when it is given
+        size_t wedge(const Point& p, size_t* steps = nullptr) const;
+        Location locate(size_t wedge, const Point& p) const;
+        void sweep(const double* x, const double* y, size_t first, size_t last,
+                   std::vector<std::pair<double, size_t>>& order, Location* result) const;
+
+        Point pivot_;
+        Direction turn_;
+        size_t secondHalf_;
     };
     ConvexPolygon ModifiedGrahamScan(const std::vector<Point>& origin);
-}
\ No newline at end of file
+
+    /*
+     * Same hull as ModifiedGrahamScan, computed by threads workers (0 means one per hardware thread).
+     * Points strictly inside the Akl-Toussaint octagon are discarded first, then every worker sorts and hulls
+     * its own chunk and the small partial hulls are merged.
+     */
+    ConvexPolygon ParallelConvexHull(const std::vector<Point>& origin, size_t threads = 0);
+
+    /*
+     * Intersection of two convex polygons in O(N + M), chasing the edges of both boundaries (O'Rourke et al.).
+     * The result is counter-clockwise and has no collinear vertices; it is not validated again.
+     * The first version throws std::logic_error when the polygons share no interior (disjoint, or touching along
+     * a vertex or an edge). The second one returns false then and leaves result unchanged; it reuses the vertex
+     * storage of result and a per-thread buffer, so a loop over many pairs stops allocating once both have grown.
+     */
+    ConvexPolygon intersection(const ConvexPolygon& a, const ConvexPolygon& b);
+    bool intersection(const ConvexPolygon& a, const ConvexPolygon& b, ConvexPolygon& result);
+
+    /*
+     * Minkowski sum {p + q : p in a, q in b} in O(N + M), merging the edges of both polygons by angle.
+     * Counter-clockwise, no collinear vertices; the second version reuses storage like intersection() does.
+     */
+    ConvexPolygon minkowskiSum(const ConvexPolygon& a, const ConvexPolygon& b);
+    void minkowskiSum(const ConvexPolygon& a, const ConvexPolygon& b, ConvexPolygon& result);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <set>
+#include <vector>
+#include "ConvexPolygon.h"
+
+namespace lgm {
+    /*
+     * Convex hull of a growing point set.
+     * The lower and upper chains of Andrew's monotone chain are kept in lexicographically ordered sets, so
+     * add() finds the neighbours of a new point in O(logN) and erases the vertices it covers (amortized O(logN)),
+     * and contains()/isBoundary() stay valid between insertions at O(logN) per query.
+     * polygon() gives the same vertex order as ModifiedGrahamScan over all added points.
+     */
+    class DynamicConvexHull {
+    public:
+        DynamicConvexHull();
+        explicit DynamicConvexHull(const std::vector<Point>&);
+
+        // Returns true if the point became a vertex of the hull
+        bool add(const Point&);
+
+        bool contains(const Point&) const;
+        bool isBoundary(const Point&) const;
+
+        std::vector<Point> vertices() const;
+        ConvexPolygon polygon() const;
+        size_t size() const;
+    private:
+        class Chain {
+        public:
+            explicit Chain(Direction turn);
+
+            bool add(const Point&);
+            // CCW/CW: p is on the inner/outer side of the chain, COLLINEAR: p lies on it
+            Direction side(const Point&) const;
+
+            const std::set<Point>& points() const;
+        private:
+            std::set<Point> points_;
+            Direction turn_;
+        };
+
+        Location locate(const Point&) const;
+
+        Chain lower_;
+        Chain upper_;
+    };
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Predicates.h"
+
+/*
+ * Instrumentation of the hot paths, compiled in only when LGM_METRICS is defined (cmake -DLGEOMETRY_METRICS=ON).
+ * Without it the hooks below expand to nothing, metricsEnabled() is false and every snapshot is zero.
+ *
+ * Every thread records into a sink of its own with plain relaxed loads and stores, no locks and no shared cache
+ * lines; metricsSnapshot() sums the sinks of the running threads and of the ones that have exited.
+ */
+namespace lgm {
+    enum class Operation {
+        POLYGON_CONTAINS,           // Polygon::contains(), with or without the index
+        CONVEX_POLYGON_CONTAINS,    // ConvexPolygon::contains()
+        MODIFIED_GRAHAM_SCAN
+    };
+    constexpr size_t OPERATION_COUNT = 3;
+
+    /*
+     * Reading the clock costs more than a small query, so every thread times only the first of every
+     * LATENCY_SAMPLING calls of an operation; everything else is counted on every call
+     */
+    constexpr uint64_t LATENCY_SAMPLING = 16;
+
+    /*
+     * Latencies in nanoseconds, bucket 0 for 0 ns and bucket i for [2^(i-1), 2^i) ns; the last bucket also takes
+     * everything longer
+     */
+    struct LatencyHistogram {
+        static const size_t BUCKETS = 40;
+        uint64_t counts[BUCKETS];
+
+        static size_t bucket(uint64_t nanoseconds);
+        uint64_t total() const;
+        // Upper end of the bucket that holds the q-quantile, 0 for an empty histogram
+        uint64_t quantile(double q) const;
+    };
+
+    /*
+     * Totals for one operation. The predicate counts include everything the operation does (for a hull, the
+     * construction of the ConvexPolygon too): ccw() calls on Point, how many of them found the points collinear
+     * and how many the floating-point filter could not decide.
+     */
+    struct OperationMetrics {
+        uint64_t calls;
+        uint64_t exceptions;            // calls that left by an exception
+        uint64_t predicates;
+        uint64_t collinear;
+        uint64_t exactFallbacks;
+        uint64_t edges;                 // edges tested by Polygon::contains() without the index
+        uint64_t searchSteps;           // binary search probes of ConvexPolygon::contains()
+        uint64_t nanoseconds;           // total over the timed calls
+        LatencyHistogram latency;       // of the timed calls
+    };
+
+    struct MetricsSnapshot {
+        OperationMetrics operations[OPERATION_COUNT];
+
+        const OperationMetrics& operator[](Operation operation) const;
+        // One object per operation, keyed by operationName(), with the histogram as an array of bucket counts
+        std::string toJson() const;
+    };
+
+    constexpr bool metricsEnabled() {
+#ifdef LGM_METRICS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    const char* operationName(Operation operation);
+
+    // Everything recorded since the start of the program or the last resetMetrics(), over all threads
+    MetricsSnapshot metricsSnapshot();
+    void resetMetrics();
+
+    namespace detail {
+        /*
+         * Times one call of an operation and attributes to it the predicates evaluated by its thread meanwhile.
+         * Nested scopes each count the inner work.
+         */
+        class MetricsScope {
+        public:
+            explicit MetricsScope(Operation operation);
+            ~MetricsScope();
+            MetricsScope(const MetricsScope&) = delete;
+            MetricsScope& operator=(const MetricsScope&) = delete;
+
+            void edges(uint64_t count);
+            void searchSteps(uint64_t count);
+        private:
+            Operation operation_;
+            int exceptions_;
+            bool timed_;
+            uint64_t start_;
+            PredicateTally predicates_;
+        };
+    }
+}
+
+#ifdef LGM_METRICS
+#define LGM_METRICS_SCOPE(operation) ::lgm::detail::MetricsScope lgmMetricsScope(operation)
+#define LGM_METRICS_EDGES(count) lgmMetricsScope.edges(count)
+#define LGM_METRICS_SEARCH_STEPS(count) lgmMetricsScope.searchSteps(count)
+#else
+#define LGM_METRICS_SCOPE(operation) ((void)0)
+#define LGM_METRICS_EDGES(count) ((void)0)
+#define LGM_METRICS_SEARCH_STEPS(count) ((void)0)
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace lgm {
+    namespace detail {
+        /*
+         * Threads for count items of which each thread should get at least grain: the requested number, or one per
+         * hardware thread when it is 0, but never more than count / grain and never less than 1
+         */
+        inline size_t threadCount(size_t requested, size_t count, size_t grain) {
+            if (requested == 0)
+                requested = std::max(1u, std::thread::hardware_concurrency());
+            return std::min(requested, std::max<size_t>(1, count / grain));
+        }
+
+        // Runs func(t) for t in [0, threads), func(0) on the calling thread, and returns when all of them have
+        template<typename Func>
+        void parallelFor(size_t threads, Func func) {
+            std::vector<std::thread> workers;
+            workers.reserve(threads - 1);
+            for (size_t t = 1; t < threads; ++t)
+                workers.emplace_back(func, t);
+            func(0);
+            for (auto& worker : workers)
+                worker.join();
+        }
+    }
+}
@@ -1,55 +1,208 @@
 #pragma once
 
+#include <cmath>
 #include <functional>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "Predicates.h"
 
+/*
+ * Everything on Point is defined here, inline, so that loops over points compile down to arithmetic in every
+ * translation unit and can be vectorized, without link-time optimization.
+ */
 namespace lgm {
 
-    struct Point {
-        double x;
-        double y;
+    /*
+     * Point with coordinates of type T. Everything in the library works on Point, the double version; the
+     * other instantiations are compact storage for coordinates that fit in float or in an integer grid, with
+     * exact predicates of their own (see ccw() below) and BasicSegment, BasicPolygon and BasicConvexPolygon.
+     */
+    template<typename T>
+    struct BasicPoint {
+        T x;
+        T y;
 
-        explicit Point(double _x = 0, double _y = 0);
+        constexpr explicit BasicPoint(T _x = 0, T _y = 0) : x(_x), y(_y) {}
     };
 
+    using Point = BasicPoint<double>;
+
     enum class Direction {
         CCW, COLLINEAR, CW
     };
 
     /*
     * CCW returns direction of of the p relatively to segment pq
+    * The result is exact for any finite coordinates (see orient2d() in Predicates.h). The floating-point filter of
+    * orient2d() is evaluated here; only the rare points it cannot decide pay for the call
     */
-    Direction ccw(const Point &p, const Point &q, const Point &r);
+    inline Direction ccw(const Point &p, const Point &q, const Point &r) {
+        double detLeft = (p.x - r.x) * (q.y - r.y);
+        double detRight = (p.y - r.y) * (q.x - r.x);
+        double det = detLeft - detRight;
+#ifdef LGM_METRICS
+        detail::PredicateTally& tally = detail::ThreadPredicates<>::tally;
+        tally.calls++;
+        if (!(std::fabs(det) >= ORIENT2D_ERRBOUND * (std::fabs(detLeft) + std::fabs(detRight)))) {
+            tally.exactFallbacks++;
+            det = orient2d(p, q, r);
+        }
+        tally.collinear += det == 0;
+#else
+        if (!(std::fabs(det) >= ORIENT2D_ERRBOUND * (std::fabs(detLeft) + std::fabs(detRight))))
+            det = orient2d(p, q, r);
+#endif
+        return (det > 0 ? Direction::CCW : (det < 0 ? Direction::CW : Direction::COLLINEAR));
+    }
+
+    constexpr Direction opposite(Direction direction) {
+        return direction == Direction::CCW ? Direction::CW
+                                           : (direction == Direction::CW ? Direction::CCW : Direction::COLLINEAR);
+    }
 
-    double distance(const Point &lhs, const Point &rhs);
+    inline double distance(const Point &lhs, const Point &rhs) {
+        double dx = rhs.x - lhs.x;
+        double dy = rhs.y - lhs.y;
+        return std::sqrt(dx * dx + dy * dy);
+    }
 
-    double dot(const Point &, const Point &);
-    double cross(const Point &, const Point &);
+    constexpr double dot(const Point &lhs, const Point &rhs) {
+        return lhs.x * rhs.x + lhs.y * rhs.y;
+    }
+    constexpr double cross(const Point &lhs, const Point &rhs) {
+        return lhs.x * rhs.y - lhs.y * rhs.x;
+    }
 
-    Point operator*(const double, const Point &);
-    Point operator*(const Point&, const double);
-    Point operator/(const Point&, const double);
-    Point operator+(const Point &, const Point &);
-    Point operator-(const Point &, const Point &);
+    constexpr Point operator*(const double lhs, const Point &rhs) {
+        return Point(lhs * rhs.x, lhs * rhs.y);
+    }
+    constexpr Point operator*(const Point &lhs, const double rhs) {
+        return Point(lhs.x * rhs, lhs.y * rhs);
+    }
+    constexpr Point operator/(const Point &lhs, const double rhs) {
+        return Point(lhs.x / rhs, lhs.y / rhs);
+    }
 
-    bool operator==(const Point &, const Point &);
-    bool operator!=(const Point &, const Point &);
-    bool operator< (const Point &, const Point &);
-    bool operator<=(const Point &, const Point &);
-    bool operator> (const Point &, const Point &);
-    bool operator>=(const Point &, const Point &);
+    // For every coordinate type
+    template<typename T>
+    constexpr BasicPoint<T> operator+(const BasicPoint<T>& lhs, const BasicPoint<T>& rhs) {
+        return BasicPoint<T>(lhs.x + rhs.x, lhs.y + rhs.y);
+    }
+    template<typename T>
+    constexpr BasicPoint<T> operator-(const BasicPoint<T>& lhs, const BasicPoint<T>& rhs) {
+        return BasicPoint<T>(lhs.x - rhs.x, lhs.y - rhs.y);
+    }
+
+    template<typename T>
+    constexpr bool operator==(const BasicPoint<T>& lhs, const BasicPoint<T>& rhs) {
+        return lhs.x == rhs.x && lhs.y == rhs.y;
+    }
+    template<typename T>
+    constexpr bool operator!=(const BasicPoint<T>& lhs, const BasicPoint<T>& rhs) {
+        return !(lhs == rhs);
+    }
+    // Lexicographic, as std::tie(x, y) compares
+    template<typename T>
+    constexpr bool operator<(const BasicPoint<T>& lhs, const BasicPoint<T>& rhs) {
+        return lhs.x < rhs.x || (!(rhs.x < lhs.x) && lhs.y < rhs.y);
+    }
+    template<typename T>
+    constexpr bool operator<=(const BasicPoint<T>& lhs, const BasicPoint<T>& rhs) {
+        return !(rhs < lhs);
+    }
+    template<typename T>
+    constexpr bool operator>(const BasicPoint<T>& lhs, const BasicPoint<T>& rhs) {
+        return rhs < lhs;
+    }
+    template<typename T>
+    constexpr bool operator>=(const BasicPoint<T>& lhs, const BasicPoint<T>& rhs) {
+        return !(lhs < rhs);
+    }
 
     /*
      * CCW returns 1 if r is on the right side of the pq
      *             0 if r is collinear with pq
      *             -1 if r is on the left side of the pq
      */
+
+    namespace detail {
+        // Finalizer of MurmurHash3: every bit of h changes every bit of the result with probability about 1/2
+        inline uint64_t mix64(uint64_t h) {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        // Bit pattern of v, with -0.0 taken as 0.0 since the two compare equal
+        inline uint64_t bits(double v) {
+            v = v == 0 ? 0.0 : v;
+            uint64_t result;
+            std::memcpy(&result, &v, sizeof(result));
+            return result;
+        }
+
+        // Strictly increasing function of the polar angle of d, in [0, 4); d must not be zero
+        inline double pseudoAngle(const Point& d) {
+            double p = d.x / (std::fabs(d.x) + std::fabs(d.y));
+            return d.y < 0 ? 3 + p : 1 - p;
+        }
+
+        template<typename T, bool = std::is_integral<T>::value>
+        struct Orientation {
+            // float coordinates convert to double exactly, and ccw() is exact on any doubles
+            static Direction ccw(const BasicPoint<T>& p, const BasicPoint<T>& q, const BasicPoint<T>& r) {
+                return lgm::ccw(Point(p.x, p.y), Point(q.x, q.y), Point(r.x, r.y));
+            }
+            // (a - o) x (b - o), rounded
+            static double cross(const BasicPoint<T>& a, const BasicPoint<T>& b, const BasicPoint<T>& o) {
+                return (double(a.x) - o.x) * (double(b.y) - o.y) - (double(a.y) - o.y) * (double(b.x) - o.x);
+            }
+        };
+
+#ifdef __SIZEOF_INT128__
+        template<typename T>
+        struct Orientation<T, true> {
+            static_assert(sizeof(T) <= 8, "Integer coordinates of up to 64 bits are supported.");
+        public:
+            static Direction ccw(const BasicPoint<T>& p, const BasicPoint<T>& q, const BasicPoint<T>& r) {
+                Wide det = exact(q, r, p);
+                return det > 0 ? Direction::CCW : (det < 0 ? Direction::CW : Direction::COLLINEAR);
+            }
+            static double cross(const BasicPoint<T>& a, const BasicPoint<T>& b, const BasicPoint<T>& o) {
+                return static_cast<double>(exact(a, b, o));
+            }
+        private:
+            using Wide = __int128;
+            static Wide exact(const BasicPoint<T>& a, const BasicPoint<T>& b, const BasicPoint<T>& o) {
+                return (Wide(a.x) - o.x) * (Wide(b.y) - o.y) - (Wide(a.y) - o.y) * (Wide(b.x) - o.x);
+            }
+        };
+#endif
+    }
+
+    /*
+     * Exact orientation for the other coordinate types. Integer determinants are multiplied out in 128 bits:
+     * exact for int32_t, and for int64_t as long as every coordinate is below 2^62 in absolute value. Compilers
+     * without __int128 (e.g. MSVC) convert integers to double instead, exact for coordinates below 2^53
+     */
+    template<typename T>
+    Direction ccw(const BasicPoint<T>& p, const BasicPoint<T>& q, const BasicPoint<T>& r) {
+        return detail::Orientation<T>::ccw(p, q, r);
+    }
 }
 
 namespace std {
     template<>
     struct hash<lgm::Point> {
+        // Hashes the bit patterns of both coordinates, so fractional and negative values spread as well as integers
         std::size_t operator()(const lgm::Point& point) const {
-            return point.x + 31 * point.y;
+            using lgm::detail::mix64;
+            using lgm::detail::bits;
+            return static_cast<std::size_t>(mix64(bits(point.x) ^ mix64(bits(point.y) + 0x9e3779b97f4a7c15ULL)));
         }
     };
 }
\ No newline at end of file
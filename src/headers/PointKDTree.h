@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "BoundingBox.h"
+#include "Point.h"
+
+namespace lgm {
+    /*
+     * Static 2-d tree over a set of points.
+     * The points are copied and reordered so that every subtree is a contiguous range: the root of range [lo, hi)
+     * is its median at lo + (hi - lo) / 2, split along the wider side of the range, with the left and right halves
+     * on either side of it. Nodes are implicit, the only per-node data is the split axis; ranges of at most LEAF
+     * points are scanned linearly.
+     * Queries return indices into the input vector; ties in distance go to the smaller index. All queries are const
+     * and may run concurrently; the batched versions split the queries between threads workers (0 means one per
+     * hardware thread).
+     */
+    class PointKDTree {
+    public:
+        explicit PointKDTree(const std::vector<Point>& points);
+
+        // Up to k points closest to p, closest first
+        std::vector<size_t> nearest(const Point& p, size_t k) const;
+        // Points at distance at most radius from p, in ascending order
+        std::vector<size_t> withinRadius(const Point& p, double radius) const;
+        // Points inside box (boundary included), in ascending order
+        std::vector<size_t> inside(const BoundingBox& box) const;
+        // Two distinct points at the least distance, smaller index first; throws std::logic_error for fewer than 2
+        std::pair<size_t, size_t> closestPair() const;
+
+        std::vector<std::vector<size_t>> nearest(const std::vector<Point>& queries, size_t k,
+                                                 size_t threads = 0) const;
+        std::vector<std::vector<size_t>> withinRadius(const std::vector<Point>& queries, double radius,
+                                                      size_t threads = 0) const;
+
+        size_t size() const;
+        // Time spent building the tree, in seconds
+        double buildTime() const;
+        // Heap memory held by the tree, in bytes
+        size_t memoryUsage() const;
+    private:
+        static const size_t LEAF = 8;
+
+        void build(size_t lo, size_t hi, std::vector<uint32_t>& order, const std::vector<Point>& points);
+        template<typename Visit>
+        void search(const BoundingBox& box, Visit&& visit) const;
+        // Closest point to p other than the one at position self, if it is closer than best (squared distance)
+        void nearestOther(size_t self, double& best, size_t& other) const;
+
+        std::vector<Point> points_;     // in tree order
+        std::vector<uint32_t> ids_;     // index of points_[i] in the input
+        std::vector<uint8_t> axes_;     // split axis of the node whose median is points_[i], 0 for x and 1 for y
+        double buildTime_;
+    };
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Point.h"
+
+namespace lgm {
+    enum class Location;
+
+    /*
+     * Precomputed point location structure for a simple polygon.
+     * Edges are stored in a segment tree over the horizontal slabs between distinct vertex y coordinates; every
+     * tree node keeps the edges spanning its whole y range sorted from left to right, so the number of edges
+     * crossed by the horizontal ray of Polygon::contains is counted with one binary search per level.
+     * Query takes O(log^2 N), memory is O(N log N) 32-bit edge indices.
+     * The index does not own the vertices: it is built for and queried with the same vertex array.
+     */
+    class PointLocationIndex {
+    public:
+        explicit PointLocationIndex(const std::vector<Point>& vertices);
+
+        Location locate(const std::vector<Point>& vertices, const Point& p) const;
+
+        // Time spent in the constructor, in seconds
+        double buildTime() const;
+        // Heap memory held by the index, in bytes
+        size_t memoryUsage() const;
+    private:
+        std::vector<double> ys_;              // distinct vertex y coordinates, ascending
+        size_t leaves_;                       // number of segment tree leaves, power of two
+        std::vector<uint32_t> nodeOffsets_;   // edges of node v are edges_[nodeOffsets_[v], nodeOffsets_[v + 1])
+        std::vector<uint32_t> edges_;         // edge i goes from vertices[i] to vertices[(i + 1) % N]
+        std::vector<uint32_t> horizontal_;    // horizontal edges sorted by (y, min x)
+        std::vector<uint32_t> sortedVertices_;
+        double buildTime_;
+    };
+}
@@ -1,32 +1,208 @@
 #pragma once
 
 #include <vector>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include "Point.h"
 #include "Segment.h"
+#include "BoundingBox.h"
+#include "PointLocationIndex.h"
+#include "ContainmentGrid.h"
 
 namespace lgm {
+    enum class Location {
+        INSIDE, BOUNDARY, OUTSIDE
+    };
+
+    /*
+     * Edges of a polygon, seen through its vertex array: edge i goes from vertices[i] to vertices[(i + 1) % N].
+     * Edges are not stored anywhere, the view yields them by value and is invalidated with the vertex array. Its
+     * iterator is an input iterator only: dereferencing yields a temporary, not a reference into a sequence.
+     */
+    class EdgeView {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Segment;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Segment*;
+            using reference = Segment;
+
+            iterator(const std::vector<Point>* vertices, size_t i) : vertices_(vertices), i_(i) {}
+
+            Segment operator*() const {
+                return Segment((*vertices_)[i_], (*vertices_)[i_ + 1 == vertices_->size() ? 0 : i_ + 1]);
+            }
+            iterator& operator++() { ++i_; return *this; }
+            iterator operator++(int) { iterator old = *this; ++i_; return old; }
+            bool operator==(const iterator& rhs) const { return i_ == rhs.i_; }
+            bool operator!=(const iterator& rhs) const { return i_ != rhs.i_; }
+        private:
+            const std::vector<Point>* vertices_;
+            size_t i_;
+        };
+
+        explicit EdgeView(const std::vector<Point>& vertices) : vertices_(&vertices) {}
+
+        Segment operator[](size_t i) const { return *iterator(vertices_, i); }
+        Segment front() const { return (*this)[0]; }
+        Segment back() const { return (*this)[size() - 1]; }
+        size_t size() const { return vertices_->size(); }
+        bool empty() const { return vertices_->empty(); }
+
+        iterator begin() const { return iterator(vertices_, 0); }
+        iterator end() const { return iterator(vertices_, size()); }
+    private:
+        const std::vector<Point>* vertices_;
+    };
+
+    // Two edges of a ring, first < second; edge i goes from vertices[i] to vertices[(i + 1) % N]
+    struct EdgePair {
+        size_t first;
+        size_t second;
+    };
+
+    enum class Validation {
+        // 3 or more vertices, no three consecutive collinear
+        BASIC,
+        // and isSimple(), in O(NlogN)
+        SIMPLE
+    };
+
     class Polygon {
     public:
         explicit Polygon(std::vector<Point>);
         explicit Polygon(const std::vector<Segment>&);
+        // Throws std::invalid_argument naming two offending edges when validation is SIMPLE and the ring is not
+        Polygon(std::vector<Point>, Validation);
 
+        // A copy takes the cached properties with std::atomic_load, as other threads may be setting them
+        Polygon(const Polygon&);
+        Polygon& operator=(const Polygon&);
+        Polygon(Polygon&&) = default;
+        Polygon& operator=(Polygon&&) = default;
+
+        /*
+         * Derived properties are computed together in one pass over the vertices on first use, then cached and kept
+         * up to date by add() in O(1). The cache is safe to fill from several threads at once.
+         */
         double area() const;
         double perimeter() const;
+        // Axis-aligned bounding box of the vertices; contains() and isBoundary() reject points outside it first
+        const BoundingBox& boundingBox() const;
+        // Centre of mass of the enclosed region
+        Point centroid() const;
+        // CW or CCW, exact: the turn at the lowest (min x, then min y) vertex
+        Direction orientation() const;
 
         virtual bool contains(const Point&) const;
         virtual bool isBoundary(const Point&) const;
 
+        /*
+         * Batch version of contains()/isBoundary() for points given as separate x[] and y[] arrays.
+         * Writes BOUNDARY, INSIDE or OUTSIDE for each of the count points into result and gives exactly the same
+         * answers as the single point methods. The crossing-number kernel is vectorized with AVX2/SSE2 when available.
+         */
+        virtual void locate(const double* x, const double* y, size_t count, Location* result) const;
+
         virtual void add(const Point&);
 
+        /*
+         * Precomputes a PointLocationIndex so contains(), isBoundary() and locate() run in O(log^2 N) instead of O(N).
+         * The index is shared between copies of the polygon and dropped by add().
+         */
+        void buildIndex();
+        void dropIndex();
+        const PointLocationIndex* index() const;
+
+        /*
+         * Precomputes a ContainmentGrid of at most memoryBudget bytes, for large polygons that do not change:
+         * contains(), isBoundary() and locate() then answer most points with one lookup. The grid takes precedence
+         * over the index, is shared between copies of the polygon and dropped by add().
+         */
+        void buildGrid(size_t memoryBudget);
+        void dropGrid();
+        const ContainmentGrid* grid() const;
+
         const std::vector<Point>& vertices() const;
-        const std::vector<RefSegment>& edges() const;
+        EdgeView edges() const;
         size_t size() const;
+
+        // See lgm::isSimple() below
+        bool isSimple(EdgePair* offending = nullptr) const;
+
+        /*
+         * x coordinate of the far end of the horizontal ray used by the crossing-number test. It must lie left of
+         * every polygon; the predicates are exact, so this far out it only needs coordinates below 1e150
+         */
+        static constexpr double RAY_ORIGIN_X = -1e150;
     protected:
+        // For vertices that are valid by construction: at least 3 of them, no three consecutive collinear
+        struct Unchecked {};
+        Polygon(std::vector<Point>, Unchecked);
+
+        /*
+         * Sums over all edges but the closing one, taken relative to vertices_[0]: the closing edge adds nothing to
+         * the area and centroid terms there, so add() only has to extend the sums by the edge to the new vertex
+         */
+        struct Properties {
+            double signedArea2;     // twice the signed area
+            double centroidX;       // 6 * signed area * centroid
+            double centroidY;
+            double openPerimeter;
+            BoundingBox boundingBox;
+            size_t lowest;
+
+            Properties(const Point* vertices, size_t size);
+            void extend(const Point& origin, const Point& a, const Point& b);
+        };
+        const Properties& properties() const;
+        // For changes of the vertices other than add()
+        void dropProperties();
+
         std::vector<Point> vertices_;
-        std::vector<RefSegment> edges_;
-        bool isClockwise;
+        /*
+         * Set once on first use through the std::atomic_* functions for shared_ptr, so const methods may race to set
+         * it; every read that can overlap with that, copies included, goes through std::atomic_load
+         */
+        mutable std::shared_ptr<Properties> properties_;
+        std::shared_ptr<const PointLocationIndex> index_;
+        std::shared_ptr<const ContainmentGrid> grid_;
+    };
+
+    /*
+     * Read-only polygon over vertices owned by someone else, e.g. a memory-mapped PolygonStore.
+     * Nothing is copied or allocated; area(), perimeter(), contains() and isBoundary() give exactly the answers of
+     * Polygon built from the same vertices. The vertices must outlive the view.
+     */
+    class PolygonView {
+    public:
+        PolygonView(const Point* vertices, size_t size);
+
+        double area() const;
+        double perimeter() const;
+
+        bool contains(const Point&) const;
+        bool isBoundary(const Point&) const;
+
+        const Point& operator[](size_t i) const { return vertices_[i]; }
+        const Point* begin() const { return vertices_; }
+        const Point* end() const { return vertices_ + size_; }
+        size_t size() const { return size_; }
+    private:
+        const Point* vertices_;
+        size_t size_;
     };
 
     bool isConvex(const std::vector<lgm::Point> &);
+
+    /*
+     * Whether no two edges of the ring meet, except consecutive ones at their common vertex. Consecutive edges are
+     * checked in one pass, the others with a Shamos-Hoey sweep in O(NlogN) that stops at the first pair it finds
+     * meeting; that pair goes to offending when it is given. Exact, like ccw().
+     */
+    bool isSimple(const std::vector<Point>& vertices, EdgePair* offending = nullptr);
     Point calculateInsidePoint(const std::vector<Point>&);
-}
\ No newline at end of file
+}
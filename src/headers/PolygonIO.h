@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Point.h"
+#include "Polygon.h"
+#include "ConvexPolygon.h"
+
+namespace lgm {
+    enum class GeometryFormat {
+        WKT, GEOJSON
+    };
+
+    /*
+     * Streaming reader of polygons in WKT or GeoJSON.
+     * WKT input is a sequence of POLYGON and MULTIPOLYGON texts (Z/M coordinates are dropped). GeoJSON input is any
+     * JSON: every Polygon and MultiPolygon geometry found in it, e.g. inside a FeatureCollection, is read; everything
+     * else is skipped. Each polygon of a multipolygon is read as a separate polygon, polygons with holes are rejected.
+     * The closing vertex of a ring is dropped.
+     * Input is read in chunks, so files of any size take constant memory. Coordinates are parsed straight into
+     * buffers that are reused from polygon to polygon; polygon() and convexPolygon() allocate only the vertex array.
+     * Malformed input throws std::invalid_argument with the byte offset of the error.
+     */
+    class PolygonReader {
+    public:
+        PolygonReader(std::istream& in, GeometryFormat format, size_t chunkSize = 1 << 16);
+        // The buffer is read in place and must outlive the reader
+        PolygonReader(const char* data, size_t size, GeometryFormat format);
+
+        // Moves to the next polygon, false at the end of input
+        bool next();
+
+        // Vertices of the current polygon, valid until the next call of next()
+        const std::vector<Point>& vertices() const;
+        Polygon polygon(Validation validation = Validation::BASIC) const;
+        ConvexPolygon convexPolygon() const;
+
+        // Bytes of input consumed so far
+        size_t offset() const;
+    private:
+        struct Frame {
+            bool object;
+            size_t count;
+            std::string type;
+            bool coordinates;
+            int depth;
+            size_t maxRings;
+            size_t points;
+            size_t rings;
+        };
+
+        bool refill();
+        int peek();
+        int get();
+        void skipWhitespace();
+        void expect(char c);
+        [[noreturn]] void fail(const std::string& message) const;
+
+        double readNumber();
+        void readString(std::string& result);
+        void readWord(std::string& result);
+
+        bool parseWkt();
+        void parseWktPolygon();
+        void parseWktRing();
+
+        bool parseGeoJson();
+        void parseGeoJsonValue(Frame* parent);
+        int parseCoordinates(Frame& frame, int level);
+        void closeGeoJsonObject();
+
+        void endRing(size_t start);
+
+        std::istream* in_;
+        GeometryFormat format_;
+        std::vector<char> chunk_;
+        const char* begin_;
+        const char* pos_;
+        const char* end_;
+        size_t consumed_;
+
+        // Rings parsed so far; the first ready_ are outer rings of complete polygons, handed out from next_
+        std::vector<Point> points_;
+        std::vector<size_t> rings_;
+        size_t ready_;
+        size_t next_;
+        std::vector<Point> vertices_;
+
+        // Open GeoJSON objects and arrays are stack_[0, depth_), frames are reused to keep their strings' capacity
+        std::vector<Frame> stack_;
+        size_t depth_;
+        std::string key_;
+        std::string token_;
+    };
+
+    /*
+     * Writes polygons as one WKT POLYGON per line, or as a GeoJSON FeatureCollection with one Feature per polygon.
+     * Coordinates are written so that they read back to the same double: in fixed notation with the fewest decimals
+     * when that takes at most 15 of them, otherwise with 17 significant digits.
+     * The FeatureCollection is completed by close() or by the destructor.
+     */
+    class PolygonWriter {
+    public:
+        PolygonWriter(std::ostream& out, GeometryFormat format);
+        ~PolygonWriter();
+
+        PolygonWriter(const PolygonWriter&) = delete;
+        PolygonWriter& operator=(const PolygonWriter&) = delete;
+
+        void write(const Polygon& polygon);
+        void write(const PolygonView& polygon);
+        void close();
+    private:
+        void write(const Point* vertices, size_t size);
+        void number(double value);
+
+        std::ostream& out_;
+        GeometryFormat format_;
+        size_t count_;
+        bool closed_;
+        std::string line_;
+    };
+
+    std::vector<Polygon> readPolygons(std::istream& in, GeometryFormat format);
+    void writePolygons(std::ostream& out, const std::vector<Polygon>& polygons, GeometryFormat format);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include "BoundingBox.h"
+#include "Polygon.h"
+#include "ConvexPolygon.h"
+
+namespace lgm {
+    /*
+     * Static R-tree over the bounding boxes of a collection of polygons.
+     * The tree is bulk loaded: polygons are sorted by the Hilbert index of their box centers and packed bottom-up,
+     * four children per node. A node keeps its children boxes in single precision, rounded outwards, so it fills
+     * exactly one 64-byte cache line; exact boxes are checked at the leaves.
+     * Queries return indices into the collection the tree was built from, in ascending order. The tree refers to the
+     * polygons without copying them, so they must outlive it and must not change. All queries are const and may run
+     * concurrently from any number of threads.
+     */
+    class PolygonRTree {
+    public:
+        explicit PolygonRTree(const std::vector<const Polygon*>& polygons);
+        explicit PolygonRTree(const std::vector<Polygon>& polygons);
+        explicit PolygonRTree(const std::vector<ConvexPolygon>& polygons);
+
+        // Polygons for which contains(p) holds, boundary included
+        std::vector<size_t> containing(const Point& p) const;
+        // Polygons whose bounding box intersects box
+        std::vector<size_t> overlapping(const BoundingBox& box) const;
+        // Up to k polygons closest to p (distance 0 for polygons containing p), closest first; ties by index
+        std::vector<size_t> nearest(const Point& p, size_t k) const;
+
+        size_t size() const;
+        // Time spent building the tree, in seconds
+        double buildTime() const;
+        // Heap memory held by the tree, in bytes
+        size_t memoryUsage() const;
+    private:
+        static const size_t FANOUT = 4;
+        static const size_t CACHE_LINE = 64;
+
+        struct alignas(CACHE_LINE) Node {
+            float minX[FANOUT];
+            float minY[FANOUT];
+            float maxX[FANOUT];
+            float maxY[FANOUT];
+        };
+
+        // std::allocator does not honour alignas beyond max_align_t before C++17
+        template<typename T>
+        struct CacheLineAllocator {
+            using value_type = T;
+            CacheLineAllocator() = default;
+            template<typename U>
+            CacheLineAllocator(const CacheLineAllocator<U>&) {}
+
+            T* allocate(size_t n) {
+                char* raw = static_cast<char*>(::operator new(n * sizeof(T) + CACHE_LINE));
+                char* aligned = raw + CACHE_LINE - reinterpret_cast<uintptr_t>(raw) % CACHE_LINE;
+                reinterpret_cast<char**>(aligned)[-1] = raw;
+                return reinterpret_cast<T*>(aligned);
+            }
+            void deallocate(T* p, size_t) {
+                ::operator delete(reinterpret_cast<char**>(p)[-1]);
+            }
+            template<typename U>
+            bool operator==(const CacheLineAllocator<U>&) const { return true; }
+            template<typename U>
+            bool operator!=(const CacheLineAllocator<U>&) const { return false; }
+        };
+
+        void build();
+        template<typename Visit>
+        void search(const BoundingBox& box, Visit&& visit) const;
+
+        std::vector<const Polygon*> polygons_;  // in tree order
+        std::vector<BoundingBox> boxes_;        // exact box of polygons_[i]
+        std::vector<uint32_t> ids_;             // index of polygons_[i] in the input
+        // Levels bottom-up, the children of node j are the slots 4j..4j+3 of the level below (or of polygons_)
+        std::vector<Node, CacheLineAllocator<Node>> nodes_;
+        std::vector<size_t> levels_;            // level l occupies nodes_[levels_[l], levels_[l + 1])
+        double buildTime_;
+    };
+}
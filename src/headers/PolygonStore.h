@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Point.h"
+#include "Polygon.h"
+
+namespace lgm {
+    /*
+     * Binary file of a polygon collection, laid out to be memory mapped and used in place:
+     *
+     *   header     64 bytes: magic "LGMPOLY", version, byte order mark, polygon and vertex counts,
+     *              offsets of the sections below, checksum of the sections, checksum of the header itself
+     *   vertices   x, y doubles of every polygon, one polygon after another
+     *   offsets    uint64 per polygon + 1: polygon i owns vertices [offsets[i], offsets[i + 1])
+     *
+     * Numbers are stored in the byte order of the machine that wrote the file; other machines refuse to open it.
+     */
+    class PolygonStoreWriter {
+    public:
+        explicit PolygonStoreWriter(const std::string& path);
+        // Finishes the file if close() was not called; errors are lost then
+        ~PolygonStoreWriter();
+
+        PolygonStoreWriter(const PolygonStoreWriter&) = delete;
+        PolygonStoreWriter& operator=(const PolygonStoreWriter&) = delete;
+
+        void add(const std::vector<Point>& vertices);
+        void add(const Polygon& polygon);
+        // Writes the offsets and the header; the file is complete only after this
+        void close();
+    private:
+        void write(const void* data, size_t bytes);
+
+        std::string path_;
+        std::ofstream out_;
+        std::vector<uint64_t> offsets_;
+        uint64_t checksum_;
+        bool closed_;
+    };
+
+    /*
+     * Read-only memory mapping of a file written by PolygonStoreWriter.
+     * Opening checks the header and the file size only, so it takes the same time for any file size; pages are read
+     * by the OS when polygons touch them. verify() reads everything to check the data checksum.
+     * Views returned by operator[] point into the mapping and are valid while the store lives. The store is
+     * immutable, all methods may run concurrently.
+     */
+    class PolygonStore {
+    public:
+        explicit PolygonStore(const std::string& path);
+        ~PolygonStore();
+
+        PolygonStore(PolygonStore&&) noexcept;
+        PolygonStore& operator=(PolygonStore&&) noexcept;
+        PolygonStore(const PolygonStore&) = delete;
+        PolygonStore& operator=(const PolygonStore&) = delete;
+
+        PolygonView operator[](size_t i) const;
+        size_t size() const;
+        size_t vertexCount() const;
+        bool verify() const;
+
+        static void write(const std::string& path, const std::vector<Polygon>& polygons);
+    private:
+        void unmap();
+
+        const char* data_;
+        size_t bytes_;
+        const Point* vertices_;
+        const uint64_t* offsets_;
+        size_t size_;
+        size_t vertexCount_;
+    };
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+
+namespace lgm {
+    template<typename T>
+    struct BasicPoint;
+    using Point = BasicPoint<double>;
+
+    /*
+     * Adaptive exact orientation test (J. R. Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast
+     * Robust Geometric Predicates").
+     * Returns a value whose sign is the exact sign of (b - a) x (c - a): positive if c is to the left of ab,
+     * negative if it is to the right and zero if the three points are collinear. The value itself is only an
+     * approximation of the determinant.
+     * The plain floating-point determinant is returned when its error bound proves the sign; otherwise the
+     * result is refined with expansion arithmetic, exactly in the worst case.
+     */
+    double orient2d(const Point& a, const Point& b, const Point& c);
+
+    /*
+     * Error bound of the floating-point filter: with detLeft = (a.x - c.x) * (b.y - c.y),
+     * detRight = (a.y - c.y) * (b.x - c.x) and det = detLeft - detRight, the sign of det is exact when
+     * |det| >= ORIENT2D_ERRBOUND * (|detLeft| + |detRight|).
+     * ccw() and vectorized code evaluate the same expressions inline and call orient2d() only when they fail the bound.
+     */
+    constexpr double ORIENT2D_ERRBOUND = (3.0 + 16.0 / (1ull << 53)) / (1ull << 53);
+
+    /*
+     * Exact predicates on the crossing point X of the lines through p, q and through r, s, which must not be
+     * parallel. X has rational coordinates and is never rounded: the filters evaluate the expressions in floating
+     * point with a running error bound and fall back to expansion arithmetic when they cannot prove the sign.
+     */
+    /*
+     * X rounded to x, with X.x within x.x +- error.x and X.y within x.y +- error.y, for comparisons that can do
+     * without the exact predicates below. False when the lines are too close to parallel for a bound
+     */
+    bool approximateCrossing(const Point& p, const Point& q, const Point& r, const Point& s, Point& x, Point& error);
+    // Sign of X - c in lexicographic (x, then y) order: -1, 0 or 1
+    int compareCrossing(const Point& p, const Point& q, const Point& r, const Point& s, const Point& c);
+    // Sign of X - Y in lexicographic order, Y being the crossing point of the lines through t, u and v, w
+    int compareCrossings(const Point& p, const Point& q, const Point& r, const Point& s,
+                         const Point& t, const Point& u, const Point& v, const Point& w);
+    // Sign of (b - a) x (X - a), as orient2d(a, b, X)
+    int orient2dCrossing(const Point& a, const Point& b, const Point& p, const Point& q, const Point& r,
+                         const Point& s);
+
+    /*
+     * Number of orient2d() calls, since the start of the program or the last reset, that could not be decided by
+     * the floating-point filter (adaptive) and that needed the fully exact determinant (exact).
+     * The counters are shared between threads.
+     */
+    struct PredicateCounters {
+        uint64_t adaptive;
+        uint64_t exact;
+    };
+
+    PredicateCounters predicateCounters();
+    void resetPredicateCounters();
+
+    namespace detail {
+        // ccw() calls made by one thread, counted only with LGM_METRICS (see Metrics.h)
+        struct PredicateTally {
+            uint64_t calls;
+            uint64_t collinear;
+            uint64_t exactFallbacks;
+        };
+
+        /*
+         * A static member of a template is defined, constant-initialized, in every translation unit, so ccw() reaches
+         * it without the call to the initialization wrapper that an extern thread_local variable costs
+         */
+        template<typename = void>
+        struct ThreadPredicates {
+            static thread_local PredicateTally tally;
+        };
+
+        template<typename Unused>
+        thread_local PredicateTally ThreadPredicates<Unused>::tally = {0, 0, 0};
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include "Point.h"
+#include "Segment.h"
+#include "Polygon.h"
+
+namespace lgm {
+    namespace detail {
+        /*
+         * Ring kernels shared by Polygon, PolygonView and BasicPolygon<T>; edge i goes from v[i] to v[(i + 1) % n].
+         * Every coordinate type runs the same code, so all of them give the answers of Polygon over the same vertices.
+         */
+
+        // At least 3 vertices, no three consecutive collinear; throws as the Polygon constructor documents
+        template<typename T>
+        void checkRing(const BasicPoint<T>* v, size_t n) {
+            if (n < 3)
+                throw std::logic_error("Polygon must have 3 or more vertices. "
+                                       "Number of vertices provided: " + std::to_string(n));
+            for (size_t i = 0; i < n; ++i)
+                if (ccw(v[i], v[(i + 1) % n], v[(i + 2) % n]) == Direction::COLLINEAR)
+                    throw std::invalid_argument("Three consecutive collinear points are not supported yet.");
+        }
+
+        // Cross products relative to v[0], summed in the order Polygon::Properties sums them
+        template<typename T>
+        double ringArea(const BasicPoint<T>* v, size_t n) {
+            double area = 0;
+            for (size_t i = 0; i + 1 < n; ++i)
+                area += Orientation<T>::cross(v[i], v[i + 1], v[0]);
+            return std::abs(area) / 2;
+        }
+
+        template<typename T>
+        double edgeLength(const BasicPoint<T>& a, const BasicPoint<T>& b) {
+            double dx = double(b.x) - double(a.x), dy = double(b.y) - double(a.y);
+            return std::sqrt(dx * dx + dy * dy);
+        }
+
+        template<typename T>
+        double ringPerimeter(const BasicPoint<T>* v, size_t n) {
+            double perimeter = 0;
+            for (size_t i = 0; i + 1 < n; ++i)
+                perimeter += edgeLength(v[i], v[i + 1]);
+            return perimeter + edgeLength(v[n - 1], v[0]);
+        }
+
+        /*
+         * Crossing number: an edge with p.y in (min y, max y] crosses the horizontal ray left of p when p lies right
+         * of it, walking the edge upwards. edges, when given, receives the number of edges tested
+         */
+        template<typename T>
+        Location ringLocate(const BasicPoint<T>* v, size_t n, const BasicPoint<T>& p, size_t* edges = nullptr) {
+            size_t crossings = 0;
+            const BasicPoint<T>* a = &v[n - 1];
+            for (const BasicPoint<T>* b = v; b != v + n; ++b) {
+                Direction turn = ccw(*a, *b, p);
+                if (turn == Direction::COLLINEAR && onSegment(*a, *b, p)) {
+                    if (edges)
+                        *edges = b - v + 1;
+                    return Location::BOUNDARY;
+                }
+                if ((a->y < p.y) != (b->y < p.y) && turn == (a->y < b->y ? Direction::CW : Direction::CCW))
+                    ++crossings;
+                a = b;
+            }
+            if (edges)
+                *edges = n;
+            return crossings % 2 == 1 ? Location::INSIDE : Location::OUTSIDE;
+        }
+
+        template<typename T>
+        bool ringIsBoundary(const BasicPoint<T>* v, size_t n, const BasicPoint<T>& p) {
+            const BasicPoint<T>* a = &v[n - 1];
+            for (const BasicPoint<T>* b = v; b != v + n; ++b) {
+                if (ccw(*a, *b, p) == Direction::COLLINEAR && onSegment(*a, *b, p))
+                    return true;
+                a = b;
+            }
+            return false;
+        }
+    }
+}
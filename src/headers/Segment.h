@@ -1,12 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include "Point.h"
 
 namespace lgm {
     class AbstractSegment {
     public:
-        double length() const;
+        double length() const { return distance(start(), end()); }
 
         virtual Point& start() = 0;
         virtual Point& end() = 0;
@@ -15,27 +16,31 @@ namespace lgm {
         virtual const Point& end() const = 0;
     };
 
-    struct Segment : public AbstractSegment {
+    /*
+     * Segment and RefSegment are final and their accessors are defined here, so calls through them are resolved
+     * and inlined at compile time; only code holding an AbstractSegment goes through the virtual table.
+     */
+    struct Segment final : public AbstractSegment {
     public:
-        Point &start() override;
-        Point &end() override;
-        const Point &start() const override;
-        const Point &end() const override;
+        Point &start() override { return start_; }
+        Point &end() override { return end_; }
+        const Point &start() const override { return start_; }
+        const Point &end() const override { return end_; }
 
-        explicit Segment(Point _start = Point(), Point _end = Point());
+        explicit Segment(Point _start = Point(), Point _end = Point()) : start_(_start), end_(_end) {}
     private:
         Point start_;
         Point end_;
     };
 
-    struct RefSegment : public AbstractSegment {
+    struct RefSegment final : public AbstractSegment {
     public:
-        RefSegment(Point& start, Point& end);
+        RefSegment(Point& start, Point& end) : start_(start), end_(end) {}
 
-        Point &start() override;
-        Point &end() override;
-        const Point &start() const override;
-        const Point &end() const override;
+        Point &start() override { return start_; }
+        Point &end() override { return end_; }
+        const Point &start() const override { return start_; }
+        const Point &end() const override { return end_; }
 
     private:
         Point& start_;
@@ -55,6 +60,59 @@ namespace lgm {
     bool operator<=(const AbstractSegment &, const AbstractSegment &);
     bool operator> (const AbstractSegment &, const AbstractSegment &);
     bool operator>=(const AbstractSegment &, const AbstractSegment &);
+
+    /*
+     * Segment tests on the endpoints, for every coordinate type. The functions above and the BasicSegment ones below
+     * are both written in terms of these.
+     */
+    // r is assumed collinear with pq and only checked against its bounding box
+    template<typename T>
+    bool onSegment(const BasicPoint<T>& p, const BasicPoint<T>& q, const BasicPoint<T>& r) {
+        return r.x <= std::max(p.x, q.x) && r.x >= std::min(p.x, q.x) &&
+               r.y <= std::max(p.y, q.y) && r.y >= std::min(p.y, q.y);
+    }
+
+    // Whether segments pq and rs share a point, exact
+    template<typename T>
+    bool intersects(const BasicPoint<T>& p, const BasicPoint<T>& q, const BasicPoint<T>& r, const BasicPoint<T>& s) {
+        Direction o1 = ccw(p, q, r);
+        Direction o2 = ccw(p, q, s);
+        Direction o3 = ccw(r, s, p);
+        Direction o4 = ccw(r, s, q);
+
+        if (o1 == Direction::COLLINEAR && onSegment(p, q, r)) return true;
+        if (o2 == Direction::COLLINEAR && onSegment(p, q, s)) return true;
+        if (o3 == Direction::COLLINEAR && onSegment(r, s, p)) return true;
+        if (o4 == Direction::COLLINEAR && onSegment(r, s, q)) return true;
+
+        return o1 != o2 && o3 != o4;
+    }
+
+    // Segment between BasicPoints of any coordinate type, without virtual accessors: two points and nothing else
+    template<typename T>
+    struct BasicSegment {
+    public:
+        explicit BasicSegment(BasicPoint<T> _start = BasicPoint<T>(), BasicPoint<T> _end = BasicPoint<T>())
+                : start_(_start), end_(_end) {}
+
+        BasicPoint<T>& start() { return start_; }
+        BasicPoint<T>& end() { return end_; }
+        const BasicPoint<T>& start() const { return start_; }
+        const BasicPoint<T>& end() const { return end_; }
+    private:
+        BasicPoint<T> start_;
+        BasicPoint<T> end_;
+    };
+
+    template<typename T>
+    bool onSegment(const BasicSegment<T>& pq, const BasicPoint<T>& r) {
+        return onSegment(pq.start(), pq.end(), r);
+    }
+
+    template<typename T>
+    bool intersects(const BasicSegment<T>& lhs, const BasicSegment<T>& rhs) {
+        return intersects(lhs.start(), lhs.end(), rhs.start(), rhs.end());
+    }
 }
 
 namespace std {
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include "Segment.h"
+
+namespace lgm {
+    struct SegmentIntersection {
+        // Indices of the intersecting segments in the input, first < second
+        size_t first;
+        size_t second;
+        // Common part of the two segments: a single point (start() == end()) or the overlap of collinear segments
+        Segment intersection;
+    };
+
+    /*
+     * Reports every pair of intersecting segments - the pairs for which intersects() holds - in O((N + K) logN)
+     * using a Bentley-Ottmann sweep, where K is the number of reported pairs.
+     * Shared endpoints and segments touching another one are reported at the touching point, collinear overlaps
+     * are reported once with their common segment. Crossing points are computed like calculateIntersection().
+     * The callback is invoked in sweep order (lexicographic by intersection point).
+     */
+    void calculateIntersections(const std::vector<Segment>& segments,
+                                const std::function<void(const SegmentIntersection&)>& callback);
+    std::vector<SegmentIntersection> calculateIntersections(const std::vector<Segment>& segments);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include "Polygon.h"
+
+namespace lgm {
+    enum class Simplification {
+        // tolerance is a distance: every removed vertex lies within it of the edge that replaces it
+        DOUGLAS_PEUCKER,
+        // tolerance is an area: vertices go in order of the triangle they form with their neighbours
+        VISVALINGAM_WHYATT
+    };
+
+    /*
+     * Polygon made of a subset of the vertices of polygon, in the same order, with the detail below tolerance
+     * removed. The result is always simple: the vertices are ranked once (Douglas-Peucker in O(NlogN) expected,
+     * Visvalingam-Whyatt with a heap in O(NlogN)), the ones above tolerance are kept, and while a Bentley-Ottmann
+     * sweep finds edges crossing each other the best ranked vertex under each of them is put back.
+     * Vertices left collinear with their neighbours are dropped at the end.
+     */
+    Polygon simplify(const Polygon& polygon, double tolerance,
+                     Simplification method = Simplification::DOUGLAS_PEUCKER);
+
+    /*
+     * Levels of detail of one polygon, one per tolerance, from a single ranking of its vertices.
+     * Level i is simplify(polygon, tolerance(i), method); the tolerances are kept in increasing order.
+     */
+    class PolygonLevels {
+    public:
+        PolygonLevels(const Polygon& polygon, std::vector<double> tolerances,
+                      Simplification method = Simplification::DOUGLAS_PEUCKER);
+
+        size_t size() const;
+        const Polygon& operator[](size_t i) const;
+        double tolerance(size_t i) const;
+        // Coarsest level simplified with at most the given tolerance, or the polygon itself when there is none
+        const Polygon& forTolerance(double tolerance) const;
+    private:
+        Polygon original_;
+        std::vector<double> tolerances_;
+        std::vector<Polygon> levels_;
+    };
+}
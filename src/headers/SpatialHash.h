@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Point.h"
+
+namespace lgm {
+    /*
+     * Points bucketed by the cells of a uniform grid, in an open-addressing hash table of cells (linear probing,
+     * at most half full). Points of one cell are linked through an index array, so the whole container is the
+     * points themselves, 4 bytes per point for the links and 8 bytes per table slot: the key of a cell is read
+     * back from its first point.
+     * With cellSize 0 every distinct point is a cell of its own and only exact matches are looked up.
+     * Otherwise find() and insertUnique() accept any eps up to cellSize and look at the few cells around p,
+     * O(1) expected time for points that are not piled up in one cell. Points are indexed in insertion order;
+     * up to 2^32 - 1 of them.
+     */
+    class SpatialHash {
+    public:
+        static const size_t NONE = SIZE_MAX;
+
+        explicit SpatialHash(double cellSize = 0, size_t expected = 0);
+
+        // Adds p even if an equal point is already there and returns its index
+        size_t insert(const Point& p);
+        // Index of the first point within eps of p (distance <= eps), or NONE
+        size_t find(const Point& p, double eps = 0) const;
+        bool containsWithin(const Point& p, double eps = 0) const;
+        // find(p, eps), adding p when there is no such point
+        size_t insertUnique(const Point& p, double eps = 0);
+
+        const std::vector<Point>& points() const;
+        size_t size() const;
+        double cellSize() const;
+        void reserve(size_t count);
+        void clear();
+        // Heap memory held by the container, in bytes
+        size_t memoryUsage() const;
+    private:
+        // First point of a cell and the high half of the hash of its key
+        struct Slot {
+            uint32_t head;
+            uint32_t tag;
+        };
+        // Cell numbers, or the bits of the coordinates without cells
+        struct Key {
+            uint64_t x;
+            uint64_t y;
+        };
+        static const uint32_t EMPTY = UINT32_MAX;
+
+        int64_t cell(double v) const;
+        Key key(const Point& p) const;
+        size_t slot(const Key& k) const;
+        void rehash(size_t capacity);
+        template<typename Visit>
+        void around(const Point& p, double eps, Visit visit) const;
+
+        double cellSize_;
+        std::vector<Slot> slots_;
+        size_t cells_ = 0;
+        std::vector<Point> points_;
+        std::vector<uint32_t> next_;    // next point in the same cell, EMPTY at the end
+    };
+
+    /*
+     * Points in their original order with every point dropped that lies within eps of one kept before it;
+     * eps 0 removes exact duplicates
+     */
+    std::vector<Point> deduplicate(const std::vector<Point>& points, double eps = 0);
+
+    // Nearest point of the grid of spacing step through the origin
+    Point snap(const Point& p, double step);
+    // Every point snapped to the grid of spacing step, without the duplicates that snapping creates
+    std::vector<Point> snapToGrid(const std::vector<Point>& points, double step);
+}
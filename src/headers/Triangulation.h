@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "Polygon.h"
+
+namespace lgm {
+    // Indices into the vertex array of a polygon, in counter-clockwise order
+    struct Triangle {
+        uint32_t a;
+        uint32_t b;
+        uint32_t c;
+    };
+
+    /*
+     * Splits a simple polygon into N - 2 triangles, whichever way round its vertices go.
+     * Polygons of more than EAR_CLIPPING_LIMIT vertices are cut into y-monotone pieces by a sweep (Lee-Preparata)
+     * and each piece is triangulated with a stack in linear time, O(NlogN) in all. Smaller ones are ear clipped,
+     * testing only reflex vertices against a candidate ear, which is faster at that size.
+     * Only orientation tests on the input vertices are used; no coordinates are copied into the result.
+     */
+    std::vector<Triangle> triangulate(const Polygon& polygon);
+
+    const size_t EAR_CLIPPING_LIMIT = 32;
+    std::vector<Triangle> triangulateMonotone(const Polygon& polygon);
+    std::vector<Triangle> triangulateEarClipping(const Polygon& polygon);
+}
@@ -0,0 +1,371 @@
+//
+// Boolean operations on simple polygons.
+//
+// The edges of both polygons go through the Bentley-Ottmann sweep of calculateIntersections(), which splits them at
+// every crossing and shared piece into sub-edges that meet only at their ends. A sub-edge is either shared by both
+// polygons, or lies entirely inside or outside the other polygon. Walking along a ring, that can only change at a
+// vertex the other boundary passes through, where the wedge of the other polygon there decides it in O(1); point
+// location is needed only to seed a ring that the other boundary never touches. The operation keeps a subset of the
+// sub-edges, oriented so that the result lies on their left, and walks them into rings.
+// Temporary structures are flat arrays linked by 32-bit indices, allocated once per call.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+#include "../headers/BooleanOperations.h"
+#include "../headers/PointLocationIndex.h"
+#include "../headers/SegmentIntersections.h"
+
+namespace {
+    using lgm::Point;
+    using lgm::Segment;
+    using lgm::Direction;
+    using lgm::Location;
+    using lgm::BooleanOperation;
+    using lgm::detail::pseudoAngle;
+
+    const uint32_t NONE = UINT32_MAX;
+
+    class Overlay {
+    public:
+        Overlay(const lgm::Polygon& a, const lgm::Polygon& b);
+
+        std::vector<lgm::Polygon> compute(BooleanOperation operation);
+    private:
+        struct Split {
+            uint32_t edge;
+            Point point;
+        };
+
+        struct SubEdge {
+            Point from;
+            Point to;
+            uint32_t u;
+            uint32_t v;
+            uint32_t polygon;
+            // Index of the sub-edge of the other polygon lying on the same vertices, NONE if there is none
+            uint32_t twin;
+        };
+
+        void split();
+        void numberVertices();
+        void findTwins();
+        void classify(uint32_t polygon);
+        Location locate(const SubEdge& edge);
+        void traceRings(std::vector<lgm::Polygon>& result);
+
+        std::vector<Point> vertices_[2];
+        std::vector<Segment> segments_;
+        size_t firstOfB_;
+
+        // Sub-edges of polygon i are edges_[begin_[i], begin_[i + 1]), in the order of its counter-clockwise ring
+        std::vector<SubEdge> edges_;
+        size_t begin_[3];
+        size_t vertexCount_;
+        // Sub-edge of polygon i entering and leaving vertex v at [i * vertexCount_ + v], NONE if it has none there
+        std::vector<uint32_t> entering_;
+        std::vector<uint32_t> leaving_;
+        std::vector<char> inside_;
+        std::unique_ptr<lgm::PointLocationIndex> index_[2];
+
+        // Kept sub-edges as (u, v) pairs in the result orientation
+        std::vector<uint32_t> from_;
+        std::vector<uint32_t> to_;
+        std::vector<Point> position_;
+    };
+
+    Overlay::Overlay(const lgm::Polygon &a, const lgm::Polygon &b) : vertexCount_(0) {
+        const lgm::Polygon* polygons[] = {&a, &b};
+        for (int i = 0; i < 2; ++i) {
+            vertices_[i] = polygons[i]->vertices();
+            if (polygons[i]->orientation() == Direction::CW)
+                std::reverse(vertices_[i].begin(), vertices_[i].end());
+        }
+        segments_.reserve(vertices_[0].size() + vertices_[1].size());
+        for (const auto& vertices : vertices_) {
+            const Point* p = &vertices.back();
+            for (const Point& q : vertices) {
+                segments_.emplace_back(*p, q);
+                p = &q;
+            }
+        }
+        firstOfB_ = vertices_[0].size();
+        split();
+        numberVertices();
+        findTwins();
+    }
+
+    void Overlay::split() {
+        std::vector<Split> splits;
+        splits.reserve(2 * segments_.size());
+        auto add = [&](size_t edge, const Point& p) {
+            if (p != segments_[edge].start() && p != segments_[edge].end())
+                splits.push_back(Split{static_cast<uint32_t>(edge), p});
+        };
+        lgm::calculateIntersections(segments_, [&](const lgm::SegmentIntersection& intersection) {
+            const Segment& common = intersection.intersection;
+            add(intersection.first, common.start());
+            add(intersection.second, common.start());
+            if (common.end() != common.start()) {
+                add(intersection.first, common.end());
+                add(intersection.second, common.end());
+            }
+        });
+
+        // Along every edge, from its start to its end
+        std::sort(splits.begin(), splits.end(), [&](const Split& lhs, const Split& rhs) {
+            if (lhs.edge != rhs.edge)
+                return lhs.edge < rhs.edge;
+            const Segment& s = segments_[lhs.edge];
+            return s.start() < s.end() ? lhs.point < rhs.point : rhs.point < lhs.point;
+        });
+
+        edges_.reserve(segments_.size() + 2 * splits.size());
+        size_t next = 0;
+        for (size_t edge = 0; edge < segments_.size(); ++edge) {
+            auto polygon = static_cast<uint32_t>(edge < firstOfB_ ? 0 : 1);
+            if (edge == 0 || edge == firstOfB_)
+                begin_[polygon] = edges_.size();
+            Point from = segments_[edge].start();
+            for (; next < splits.size() && splits[next].edge == edge; ++next) {
+                if (splits[next].point == from)
+                    continue;
+                edges_.push_back(SubEdge{from, splits[next].point, 0, 0, polygon, NONE});
+                from = splits[next].point;
+            }
+            edges_.push_back(SubEdge{from, segments_[edge].end(), 0, 0, polygon, NONE});
+        }
+        begin_[2] = edges_.size();
+    }
+
+    void Overlay::numberVertices() {
+        std::vector<std::pair<Point, uint32_t>> ends;
+        ends.reserve(2 * edges_.size());
+        for (uint32_t i = 0; i < edges_.size(); ++i) {
+            ends.emplace_back(edges_[i].from, 2 * i);
+            ends.emplace_back(edges_[i].to, 2 * i + 1);
+        }
+        std::sort(ends.begin(), ends.end(), [](const std::pair<Point, uint32_t>& lhs,
+                                               const std::pair<Point, uint32_t>& rhs) {
+            return lhs.first < rhs.first;
+        });
+        position_.clear();
+        for (size_t i = 0; i < ends.size(); ++i) {
+            if (i == 0 || ends[i].first != ends[i - 1].first)
+                position_.push_back(ends[i].first);
+            auto id = static_cast<uint32_t>(position_.size() - 1);
+            SubEdge& edge = edges_[ends[i].second / 2];
+            (ends[i].second % 2 == 0 ? edge.u : edge.v) = id;
+        }
+        vertexCount_ = position_.size();
+
+        entering_.assign(2 * vertexCount_, NONE);
+        leaving_.assign(2 * vertexCount_, NONE);
+        for (uint32_t i = 0; i < edges_.size(); ++i) {
+            leaving_[edges_[i].polygon * vertexCount_ + edges_[i].u] = i;
+            entering_[edges_[i].polygon * vertexCount_ + edges_[i].v] = i;
+        }
+    }
+
+    void Overlay::findTwins() {
+        // Sub-edges on the same pair of vertices; within one simple polygon there are none
+        std::vector<uint32_t> order(edges_.size());
+        for (uint32_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        auto key = [&](uint32_t i) {
+            return std::make_pair(std::min(edges_[i].u, edges_[i].v), std::max(edges_[i].u, edges_[i].v));
+        };
+        std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+            return key(lhs) < key(rhs);
+        });
+        for (size_t i = 0; i + 1 < order.size(); ++i) {
+            uint32_t x = order[i], y = order[i + 1];
+            if (key(x) == key(y) && edges_[x].polygon != edges_[y].polygon) {
+                edges_[x].twin = y;
+                edges_[y].twin = x;
+            }
+        }
+    }
+
+    /*
+     * Where the boundary leaving w towards p runs relative to a polygon whose counter-clockwise boundary enters w from
+     * prev and leaves it towards next: the interior is the part of the plane swept counter-clockwise from next to prev
+     */
+    Location wedge(const Point& w, const Point& prev, const Point& next, const Point& p) {
+        Direction toNext = ccw(w, next, p), toPrev = ccw(w, prev, p);
+        if ((toNext == Direction::COLLINEAR && lgm::dot(p - w, next - w) > 0) ||
+            (toPrev == Direction::COLLINEAR && lgm::dot(p - w, prev - w) > 0))
+            return Location::BOUNDARY;
+        bool inside = ccw(w, next, prev) == Direction::CCW
+                      ? toNext == Direction::CCW && toPrev == Direction::CW
+                      : !(toPrev == Direction::CCW && toNext == Direction::CW);
+        return inside ? Location::INSIDE : Location::OUTSIDE;
+    }
+
+    void Overlay::classify(uint32_t polygon) {
+        const size_t first = begin_[polygon], count = begin_[polygon + 1] - first;
+        const size_t other = (1 - polygon) * vertexCount_;
+        auto touched = [&](size_t k) {
+            return leaving_[other + edges_[first + k].u] != NONE;
+        };
+        // A start where the other boundary passes; if there is none, the ring lies on one side of it
+        size_t start = 0;
+        while (start < count && !touched(start))
+            ++start;
+        bool inside = false;
+        if (start == count) {
+            start = 0;
+            inside = locate(edges_[first]) == Location::INSIDE;
+        }
+        for (size_t k = 0; k < count; ++k) {
+            size_t i = first + (start + k) % count;
+            const SubEdge& edge = edges_[i];
+            if (edge.twin == NONE && leaving_[other + edge.u] != NONE) {
+                const SubEdge& prev = edges_[entering_[other + edge.u]];
+                const SubEdge& next = edges_[leaving_[other + edge.u]];
+                Location location = wedge(edge.from, prev.from, next.to, edge.to);
+                // Rounded crossing points may leave a sub-edge along the other boundary without a twin
+                if (location == Location::BOUNDARY)
+                    location = locate(edge);
+                inside = location == Location::INSIDE;
+            }
+            inside_[i] = inside;
+        }
+    }
+
+    Location Overlay::locate(const SubEdge& edge) {
+        const std::vector<Point>& other = vertices_[1 - edge.polygon];
+        std::unique_ptr<lgm::PointLocationIndex>& index = index_[1 - edge.polygon];
+        if (!index)
+            index.reset(new lgm::PointLocationIndex(other));
+        Location location = index->locate(other, (edge.from + edge.to) / 2);
+        // The midpoint of a rounded sub-edge may graze the other boundary; a second sample settles it
+        if (location == Location::BOUNDARY)
+            location = index->locate(other, (3 * edge.from + edge.to) / 4);
+        return location == Location::OUTSIDE ? Location::OUTSIDE : Location::INSIDE;
+    }
+
+    std::vector<lgm::Polygon> Overlay::compute(BooleanOperation operation) {
+        inside_.assign(edges_.size(), 0);
+        classify(0);
+        classify(1);
+
+        from_.clear();
+        to_.clear();
+        for (uint32_t i = 0; i < edges_.size(); ++i) {
+            const SubEdge& edge = edges_[i];
+            bool keep = false, reverse = false;
+            if (edge.twin != NONE) {
+                // Shared boundary: the interiors lie on the same side, or on opposite sides of it
+                bool same = edges_[edge.twin].u == edge.u;
+                if (edge.polygon == 0)
+                    keep = same == (operation != BooleanOperation::DIFFERENCE);
+            } else {
+                bool inside = inside_[i] != 0;
+                if (operation == BooleanOperation::UNION)
+                    keep = !inside;
+                else if (operation == BooleanOperation::INTERSECTION)
+                    keep = inside;
+                else
+                    keep = edge.polygon == 0 ? !inside : inside;
+                reverse = operation == BooleanOperation::DIFFERENCE && edge.polygon == 1;
+            }
+            if (keep) {
+                from_.push_back(reverse ? edge.v : edge.u);
+                to_.push_back(reverse ? edge.u : edge.v);
+            }
+        }
+
+        std::vector<lgm::Polygon> result;
+        traceRings(result);
+        return result;
+    }
+
+    void Overlay::traceRings(std::vector<lgm::Polygon> &result) {
+        // Outgoing kept edges of every vertex
+        std::vector<uint32_t> offsets(vertexCount_ + 1, 0);
+        for (uint32_t u : from_)
+            offsets[u + 1]++;
+        for (size_t v = 0; v < vertexCount_; ++v)
+            offsets[v + 1] += offsets[v];
+        std::vector<uint32_t> outgoing(from_.size());
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (uint32_t e = 0; e < from_.size(); ++e)
+            outgoing[fill[from_[e]]++] = e;
+        std::vector<char> used(from_.size(), 0);
+
+        std::vector<Point> ring;
+        for (uint32_t start = 0; start < from_.size(); ++start) {
+            if (used[start])
+                continue;
+            ring.clear();
+            uint32_t e = start;
+            bool closed = false;
+            while (true) {
+                used[e] = 1;
+                ring.push_back(position_[from_[e]]);
+                uint32_t v = to_[e];
+                if (v == from_[start]) {
+                    closed = true;
+                    break;
+                }
+                // Where the result touches itself, the sharpest left turn keeps rings apart
+                Point back = position_[from_[e]] - position_[v];
+                double backAngle = pseudoAngle(back);
+                uint32_t next = NONE;
+                double best = 5;
+                for (uint32_t k = offsets[v]; k < offsets[v + 1]; ++k) {
+                    uint32_t candidate = outgoing[k];
+                    if (used[candidate])
+                        continue;
+                    double turn = backAngle - pseudoAngle(position_[to_[candidate]] - position_[v]);
+                    if (turn <= 0)
+                        turn += 4;
+                    if (turn < best) {
+                        best = turn;
+                        next = candidate;
+                    }
+                }
+                if (next == NONE)
+                    break;
+                e = next;
+            }
+            // Every vertex has as many kept edges coming in as going out, so a walk can only end where it started
+            if (!closed)
+                throw std::logic_error("Boolean operation left a ring open.");
+
+            // Vertices where the boundary goes straight on, left by splitting, are not polygon vertices
+            std::vector<Point> cleaned;
+            cleaned.reserve(ring.size());
+            for (const Point& p : ring) {
+                while (cleaned.size() >= 2 &&
+                       ccw(cleaned[cleaned.size() - 2], cleaned.back(), p) == Direction::COLLINEAR)
+                    cleaned.pop_back();
+                cleaned.push_back(p);
+            }
+            size_t first = 0;
+            bool changed = true;
+            while (changed && cleaned.size() - first >= 3) {
+                changed = false;
+                if (ccw(cleaned[cleaned.size() - 2], cleaned.back(), cleaned[first]) == Direction::COLLINEAR) {
+                    cleaned.pop_back();
+                    changed = true;
+                } else if (ccw(cleaned.back(), cleaned[first], cleaned[first + 1]) == Direction::COLLINEAR) {
+                    ++first;
+                    changed = true;
+                }
+            }
+            cleaned.erase(cleaned.begin(), cleaned.begin() + first);
+            if (cleaned.size() >= 3)
+                result.emplace_back(std::move(cleaned));
+        }
+    }
+}
+
+std::vector<lgm::Polygon> lgm::booleanOperation(const Polygon &a, const Polygon &b, BooleanOperation operation) {
+    return Overlay(a, b).compute(operation);
+}
@@ -0,0 +1,58 @@
+//
+// Axis-aligned bounding box.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../headers/BoundingBox.h"
+
+lgm::BoundingBox::BoundingBox() : minX(std::numeric_limits<double>::infinity()),
+                                  minY(std::numeric_limits<double>::infinity()),
+                                  maxX(-std::numeric_limits<double>::infinity()),
+                                  maxY(-std::numeric_limits<double>::infinity()) {}
+
+lgm::BoundingBox::BoundingBox(double minX, double minY, double maxX, double maxY)
+        : minX(minX), minY(minY), maxX(maxX), maxY(maxY) {}
+
+lgm::BoundingBox::BoundingBox(const std::vector<Point> &points) : BoundingBox() {
+    for (const auto& p : points)
+        add(p);
+}
+
+void lgm::BoundingBox::add(const Point &p) {
+    minX = std::min(minX, p.x);
+    minY = std::min(minY, p.y);
+    maxX = std::max(maxX, p.x);
+    maxY = std::max(maxY, p.y);
+}
+
+void lgm::BoundingBox::add(const BoundingBox &box) {
+    minX = std::min(minX, box.minX);
+    minY = std::min(minY, box.minY);
+    maxX = std::max(maxX, box.maxX);
+    maxY = std::max(maxY, box.maxY);
+}
+
+bool lgm::BoundingBox::empty() const {
+    return minX > maxX || minY > maxY;
+}
+
+bool lgm::BoundingBox::contains(const Point &p) const {
+    return p.x >= minX && p.x <= maxX && p.y >= minY && p.y <= maxY;
+}
+
+bool lgm::BoundingBox::intersects(const BoundingBox &box) const {
+    return box.minX <= maxX && box.maxX >= minX && box.minY <= maxY && box.maxY >= minY;
+}
+
+lgm::Point lgm::BoundingBox::center() const {
+    return Point((minX + maxX) / 2, (minY + maxY) / 2);
+}
+
+double lgm::BoundingBox::distance(const Point &p) const {
+    double dx = std::max({minX - p.x, 0.0, p.x - maxX});
+    double dy = std::max({minY - p.y, 0.0, p.y - maxY});
+    return std::sqrt(dx * dx + dy * dy);
+}
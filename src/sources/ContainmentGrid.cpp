@@ -0,0 +1,261 @@
+//
+// Uniform grid point location for lgm::Polygon.
+//
+// Cells are located with floating-point arithmetic, so every edge is listed in all cells within a small slack of
+// it: a point rounded into a neighbouring cell still finds its edges, and a classified cell is never closer than the
+// slack to an edge. Everything that decides an answer is an exact orientation test on the vertices.
+//
+// Crossings of a segment r-p are counted as if the segment were moved an infinitesimal distance to its right: a vertex
+// on the line through r and p counts as left of it. An edge then crosses the segment when its endpoints are on
+// different sides of that line and r and p on different sides of the edge. As long as neither r nor p lies on an
+// edge, the parity of the crossings tells whether the two are on the same side of the boundary.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+#include "../headers/ContainmentGrid.h"
+#include "../headers/Polygon.h"
+
+const uint32_t lgm::ContainmentGrid::INSIDE;
+const uint32_t lgm::ContainmentGrid::OUTSIDE;
+
+lgm::ContainmentGrid::ContainmentGrid(const std::vector<Point> &vertices, size_t memoryBudget) {
+    auto start = std::chrono::steady_clock::now();
+    const size_t n = vertices.size();
+    if (n < 3)
+        throw std::logic_error("ContainmentGrid requires 3 or more vertices.");
+    if (n >= OUTSIDE)
+        throw std::length_error("ContainmentGrid takes up to 2^32 - 2 vertices.");
+    auto edgeStart = [&](uint32_t e) -> const Point& { return vertices[e]; };
+    auto edgeEnd   = [&](uint32_t e) -> const Point& { return vertices[e + 1 == n ? 0 : e + 1]; };
+
+    minX_ = maxX_ = vertices[0].x;
+    minY_ = maxY_ = vertices[0].y;
+    for (const auto& v : vertices) {
+        minX_ = std::min(minX_, v.x);
+        maxX_ = std::max(maxX_, v.x);
+        minY_ = std::min(minY_, v.y);
+        maxY_ = std::max(maxY_, v.y);
+    }
+    const double width = maxX_ - minX_, height = maxY_ - minY_;
+    const double magnitude = std::max(std::max(std::abs(minX_), std::abs(maxX_)),
+                                      std::max(std::abs(minY_), std::abs(maxY_)));
+    const double slack = 1e-9 * (width + height) + 1e-14 * magnitude;
+    if (!(width + height > 0) || std::isinf(width + height))
+        throw std::invalid_argument("ContainmentGrid requires a polygon with a finite, non-empty bounding box.");
+
+    // Cells [first, last] of every row touched by edge e, for a grid of the current size
+    auto forEachRow = [&](uint32_t e, auto&& visit) {
+        const Point& a = edgeStart(e);
+        const Point& b = edgeEnd(e);
+        const double low = std::min(a.y, b.y), high = std::max(a.y, b.y);
+        for (size_t r = row(low - slack), last = row(high + slack); r <= last; ++r) {
+            const double bandLow = minY_ + r * cellSize_ - slack, bandHigh = minY_ + (r + 1) * cellSize_ + slack;
+            double from = std::max(low, bandLow), to = std::min(high, bandHigh);
+            if (from > to)
+                from = to = low > bandHigh ? low : high;
+            double x0 = std::min(a.x, b.x), x1 = std::max(a.x, b.x);
+            if (a.y != b.y) {
+                const double slope = (b.x - a.x) / (b.y - a.y);
+                x0 = a.x + (from - a.y) * slope;
+                x1 = a.x + (to - a.y) * slope;
+                if (x0 > x1)
+                    std::swap(x0, x1);
+            }
+            visit(r, column(x0 - slack), column(x1 + slack));
+        }
+    };
+
+    // Square cells, as small as the budget allows: 4 bytes per cell, per boundary cell offset and per edge listed,
+    // and 1 byte per reference point. Rasterizing all edges for every size tried is slow, so the search starts from
+    // an estimate: an edge is listed in about 1 + (|dx| + |dy|) / cellSize cells, and the boundary cells are left out
+    double length = 0;
+    for (uint32_t e = 0; e < n; ++e)
+        length += std::abs(edgeEnd(e).x - edgeStart(e).x) + std::abs(edgeEnd(e).y - edgeStart(e).y);
+    const double spare = static_cast<double>(memoryBudget) / 4 - n - 1;
+    const double inverse = spare > 0 ?
+            2 * spare / (length + std::sqrt(length * length + 4 * width * height * spare)) : 0;
+    cellSize_ = inverse > 0 ? 1 / inverse : std::max(width, height);
+    cellSize_ = std::max(cellSize_, std::max(width, height) / (1 << 24));
+    while (true) {
+        columns_ = std::max<size_t>(1, static_cast<size_t>(std::ceil(width / cellSize_)));
+        rows_ = std::max<size_t>(1, static_cast<size_t>(std::ceil(height / cellSize_)));
+        const double cells = static_cast<double>(columns_) * rows_;
+        double references = 0;
+        for (uint32_t e = 0; e < n; ++e)
+            forEachRow(e, [&](size_t, size_t first, size_t last) { references += last - first + 1; });
+        if (4 * (cells + references + 1) + 5 * std::min(cells, references) <= memoryBudget && cells < OUTSIDE &&
+            references < UINT32_MAX)
+            break;
+        if (columns_ == 1 && rows_ == 1)
+            throw std::invalid_argument("Memory budget of ContainmentGrid is too small for the polygon.");
+        cellSize_ *= 1.25;
+    }
+
+    // Edge lists of the boundary cells, with the cells holding their edge counts meanwhile
+    cells_.assign(columns_ * rows_, 0);
+    for (uint32_t e = 0; e < n; ++e)
+        forEachRow(e, [&](size_t r, size_t first, size_t last) {
+            for (size_t c = first; c <= last; ++c)
+                cells_[r * columns_ + c]++;
+        });
+    size_t boundary = 0;
+    for (uint32_t count : cells_)
+        boundary += count > 0;
+    offsets_.reserve(boundary + 1);
+    size_t total = 0;
+    for (auto& cell : cells_) {
+        if (cell == 0) {
+            cell = OUTSIDE;
+            continue;
+        }
+        const uint32_t count = cell;
+        cell = static_cast<uint32_t>(offsets_.size());
+        offsets_.push_back(static_cast<uint32_t>(total));
+        total += count;
+    }
+    offsets_.push_back(static_cast<uint32_t>(total));
+    edges_.resize(total);
+    std::vector<uint32_t> cursor(offsets_.begin(), offsets_.end() - 1);
+    for (uint32_t e = 0; e < n; ++e)
+        forEachRow(e, [&](size_t r, size_t first, size_t last) {
+            for (size_t c = first; c <= last; ++c)
+                edges_[cursor[cells_[r * columns_ + c]]++] = e;
+        });
+
+    auto onEdge = [&](uint32_t id, const Point& p) {
+        for (uint32_t i = offsets_[id]; i < offsets_[id + 1]; ++i) {
+            const Point& a = edgeStart(edges_[i]);
+            const Point& b = edgeEnd(edges_[i]);
+            if (ccw(a, b, p) == Direction::COLLINEAR && onSegment(a, b, p))
+                return true;
+        }
+        return false;
+    };
+
+    // Along every row each reference point is located from the one before it, starting left of the grid where
+    // everything is outside; a classified cell stands for its centre. An edge listed in two consecutive cells is
+    // counted once.
+    references_.resize(offsets_.size() - 1);
+    for (size_t r = 0; r < rows_; ++r) {
+        Point previous(minX_ - cellSize_ / 2, candidate(r, 0, 0).y);
+        bool in = false;
+        for (size_t c = 0; c < columns_; ++c) {
+            const size_t cell = r * columns_ + c;
+            const uint32_t before = c > 0 ? cells_[cell - 1] : OUTSIDE;
+            const bool boundaryBefore = before < OUTSIDE;
+            uint32_t& id = cells_[cell];
+            Point reference = candidate(r, c, 0);
+            if (id < OUTSIDE) {
+                uint32_t k = 0;
+                while (onEdge(id, reference)) {
+                    if (++k == 128)
+                        throw std::logic_error("ContainmentGrid found no reference point off the edges of a cell.");
+                    reference = candidate(r, c, k);
+                }
+                if (boundaryBefore)
+                    in ^= crossings(vertices, before, previous, reference);
+                in ^= crossings(vertices, id, previous, reference, boundaryBefore ? cell - 1 : SIZE_MAX);
+                references_[id] = static_cast<uint8_t>(k << 1 | (in ? 1 : 0));
+            } else {
+                if (boundaryBefore)
+                    in ^= crossings(vertices, before, previous, reference);
+                id = in ? INSIDE : OUTSIDE;
+            }
+            previous = reference;
+        }
+    }
+
+    buildTime_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+size_t lgm::ContainmentGrid::column(double x) const {
+    double c = std::floor((x - minX_) / cellSize_);
+    return c <= 0 ? 0 : std::min(columns_ - 1, static_cast<size_t>(c));
+}
+
+size_t lgm::ContainmentGrid::row(double y) const {
+    double r = std::floor((y - minY_) / cellSize_);
+    return r <= 0 ? 0 : std::min(rows_ - 1, static_cast<size_t>(r));
+}
+
+bool lgm::ContainmentGrid::listed(size_t cell, uint32_t edge) const {
+    const uint32_t id = cells_[cell];
+    return id < OUTSIDE &&
+           std::binary_search(edges_.begin() + offsets_[id], edges_.begin() + offsets_[id + 1], edge);
+}
+
+lgm::Point lgm::ContainmentGrid::candidate(size_t row, size_t column, uint32_t k) const {
+    const Point centre(minX_ + (column + 0.5) * cellSize_, minY_ + (row + 0.5) * cellSize_);
+    if (k == 0)
+        return centre;
+    // Well spread points of the inner 90% of the cell (the R2 sequence)
+    double u = k * 0.7548776662466927, v = k * 0.5698402909980532;
+    u -= std::floor(u);
+    v -= std::floor(v);
+    return Point(centre.x + 0.9 * cellSize_ * (u - 0.5), centre.y + 0.9 * cellSize_ * (v - 0.5));
+}
+
+bool lgm::ContainmentGrid::crossings(const std::vector<Point> &vertices, uint32_t id, const Point &r, const Point &p,
+                                     size_t skip) const {
+    const size_t n = vertices.size();
+    bool parity = false;
+    for (uint32_t i = offsets_[id]; i < offsets_[id + 1]; ++i) {
+        const uint32_t e = edges_[i];
+        if (skip != SIZE_MAX && listed(skip, e))
+            continue;
+        const Point& a = vertices[e];
+        const Point& b = vertices[e + 1 == n ? 0 : e + 1];
+        if ((ccw(r, p, a) == Direction::CW) == (ccw(r, p, b) == Direction::CW))
+            continue;
+        parity ^= ccw(a, b, r) != ccw(a, b, p);
+    }
+    return parity;
+}
+
+lgm::Location lgm::ContainmentGrid::locate(const std::vector<Point> &vertices, const Point &p) const {
+    if (!(p.x >= minX_ && p.x <= maxX_ && p.y >= minY_ && p.y <= maxY_))
+        return Location::OUTSIDE;
+    const size_t r = row(p.y), c = column(p.x);
+    const uint32_t id = cells_[r * columns_ + c];
+    if (id == INSIDE)
+        return Location::INSIDE;
+    if (id == OUTSIDE)
+        return Location::OUTSIDE;
+
+    const size_t n = vertices.size();
+    for (uint32_t i = offsets_[id]; i < offsets_[id + 1]; ++i) {
+        const uint32_t e = edges_[i];
+        const Point& a = vertices[e];
+        const Point& b = vertices[e + 1 == n ? 0 : e + 1];
+        if (ccw(a, b, p) == Direction::COLLINEAR && onSegment(a, b, p))
+            return Location::BOUNDARY;
+    }
+    const uint8_t reference = references_[id];
+    const bool in = ((reference & 1) != 0) != crossings(vertices, id, candidate(r, c, reference >> 1), p);
+    return in ? Location::INSIDE : Location::OUTSIDE;
+}
+
+size_t lgm::ContainmentGrid::columns() const {
+    return columns_;
+}
+
+size_t lgm::ContainmentGrid::rows() const {
+    return rows_;
+}
+
+size_t lgm::ContainmentGrid::boundaryCells() const {
+    return offsets_.size() - 1;
+}
+
+double lgm::ContainmentGrid::buildTime() const {
+    return buildTime_;
+}
+
+size_t lgm::ContainmentGrid::memoryUsage() const {
+    return (cells_.capacity() + offsets_.capacity() + edges_.capacity()) * sizeof(uint32_t) +
+           references_.capacity() * sizeof(uint8_t);
+}
@@ -4,10 +4,11 @@
 
 #include <stdexcept>
 #include <cmath>
-#include <deque>
 #include <algorithm>
 
 #include "../headers/ConvexPolygon.h"
+#include "../headers/Metrics.h"
+#include "../headers/Parallel.h"
 
 lgm::ConvexPolygon::ConvexPolygon(std::vector<Point> vertices) : Polygon(std::move(vertices)) {
     if (!isConvex(vertices_))
@@ -22,88 +23,282 @@ lgm::ConvexPolygon::ConvexPolygon(const std::vector<Segment> &edges) : Polygon(e
 }
 
 void lgm::ConvexPolygon::calculateWedges() {
-    wedges_.clear();
-    Point z = calculateInsidePoint(vertices_);
-    for (size_t i = 0; i < size(); ++i) {
-        wedges_.emplace_back(std::atan2(vertices_[i].y - z.y, vertices_[i].x - z.x) + 3.1415926);
-    }
+    pivot_ = calculateInsidePoint(vertices_);
+    turn_ = ccw(vertices_[0], vertices_[1], vertices_[2]);
+    secondHalf_ = 1;
+    while (secondHalf_ < size() && half(vertices_[secondHalf_]) == 0)
+        secondHalf_++;
 }
 
-bool lgm::ConvexPolygon::contains(const lgm::Point &p) const {
-    Point z = calculateInsidePoint(vertices());
-    double angle = std::atan2(p.y - z.y, p.x - z.x) + 3.1415926;
-
-    int l = -1;
-    int r = wedges_.size() - 1;
-    while (l < r) {
-        size_t m = (l + r) / 2;
-        if (wedges_[m] >= angle)
-            r = m;
-        else
-            l = m + 1;
+// 0 if p lies in the half-turn that starts at ray pivot->vertices_[0] (in traversal direction), 1 otherwise
+int lgm::ConvexPolygon::half(const lgm::Point &p) const {
+    Direction d = ccw(pivot_, vertices_[0], p);
+    if (d == turn_)
+        return 0;
+    if (d == Direction::COLLINEAR && dot(vertices_[0] - pivot_, p - pivot_) > 0)
+        return 0;
+    return 1;
+}
+
+size_t lgm::ConvexPolygon::wedge(const lgm::Point &p, size_t* steps) const {
+    // Within one half-turn "v is not after p" is a single orientation test and holds for a prefix of vertices
+    auto first = vertices_.begin();
+    auto last = vertices_.begin() + secondHalf_;
+    if (half(p) == 1) {
+        first = last;
+        last = vertices_.end();
     }
-    Point vertex = vertices_[r];
-    Point prev = vertices_[(r - 1 + size()) % size()];
+    size_t probes = 0;
+    auto next = std::partition_point(first, last, [&](const Point& v) {
+        ++probes;
+        return ccw(pivot_, p, v) != turn_;
+    });
+    if (steps)
+        *steps = probes;
+    return next - vertices_.begin() - 1;
+}
 
-    Direction p_sgn = ccw(vertex, prev, p);
-    Direction z_sgn = ccw(vertex, prev, z);
-    if (p_sgn == Direction::COLLINEAR) return true; //border
-    return !(p_sgn != z_sgn);
+lgm::Location lgm::ConvexPolygon::locate(size_t wedge, const lgm::Point &p) const {
+    Direction p_sgn = ccw(vertices_[wedge], vertices_[(wedge + 1) % size()], p);
+    if (p_sgn == Direction::COLLINEAR)
+        return Location::BOUNDARY;
+    return p_sgn == turn_ ? Location::INSIDE : Location::OUTSIDE;
+}
 
+bool lgm::ConvexPolygon::contains(const lgm::Point &p) const {
+    LGM_METRICS_SCOPE(Operation::CONVEX_POLYGON_CONTAINS);
+#ifdef LGM_METRICS
+    size_t steps = 0;
+    bool inside = locate(wedge(p, &steps), p) != Location::OUTSIDE;
+    LGM_METRICS_SEARCH_STEPS(steps);
+    return inside;
+#else
+    return locate(wedge(p), p) != Location::OUTSIDE;
+#endif
 }
 
 bool lgm::ConvexPolygon::isBoundary(const lgm::Point &p) const {
-    Point z = calculateInsidePoint(vertices());
-    double angle = std::atan2(p.y - z.y, p.x - z.x) + 3.1415926;
-
-    int l = -1;
-    int r = wedges_.size() - 1;
-    while (l < r) {
-        int m = (l + r) / 2;
-        if (wedges_[m] >= angle)
-            r = m;
-        else
-            l = m + 1;
+    return locate(wedge(p), p) == Location::BOUNDARY;
+}
+
+void lgm::ConvexPolygon::locate(const double *x, const double *y, size_t count, lgm::Location *result) const {
+    // The sweep touches every wedge once, so it only pays off when the batch is at least comparable to the polygon
+    // and the polygon is large enough for the binary search to cost more than sorting
+    if (size() < 64 || count * std::log2(size()) <= 2 * size()) {
+        for (size_t i = 0; i < count; ++i) {
+            Point p(x[i], y[i]);
+            result[i] = locate(wedge(p), p);
+        }
+        return;
     }
-    Point vertex = vertices_[r];
-    Point prev = vertices_[(r - 1 + size()) % size()];
 
-    Direction p_sgn = ccw(vertex, prev, p);
-    return p_sgn == Direction::COLLINEAR;
+    // Sorting the whole batch at once would cost log M per point; chunks of a few polygon sizes keep it at log N
+    size_t chunk = 4 * size();
+    std::vector<std::pair<double, size_t>> order;
+    order.reserve(std::min(count, chunk));
+    for (size_t first = 0; first < count; first += chunk) {
+        size_t last = std::min(count, first + chunk);
+        order.clear();
+        sweep(x, y, first, last, order, result);
+    }
+}
+
+void lgm::ConvexPolygon::sweep(const double *x, const double *y, size_t first, size_t last,
+                               std::vector<std::pair<double, size_t>> &order, lgm::Location *result) const {
+    // Pseudo-angles only order the batch; the wedge of every point is still decided by orientation tests
+    double base = detail::pseudoAngle(vertices_[0] - pivot_);
+    for (size_t i = first; i < last; ++i) {
+        if (x[i] == pivot_.x && y[i] == pivot_.y) {
+            result[i] = Location::INSIDE;
+            continue;
+        }
+        double key = detail::pseudoAngle(Point(x[i] - pivot_.x, y[i] - pivot_.y)) - base;
+        if (turn_ == Direction::CW)
+            key = -key;
+        order.emplace_back(key < 0 ? key + 4 : key, i);
+    }
+    std::sort(order.begin(), order.end());
+
+    size_t w = 0;
+    for (size_t k = 0; k < order.size(); ++k) {
+        size_t i = order[k].second;
+        Point p(x[i], y[i]);
+        // Local orientation tests are only valid within a half-turn, which is 2 in pseudo-angle units
+        if (k == 0 || order[k].first - order[k - 1].first >= 1) {
+            w = wedge(p);
+        } else {
+            // Advance while the next vertex is not after p; a rounding error in the pseudo-angle that leaves p
+            // behind the current wedge is caught by the check below
+            for (size_t steps = 0; steps < size(); ++steps) {
+                size_t next = (w + 1) % size();
+                if (ccw(pivot_, vertices_[next], p) == opposite(turn_))
+                    break;
+                w = next;
+            }
+            if (ccw(pivot_, vertices_[w], p) == opposite(turn_))
+                w = wedge(p);
+        }
+        result[i] = locate(w, p);
+    }
 }
 
 void lgm::ConvexPolygon::add(const lgm::Point &point) {
     Polygon::add(point);
     if (!isConvex(vertices()))
         throw std::logic_error("Newly added point ruined convexity of polygon.");
+    calculateWedges();
 }
 
-lgm::ConvexPolygon lgm::ModifiedGrahamScan(const std::vector<lgm::Point>& origin) {
-    std::vector<Point> points = origin;
-    std::stable_sort(points.begin(), points.end());
+namespace {
+    using lgm::Point;
+    using lgm::Direction;
 
-    std::deque<Point> answer;
-    answer.push_back(points.at(0));
-    answer.push_back(points.at(1));
-    for (unsigned int i = 2; i < points.size(); ++i) {
-        while (answer.size() > 1 && ccw(answer.at(answer.size() - 2), answer.back(), points[i]) != Direction::CCW) {
-            answer.pop_back();
+    /*
+     * Hull of lexicographically sorted points as ModifiedGrahamScan builds it: counter-clockwise from the smallest
+     * point, without collinear vertices. The vector doubles as the stack.
+     */
+    std::vector<Point> grahamChain(const std::vector<Point>& points) {
+        std::vector<Point> answer;
+        answer.reserve(points.size() + 1);
+        answer.push_back(points.at(0));
+        answer.push_back(points.at(1));
+        for (size_t i = 2; i < points.size(); ++i) {
+            while (answer.size() > 1 && ccw(answer[answer.size() - 2], answer.back(), points[i]) != Direction::CCW) {
+                answer.pop_back();
+            }
+            answer.push_back(points[i]);
+        }
+        long long start = static_cast<long long>(points.size()) - 2;
+        while (start >= 0 && answer.size() > 1 &&
+               ccw(answer[answer.size() - 2], answer.back(), points[start]) == Direction::COLLINEAR) {
+            start--;
         }
-        answer.push_back(points[i]);
+        for (long long i = start; i >= 0; --i) {
+            while (answer.size() > 1 && ccw(answer[answer.size() - 2], answer.back(), points[i]) != Direction::CCW) {
+                answer.pop_back();
+            }
+            answer.push_back(points[i]);
+        }
+        answer.pop_back();
+        while (ccw(answer.at(answer.size() - 1), answer.at(0), answer.at(1)) == Direction::COLLINEAR)
+            answer.pop_back();
+        return answer;
     }
-    int start = points.size() - 2;
-    while (answer.size() > 1 && ccw(answer.at(answer.size() - 2), answer.back(), points[start]) == Direction::COLLINEAR) {
-        start--;
+
+    /*
+     * Andrew's monotone chain over sorted points, writing hull vertices (without collinear ones) to out.
+     * Degenerate inputs give their extreme points.
+     */
+    void monotoneChain(const std::vector<Point>& points, std::vector<Point>& out) {
+        if (points.size() < 3) {
+            out.insert(out.end(), points.begin(), points.end());
+            return;
+        }
+        std::vector<Point> hull(2 * points.size());
+        size_t k = 0;
+        for (size_t i = 0; i < points.size(); ++i) {
+            while (k >= 2 && ccw(hull[k - 2], hull[k - 1], points[i]) != Direction::CCW)
+                k--;
+            hull[k++] = points[i];
+        }
+        for (size_t i = points.size() - 1, lower = k + 1; i-- > 0;) {
+            while (k >= lower && ccw(hull[k - 2], hull[k - 1], points[i]) != Direction::CCW)
+                k--;
+            hull[k++] = points[i];
+        }
+        out.insert(out.end(), hull.begin(), hull.begin() + (k - 1));
     }
-    for (int i = start; i >= 0; --i) {
-        while (answer.size() > 1 && ccw(answer.at(answer.size() - 2), answer.back(), points[i]) != Direction::CCW) {
-            answer.pop_back();
+
+    /*
+     * Akl-Toussaint heuristic: the points extreme in 8 directions span an octagon inside the hull,
+     * every point strictly inside it can be thrown away before sorting
+     */
+    struct Octagon {
+        Point extremes[8];
+
+        explicit Octagon(const Point& p) {
+            std::fill(extremes, extremes + 8, p);
+        }
+
+        void add(const Point& p) {
+            // Directions in counter-clockwise order starting from -y
+            if (p.y < extremes[0].y) extremes[0] = p;
+            if (p.x - p.y > extremes[1].x - extremes[1].y) extremes[1] = p;
+            if (p.x > extremes[2].x) extremes[2] = p;
+            if (p.x + p.y > extremes[3].x + extremes[3].y) extremes[3] = p;
+            if (p.y > extremes[4].y) extremes[4] = p;
+            if (p.y - p.x > extremes[5].y - extremes[5].x) extremes[5] = p;
+            if (p.x < extremes[6].x) extremes[6] = p;
+            if (-p.x - p.y > -extremes[7].x - extremes[7].y) extremes[7] = p;
+        }
+
+        void add(const Octagon& other) {
+            for (const auto& p : other.extremes)
+                add(p);
+        }
+
+        std::vector<Point> polygon() const {
+            std::vector<Point> result;
+            for (const auto& p : extremes) {
+                if (result.empty() || (result.back() != p && result.front() != p))
+                    result.push_back(p);
+            }
+            return result;
+        }
+    };
+
+    bool strictlyInside(const std::vector<Point>& octagon, const Point& p) {
+        for (size_t i = 0; i < octagon.size(); ++i) {
+            if (ccw(octagon[i], octagon[(i + 1) % octagon.size()], p) != Direction::CCW)
+                return false;
         }
-        answer.push_back(points[i]);
+        return true;
     }
-    answer.pop_back();
-    std::vector<Point> v_answer(answer.begin(), answer.end());
-    while (ccw(v_answer.at(v_answer.size() - 1), v_answer.at(0), v_answer.at(1)) == Direction::COLLINEAR)
-        v_answer.pop_back();
-    return ConvexPolygon(v_answer);
-}
\ No newline at end of file
+}
+
+lgm::ConvexPolygon lgm::ModifiedGrahamScan(const std::vector<lgm::Point>& origin) {
+    LGM_METRICS_SCOPE(Operation::MODIFIED_GRAHAM_SCAN);
+    std::vector<Point> points = origin;
+    std::stable_sort(points.begin(), points.end());
+    return ConvexPolygon(grahamChain(points));
+}
+
+lgm::ConvexPolygon lgm::ParallelConvexHull(const std::vector<lgm::Point> &origin, size_t threads) {
+    if (origin.empty())
+        throw std::logic_error("Convex hull of an empty set of points.");
+    threads = detail::threadCount(threads, origin.size(), 1024);
+    auto chunk = [&](size_t t) {
+        return std::make_pair(origin.size() * t / threads, origin.size() * (t + 1) / threads);
+    };
+
+    std::vector<Octagon> octagons(threads, Octagon(origin.front()));
+    detail::parallelFor(threads, [&](size_t t) {
+        auto range = chunk(t);
+        for (size_t i = range.first; i < range.second; ++i)
+            octagons[t].add(origin[i]);
+    });
+    for (size_t t = 1; t < threads; ++t)
+        octagons[0].add(octagons[t]);
+    std::vector<Point> octagon = octagons[0].polygon();
+    bool filter = octagon.size() >= 3;
+
+    // Every thread reduces its chunk to the hull of its surviving points; the hull of their union is the answer
+    std::vector<std::vector<Point>> hulls(threads);
+    detail::parallelFor(threads, [&](size_t t) {
+        auto range = chunk(t);
+        std::vector<Point> survivors;
+        for (size_t i = range.first; i < range.second; ++i) {
+            if (!filter || !strictlyInside(octagon, origin[i]))
+                survivors.push_back(origin[i]);
+        }
+        std::sort(survivors.begin(), survivors.end());
+        survivors.erase(std::unique(survivors.begin(), survivors.end()), survivors.end());
+        monotoneChain(survivors, hulls[t]);
+    });
+
+    std::vector<Point> points;
+    for (const auto& hull : hulls)
+        points.insert(points.end(), hull.begin(), hull.end());
+    std::sort(points.begin(), points.end());
+    return ConvexPolygon(grahamChain(points));
+}
@@ -0,0 +1,192 @@
+//
+// Rotating calipers on ConvexPolygon.
+//
+// Vertices may go either way round; s = +1 for counter-clockwise and -1 for clockwise turns the signed distances
+// below into distances into the polygon. All loops advance indices with conditionals, never with %.
+//
+
+#include <cmath>
+
+#include "../headers/ConvexPolygon.h"
+
+namespace {
+    using lgm::Point;
+
+    size_t next(size_t i, size_t n) {
+        return i + 1 == n ? 0 : i + 1;
+    }
+
+    // Supporting vertices of the rectangle that has a side along edge i: farthest back, ahead and across
+    struct Support {
+        size_t edge;
+        size_t back;
+        size_t ahead;
+        size_t across;
+    };
+
+    /*
+     * Calls visit(support) for every edge. Each support index only moves forward, so this is O(N) in all.
+     * Along edge e, dot(v, e) first grows and then falls, s * cross(e, v) grows up to the opposite side and falls
+     */
+    template <typename Visit>
+    void calipers(const std::vector<Point>& v, double s, Visit visit) {
+        const size_t n = v.size();
+        Support support{0, 0, 0, 0};
+        for (size_t i = 0; i < n; ++i) {
+            const Point e = v[next(i, n)] - v[i];
+            support.edge = i;
+            if (i == 0)
+                support.ahead = next(i, n);
+            while (lgm::dot(v[next(support.ahead, n)] - v[support.ahead], e) > 0)
+                support.ahead = next(support.ahead, n);
+            if (i == 0)
+                support.across = support.ahead;
+            while (s * lgm::cross(e, v[next(support.across, n)] - v[support.across]) > 0)
+                support.across = next(support.across, n);
+            if (i == 0)
+                support.back = support.across;
+            while (lgm::dot(v[next(support.back, n)] - v[support.back], e) < 0)
+                support.back = next(support.back, n);
+            visit(support);
+        }
+    }
+
+    // Side along the edge and height across it, both scaled by the edge length
+    void extent(const std::vector<Point>& v, double s, const Support& support, double& side, double& height) {
+        const Point& origin = v[support.edge];
+        const Point e = v[next(support.edge, v.size())] - origin;
+        side = lgm::dot(v[support.ahead] - origin, e) - lgm::dot(v[support.back] - origin, e);
+        height = s * lgm::cross(e, v[support.across] - origin);
+    }
+
+    lgm::OrientedRectangle rectangle(const std::vector<Point>& v, double s, const Support& support) {
+        const Point& origin = v[support.edge];
+        const Point e = v[next(support.edge, v.size())] - origin;
+        const double squared = lgm::dot(e, e);
+        // Inward normal of the edge, as long as the edge
+        const Point normal = s * Point(-e.y, e.x);
+        const Point a = origin + (lgm::dot(v[support.back] - origin, e) / squared) * e;
+        const Point b = origin + (lgm::dot(v[support.ahead] - origin, e) / squared) * e;
+        const Point up = (lgm::cross(e, v[support.across] - origin) * s / squared) * normal;
+        lgm::OrientedRectangle result;
+        if (s > 0) {
+            result.corners[0] = a;
+            result.corners[1] = b;
+            result.corners[2] = b + up;
+            result.corners[3] = a + up;
+        } else {
+            result.corners[0] = a;
+            result.corners[1] = a + up;
+            result.corners[2] = b + up;
+            result.corners[3] = b;
+        }
+        return result;
+    }
+}
+
+double lgm::OrientedRectangle::area() const {
+    return std::abs(cross(corners[1] - corners[0], corners[3] - corners[0]));
+}
+
+double lgm::OrientedRectangle::perimeter() const {
+    return 2 * (distance(corners[0], corners[1]) + distance(corners[0], corners[3]));
+}
+
+lgm::Segment lgm::ConvexPolygon::diameter() const {
+    const size_t n = size();
+    const std::vector<Point>& v = vertices_;
+    size_t bestA = 0, bestB = 1;
+    double best = 0;
+    auto consider = [&](size_t a, size_t b) {
+        Point d = v[a] - v[b];
+        double squared = dot(d, d);
+        if (squared > best) {
+            best = squared;
+            bestA = a;
+            bestB = b;
+        }
+    };
+    // Antipodal pairs: for every edge, the vertex farthest from its line
+    size_t j = 1;
+    for (size_t i = 0; i < n; ++i) {
+        const size_t i1 = next(i, n);
+        const Point e = v[i1] - v[i];
+        double height = std::abs(cross(e, v[j] - v[i]));
+        while (true) {
+            double further = std::abs(cross(e, v[next(j, n)] - v[i]));
+            if (further < height)
+                break;
+            // An edge parallel to this one: both of its ends are antipodal to both ends of this edge
+            if (further == height) {
+                consider(i, next(j, n));
+                consider(i1, next(j, n));
+                break;
+            }
+            height = further;
+            j = next(j, n);
+        }
+        consider(i, j);
+        consider(i1, j);
+    }
+    return Segment(v[bestA], v[bestB]);
+}
+
+double lgm::ConvexPolygon::width() const {
+    const std::vector<Point>& v = vertices_;
+    const double s = turn_ == Direction::CCW ? 1 : -1;
+    // Smallest height scaled by edge length, compared through squares to take one square root in the end
+    double bestHeight = 0, bestSquared = 1;
+    bool first = true;
+    calipers(v, s, [&](const Support& support) {
+        double side, height;
+        extent(v, s, support, side, height);
+        Point e = v[next(support.edge, v.size())] - v[support.edge];
+        double squared = dot(e, e);
+        if (first || height * height * bestSquared < bestHeight * bestHeight * squared) {
+            bestHeight = height;
+            bestSquared = squared;
+            first = false;
+        }
+    });
+    return bestHeight / std::sqrt(bestSquared);
+}
+
+lgm::OrientedRectangle lgm::ConvexPolygon::minimumAreaRectangle() const {
+    const std::vector<Point>& v = vertices_;
+    const double s = turn_ == Direction::CCW ? 1 : -1;
+    Support best{};
+    double bestArea = 0;
+    bool first = true;
+    calipers(v, s, [&](const Support& support) {
+        double side, height;
+        extent(v, s, support, side, height);
+        Point e = v[next(support.edge, v.size())] - v[support.edge];
+        double area = side * height / dot(e, e);
+        if (first || area < bestArea) {
+            bestArea = area;
+            best = support;
+            first = false;
+        }
+    });
+    return rectangle(v, s, best);
+}
+
+lgm::OrientedRectangle lgm::ConvexPolygon::minimumPerimeterRectangle() const {
+    const std::vector<Point>& v = vertices_;
+    const double s = turn_ == Direction::CCW ? 1 : -1;
+    Support best{};
+    double bestPerimeter = 0;
+    bool first = true;
+    calipers(v, s, [&](const Support& support) {
+        double side, height;
+        extent(v, s, support, side, height);
+        Point e = v[next(support.edge, v.size())] - v[support.edge];
+        double perimeter = (side + height) / std::sqrt(dot(e, e));
+        if (first || perimeter < bestPerimeter) {
+            bestPerimeter = perimeter;
+            best = support;
+            first = false;
+        }
+    });
+    return rectangle(v, s, best);
+}
@@ -0,0 +1,285 @@
+//
+// Intersection and Minkowski sum of convex polygons.
+//
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "../headers/ConvexPolygon.h"
+
+namespace {
+    using lgm::Point;
+    using lgm::Direction;
+
+    // Vertices of a convex polygon in counter-clockwise order, whatever order the polygon keeps them in
+    struct CcwRing {
+        const Point* v;
+        size_t n;
+        bool reversed;
+
+        CcwRing(const std::vector<Point>& vertices, Direction turn)
+                : v(vertices.data()), n(vertices.size()), reversed(turn == Direction::CW) {}
+
+        const Point& operator[](size_t i) const {
+            return reversed ? v[n - 1 - i] : v[i];
+        }
+    };
+
+    int sign(Direction d) {
+        return d == Direction::CCW ? 1 : (d == Direction::CW ? -1 : 0);
+    }
+
+    /*
+     * Appends p keeping out strictly convex: duplicates and vertices that rounding of computed points left
+     * collinear or reflex are dropped. The input walks a convex boundary, so this removes O(1) vertices amortized.
+     */
+    void push(std::vector<Point>& out, const Point& p) {
+        if (!out.empty() && out.back() == p)
+            return;
+        while (out.size() >= 2 && ccw(out[out.size() - 2], out.back(), p) != Direction::CCW)
+            out.pop_back();
+        out.push_back(p);
+    }
+
+    // Same for the seam between the last and the first vertices; false if no area is left
+    bool close(std::vector<Point>& out) {
+        size_t first = 0;
+        bool changed = true;
+        while (changed && out.size() - first >= 3) {
+            changed = false;
+            if (ccw(out[out.size() - 2], out.back(), out[first]) != Direction::CCW) {
+                out.pop_back();
+                changed = true;
+            } else if (ccw(out.back(), out[first], out[first + 1]) != Direction::CCW) {
+                ++first;
+                changed = true;
+            }
+        }
+        out.erase(out.begin(), out.begin() + first);
+        return out.size() >= 3;
+    }
+
+    enum class Crossing {
+        NONE, PROPER, VERTEX, OVERLAP
+    };
+
+    /*
+     * Intersection of segments ab and cd, given o2 = ccw(a, b, d) and o4 = ccw(c, d, b) that the caller has
+     * already computed; p gets the crossing point for PROPER and VERTEX
+     */
+    Crossing crossSegments(const Point& a, const Point& b, const Point& c, const Point& d, Direction o2, Direction o4,
+                           Point& p) {
+        Direction o1 = ccw(a, b, c);
+        if (o1 == o2 && o1 != Direction::COLLINEAR)
+            return Crossing::NONE;
+        Direction o3 = ccw(c, d, a);
+        if (o1 == Direction::COLLINEAR && o2 == Direction::COLLINEAR) {
+            bool overlap = std::max(std::min(a.x, b.x), std::min(c.x, d.x)) <= std::min(std::max(a.x, b.x), std::max(c.x, d.x)) &&
+                           std::max(std::min(a.y, b.y), std::min(c.y, d.y)) <= std::min(std::max(a.y, b.y), std::max(c.y, d.y));
+            return overlap ? Crossing::OVERLAP : Crossing::NONE;
+        }
+        if (o1 == o2 || o3 == o4)
+            return Crossing::NONE;
+        // An endpoint on the other segment is the crossing point itself
+        if (o1 == Direction::COLLINEAR) { p = c; return Crossing::VERTEX; }
+        if (o2 == Direction::COLLINEAR) { p = d; return Crossing::VERTEX; }
+        if (o3 == Direction::COLLINEAR) { p = a; return Crossing::VERTEX; }
+        if (o4 == Direction::COLLINEAR) { p = b; return Crossing::VERTEX; }
+        Point ab = b - a, cd = d - c;
+        double t = lgm::cross(c - a, cd) / lgm::cross(ab, cd);
+        p = a + std::min(std::max(t, 0.0), 1.0) * ab;
+        return Crossing::PROPER;
+    }
+
+    // Which boundary is currently the inner one
+    enum class Inside {
+        UNKNOWN, P, Q
+    };
+
+    /*
+     * Whether P lies in q, given that their boundaries do not cross: the first vertex of P off the boundary of q
+     * decides. Usually that is the first vertex, so this is O(log M)
+     */
+    bool within(const CcwRing& P, const lgm::ConvexPolygon& q) {
+        for (size_t i = 0; i < P.n; ++i) {
+            if (!q.contains(P[i]))
+                return false;
+            if (!q.isBoundary(P[i]))
+                return true;
+        }
+        // Every vertex of P on the boundary of q
+        return true;
+    }
+
+    bool intersectRings(const CcwRing& P, const CcwRing& Q, const lgm::ConvexPolygon& p, const lgm::ConvexPolygon& q,
+                        std::vector<Point>& out) {
+        const size_t n = P.n, m = Q.n;
+        size_t a = 0, b = 0, aa = 0, ba = 0;
+        Inside inside = Inside::UNKNOWN;
+        bool first = true;
+        out.clear();
+
+        auto advanceA = [&]() {
+            if (inside == Inside::P)
+                push(out, P[a]);
+            ++aa;
+            a = a + 1 == n ? 0 : a + 1;
+        };
+        auto advanceB = [&]() {
+            if (inside == Inside::Q)
+                push(out, Q[b]);
+            ++ba;
+            b = b + 1 == m ? 0 : b + 1;
+        };
+
+        do {
+            size_t a1 = a == 0 ? n - 1 : a - 1, b1 = b == 0 ? m - 1 : b - 1;
+            Point A = P[a] - P[a1], B = Q[b] - Q[b1];
+            double crossAB = lgm::cross(A, B);
+            Direction aHQ = ccw(Q[b1], Q[b], P[a]);
+            Direction bHP = ccw(P[a1], P[a], Q[b]);
+            int aHB = sign(aHQ), bHA = sign(bHP);
+
+            Point x;
+            Crossing crossing = crossSegments(P[a1], P[a], Q[b1], Q[b], bHP, aHQ, x);
+            if (crossing == Crossing::PROPER || crossing == Crossing::VERTEX) {
+                if (inside == Inside::UNKNOWN && first) {
+                    aa = ba = 0;
+                    first = false;
+                }
+                push(out, x);
+                if (aHB > 0)
+                    inside = Inside::P;
+                else if (bHA > 0)
+                    inside = Inside::Q;
+            }
+
+            // Edges overlapping in opposite directions: the polygons touch along them from outside
+            if (crossing == Crossing::OVERLAP && lgm::dot(A, B) < 0)
+                return false;
+            if (crossAB == 0 && aHB < 0 && bHA < 0)
+                return false;
+
+            if (crossAB == 0 && aHB == 0 && bHA == 0) {
+                if (inside == Inside::P)
+                    advanceB();
+                else
+                    advanceA();
+            } else if (crossAB >= 0) {
+                if (bHA > 0)
+                    advanceA();
+                else
+                    advanceB();
+            } else {
+                if (aHB > 0)
+                    advanceB();
+                else
+                    advanceA();
+            }
+        } while ((aa < n || ba < m) && aa < 2 * n && ba < 2 * m);
+
+        if (inside == Inside::UNKNOWN) {
+            // The boundaries never cross: one polygon lies inside the other, or they share no interior
+            out.clear();
+            if (within(P, q)) {
+                for (size_t i = 0; i < n; ++i)
+                    out.push_back(P[i]);
+                return true;
+            }
+            if (within(Q, p)) {
+                for (size_t i = 0; i < m; ++i)
+                    out.push_back(Q[i]);
+                return true;
+            }
+            return false;
+        }
+        return close(out);
+    }
+
+    // Index of the lowest vertex, leftmost among the lowest
+    size_t lowest(const CcwRing& ring) {
+        size_t best = 0;
+        for (size_t i = 1; i < ring.n; ++i)
+            if (ring[i].y < ring[best].y || (ring[i].y == ring[best].y && ring[i].x < ring[best].x))
+                best = i;
+        return best;
+    }
+
+    void sumRings(const CcwRing& P, const CcwRing& Q, std::vector<Point>& out) {
+        const size_t n = P.n, m = Q.n;
+        size_t i0 = lowest(P), j0 = lowest(Q);
+        out.clear();
+        size_t i = 0, j = 0;
+        while (i < n || j < m) {
+            const Point& p = P[(i0 + i) % n];
+            const Point& q = Q[(j0 + j) % m];
+            push(out, p + q);
+            if (i == n) {
+                ++j;
+            } else if (j == m) {
+                ++i;
+            } else {
+                // Edges are merged by angle; c > 0 means the edge of P comes first, parallel edges go together
+                double c = lgm::cross(P[(i0 + i + 1) % n] - p, Q[(j0 + j + 1) % m] - q);
+                if (c >= 0)
+                    ++i;
+                if (c <= 0)
+                    ++j;
+            }
+        }
+        close(out);
+    }
+}
+
+lgm::ConvexPolygon::ConvexPolygon(std::vector<Point> vertices, Unchecked unchecked)
+        : Polygon(std::move(vertices), unchecked) {
+    calculateWedges();
+}
+
+void lgm::ConvexPolygon::assign(std::vector<Point> &vertices) {
+    vertices_.swap(vertices);
+    dropProperties();
+    dropIndex();
+    dropGrid();
+    calculateWedges();
+}
+
+namespace {
+    /*
+     * Output buffer of the in-place versions. assign() swaps it with the old vertices of the result, so once both
+     * have grown large enough a thread keeps reusing the same two arrays
+     */
+    std::vector<Point>& scratch() {
+        thread_local std::vector<Point> buffer;
+        return buffer;
+    }
+}
+
+bool lgm::intersection(const ConvexPolygon &a, const ConvexPolygon &b, ConvexPolygon &result) {
+    std::vector<Point>& out = scratch();
+    if (!intersectRings(CcwRing(a.vertices_, a.turn_), CcwRing(b.vertices_, b.turn_), a, b, out))
+        return false;
+    result.assign(out);
+    return true;
+}
+
+lgm::ConvexPolygon lgm::intersection(const ConvexPolygon &a, const ConvexPolygon &b) {
+    std::vector<Point> out;
+    out.reserve(a.size() + b.size());
+    if (!intersectRings(CcwRing(a.vertices_, a.turn_), CcwRing(b.vertices_, b.turn_), a, b, out))
+        throw std::logic_error("Convex polygons do not overlap.");
+    return ConvexPolygon(std::move(out), ConvexPolygon::Unchecked());
+}
+
+void lgm::minkowskiSum(const ConvexPolygon &a, const ConvexPolygon &b, ConvexPolygon &result) {
+    std::vector<Point>& out = scratch();
+    sumRings(CcwRing(a.vertices_, a.turn_), CcwRing(b.vertices_, b.turn_), out);
+    result.assign(out);
+}
+
+lgm::ConvexPolygon lgm::minkowskiSum(const ConvexPolygon &a, const ConvexPolygon &b) {
+    std::vector<Point> out;
+    out.reserve(a.size() + b.size());
+    sumRings(CcwRing(a.vertices_, a.turn_), CcwRing(b.vertices_, b.turn_), out);
+    return ConvexPolygon(std::move(out), ConvexPolygon::Unchecked());
+}
@@ -0,0 +1,97 @@
+//
+// Incremental convex hull on two monotone chains.
+//
+
+#include <iterator>
+#include <stdexcept>
+
+#include "../headers/DynamicConvexHull.h"
+
+lgm::DynamicConvexHull::Chain::Chain(lgm::Direction turn) : turn_(turn) {}
+
+bool lgm::DynamicConvexHull::Chain::add(const lgm::Point &p) {
+    auto next = points_.lower_bound(p);
+    if (next != points_.end() && *next == p)
+        return false;
+    // A point between two chain vertices is covered unless it makes a strict turn with them
+    if (next != points_.end() && next != points_.begin() && ccw(*std::prev(next), p, *next) != turn_)
+        return false;
+
+    auto it = points_.insert(next, p);
+    while (std::next(it) != points_.end() && std::next(it, 2) != points_.end() &&
+           ccw(p, *std::next(it), *std::next(it, 2)) != turn_)
+        points_.erase(std::next(it));
+    while (it != points_.begin() && std::prev(it) != points_.begin() &&
+           ccw(*std::prev(it, 2), *std::prev(it), p) != turn_)
+        points_.erase(std::prev(it));
+    return true;
+}
+
+lgm::Direction lgm::DynamicConvexHull::Chain::side(const lgm::Point &p) const {
+    auto next = points_.upper_bound(p);
+    if (next == points_.begin())
+        return Direction::CW;
+    auto prev = std::prev(next);
+    if (*prev == p)
+        return Direction::COLLINEAR;
+    if (next == points_.end())
+        return Direction::CW;
+    Direction d = ccw(*prev, *next, p);
+    return turn_ == Direction::CCW ? d : opposite(d);
+}
+
+const std::set<lgm::Point> &lgm::DynamicConvexHull::Chain::points() const {
+    return points_;
+}
+
+lgm::DynamicConvexHull::DynamicConvexHull() : lower_(Direction::CCW), upper_(Direction::CW) {}
+
+lgm::DynamicConvexHull::DynamicConvexHull(const std::vector<Point> &points) : DynamicConvexHull() {
+    for (const auto& p : points)
+        add(p);
+}
+
+bool lgm::DynamicConvexHull::add(const lgm::Point &p) {
+    bool lower = lower_.add(p);
+    bool upper = upper_.add(p);
+    return lower || upper;
+}
+
+lgm::Location lgm::DynamicConvexHull::locate(const lgm::Point &p) const {
+    if (lower_.points().empty())
+        return Location::OUTSIDE;
+    Direction lower = lower_.side(p);
+    Direction upper = upper_.side(p);
+    if (lower == Direction::CW || upper == Direction::CW)
+        return Location::OUTSIDE;
+    if (lower == Direction::COLLINEAR || upper == Direction::COLLINEAR)
+        return Location::BOUNDARY;
+    return Location::INSIDE;
+}
+
+bool lgm::DynamicConvexHull::contains(const lgm::Point &p) const {
+    return locate(p) != Location::OUTSIDE;
+}
+
+bool lgm::DynamicConvexHull::isBoundary(const lgm::Point &p) const {
+    return locate(p) == Location::BOUNDARY;
+}
+
+std::vector<lgm::Point> lgm::DynamicConvexHull::vertices() const {
+    std::vector<Point> result(lower_.points().begin(), lower_.points().end());
+    if (upper_.points().size() > 2)
+        result.insert(result.end(), std::next(upper_.points().rbegin()), std::prev(upper_.points().rend()));
+    return result;
+}
+
+lgm::ConvexPolygon lgm::DynamicConvexHull::polygon() const {
+    if (size() < 3)
+        throw std::logic_error("Convex hull has less than 3 vertices.");
+    return ConvexPolygon(vertices());
+}
+
+size_t lgm::DynamicConvexHull::size() const {
+    if (lower_.points().size() < 2)
+        return lower_.points().size();
+    return lower_.points().size() + upper_.points().size() - 2;
+}
@@ -0,0 +1,243 @@
+//
+// Thread-local metrics sinks and their aggregation.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "../headers/Metrics.h"
+
+namespace {
+    using lgm::OperationMetrics;
+    using lgm::LatencyHistogram;
+    using lgm::OPERATION_COUNT;
+
+    // A sink holds the counters of every operation in one flat array: the fields below, then the histogram
+    uint64_t OperationMetrics::* const FIELDS[] = {
+            &OperationMetrics::calls, &OperationMetrics::exceptions, &OperationMetrics::predicates,
+            &OperationMetrics::collinear, &OperationMetrics::exactFallbacks, &OperationMetrics::edges,
+            &OperationMetrics::searchSteps, &OperationMetrics::nanoseconds
+    };
+    const char* const FIELD_NAMES[] = {
+            "calls", "exceptions", "predicates", "collinear", "exactFallbacks", "edges", "searchSteps", "nanoseconds"
+    };
+    enum Field : size_t {
+        CALLS, EXCEPTIONS, PREDICATES, COLLINEAR, EXACT_FALLBACKS, EDGES, SEARCH_STEPS, NANOSECONDS, FIELD_COUNT
+    };
+    constexpr size_t SLOTS = FIELD_COUNT + LatencyHistogram::BUCKETS;
+
+    using Totals = std::vector<uint64_t>;
+
+    struct Sink;
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<Sink*> sinks;
+        Totals retired = Totals(OPERATION_COUNT * SLOTS, 0);   // sinks of the threads that have exited
+        Totals baseline = Totals(OPERATION_COUNT * SLOTS, 0);  // totals at the last reset
+    };
+
+    // Never destroyed, so that threads outliving static destruction still find it
+    Registry& registry() {
+        static Registry* registry = new Registry;
+        return *registry;
+    }
+
+    /*
+     * Written only by its own thread. Relaxed atomics compile to plain loads and stores but let a snapshot read
+     * the counters while they change.
+     */
+    struct Sink {
+        std::atomic<uint64_t> values[OPERATION_COUNT * SLOTS];
+
+        Sink() {
+            for (auto& v : values)
+                v.store(0, std::memory_order_relaxed);
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.sinks.push_back(this);
+        }
+
+        ~Sink() {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            addTo(r.retired);
+            for (size_t i = 0; i < r.sinks.size(); ++i) {
+                if (r.sinks[i] == this) {
+                    r.sinks[i] = r.sinks.back();
+                    r.sinks.pop_back();
+                    break;
+                }
+            }
+        }
+
+        uint64_t get(lgm::Operation operation, size_t slot) const {
+            return values[static_cast<size_t>(operation) * SLOTS + slot].load(std::memory_order_relaxed);
+        }
+
+        void add(lgm::Operation operation, size_t slot, uint64_t count) {
+            std::atomic<uint64_t>& v = values[static_cast<size_t>(operation) * SLOTS + slot];
+            v.store(v.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        }
+
+        void addTo(Totals& totals) const {
+            for (size_t i = 0; i < totals.size(); ++i)
+                totals[i] += values[i].load(std::memory_order_relaxed);
+        }
+    };
+
+    Sink& sink() {
+        static thread_local Sink sink;
+        return sink;
+    }
+
+    // Caller holds the registry lock
+    Totals totals(const Registry& r) {
+        Totals result = r.retired;
+        for (const Sink* s : r.sinks)
+            s->addTo(result);
+        return result;
+    }
+
+    uint64_t now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    int uncaughtExceptions() {
+#if __cplusplus >= 201703L
+        return std::uncaught_exceptions();
+#else
+        return std::uncaught_exception() ? 1 : 0;
+#endif
+    }
+}
+
+const size_t lgm::LatencyHistogram::BUCKETS;
+
+size_t lgm::LatencyHistogram::bucket(uint64_t nanoseconds) {
+    size_t b = 0;
+    while (nanoseconds != 0 && b + 1 < BUCKETS) {
+        nanoseconds >>= 1;
+        ++b;
+    }
+    return b;
+}
+
+uint64_t lgm::LatencyHistogram::total() const {
+    uint64_t total = 0;
+    for (uint64_t c : counts)
+        total += c;
+    return total;
+}
+
+uint64_t lgm::LatencyHistogram::quantile(double q) const {
+    if (!(q >= 0 && q <= 1))
+        throw std::invalid_argument("Quantile must be between 0 and 1.");
+    const uint64_t total = this->total();
+    if (total == 0)
+        return 0;
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(total))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen >= rank)
+            return i == 0 ? 0 : uint64_t(1) << i;
+    }
+    return uint64_t(1) << (BUCKETS - 1);
+}
+
+const lgm::OperationMetrics &lgm::MetricsSnapshot::operator[](Operation operation) const {
+    return operations[static_cast<size_t>(operation)];
+}
+
+std::string lgm::MetricsSnapshot::toJson() const {
+    std::ostringstream out;
+    out << "{";
+    for (size_t op = 0; op < OPERATION_COUNT; ++op) {
+        const OperationMetrics& m = operations[op];
+        out << (op ? ", " : "") << "\"" << operationName(static_cast<Operation>(op)) << "\": {";
+        for (size_t f = 0; f < FIELD_COUNT; ++f)
+            out << "\"" << FIELD_NAMES[f] << "\": " << m.*FIELDS[f] << ", ";
+        out << "\"latency\": [";
+        for (size_t b = 0; b < LatencyHistogram::BUCKETS; ++b)
+            out << (b ? ", " : "") << m.latency.counts[b];
+        out << "]}";
+    }
+    out << "}";
+    return out.str();
+}
+
+const char *lgm::operationName(Operation operation) {
+    switch (operation) {
+        case Operation::POLYGON_CONTAINS:
+            return "polygon_contains";
+        case Operation::CONVEX_POLYGON_CONTAINS:
+            return "convex_polygon_contains";
+        case Operation::MODIFIED_GRAHAM_SCAN:
+            return "modified_graham_scan";
+    }
+    throw std::invalid_argument("Unknown operation.");
+}
+
+lgm::MetricsSnapshot lgm::metricsSnapshot() {
+    Totals current;
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        current = totals(r);
+        for (size_t i = 0; i < current.size(); ++i)
+            current[i] -= r.baseline[i];
+    }
+    MetricsSnapshot snapshot;
+    for (size_t op = 0; op < OPERATION_COUNT; ++op) {
+        const uint64_t* slots = &current[op * SLOTS];
+        for (size_t f = 0; f < FIELD_COUNT; ++f)
+            snapshot.operations[op].*FIELDS[f] = slots[f];
+        for (size_t b = 0; b < LatencyHistogram::BUCKETS; ++b)
+            snapshot.operations[op].latency.counts[b] = slots[FIELD_COUNT + b];
+    }
+    return snapshot;
+}
+
+void lgm::resetMetrics() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.baseline = totals(r);
+}
+
+lgm::detail::MetricsScope::MetricsScope(Operation operation)
+        : operation_(operation), exceptions_(uncaughtExceptions()),
+          timed_(sink().get(operation, CALLS) % LATENCY_SAMPLING == 0), start_(timed_ ? now() : 0),
+          predicates_(ThreadPredicates<>::tally) {}
+
+lgm::detail::MetricsScope::~MetricsScope() {
+    const PredicateTally& tally = ThreadPredicates<>::tally;
+    Sink& s = sink();
+    if (timed_) {
+        const uint64_t elapsed = now() - start_;
+        s.add(operation_, NANOSECONDS, elapsed);
+        s.add(operation_, FIELD_COUNT + LatencyHistogram::bucket(elapsed), 1);
+    }
+    s.add(operation_, CALLS, 1);
+    if (uncaughtExceptions() > exceptions_)
+        s.add(operation_, EXCEPTIONS, 1);
+    s.add(operation_, PREDICATES, tally.calls - predicates_.calls);
+    s.add(operation_, COLLINEAR, tally.collinear - predicates_.collinear);
+    s.add(operation_, EXACT_FALLBACKS, tally.exactFallbacks - predicates_.exactFallbacks);
+}
+
+void lgm::detail::MetricsScope::edges(uint64_t count) {
+    sink().add(operation_, EDGES, count);
+}
+
+void lgm::detail::MetricsScope::searchSteps(uint64_t count) {
+    sink().add(operation_, SEARCH_STEPS, count);
+}
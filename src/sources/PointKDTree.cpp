@@ -0,0 +1,266 @@
+//
+// Static 2-d tree with implicit nodes.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+
+#include "../headers/PointKDTree.h"
+#include "../headers/Parallel.h"
+
+namespace {
+    using lgm::Point;
+
+    const size_t NONE = std::numeric_limits<size_t>::max();
+
+    double coordinate(const Point& p, uint8_t axis) {
+        return axis == 0 ? p.x : p.y;
+    }
+
+    double squaredDistance(const Point& a, const Point& b) {
+        double dx = a.x - b.x, dy = a.y - b.y;
+        return dx * dx + dy * dy;
+    }
+
+    // Subtree [lo, hi) and a lower bound of the squared distance from the query to its points
+    struct Range {
+        size_t lo;
+        size_t hi;
+        double bound;
+    };
+
+    // Ranges halve at every level, so a stack of 2 * 64 entries never overflows
+    const size_t STACK = 128;
+
+    template<typename Query>
+    std::vector<std::vector<size_t>> batch(size_t count, size_t threads, Query query) {
+        std::vector<std::vector<size_t>> result(count);
+        threads = lgm::detail::threadCount(threads, count, 256);
+        lgm::detail::parallelFor(threads, [&](size_t t) {
+            for (size_t i = count * t / threads; i < count * (t + 1) / threads; ++i)
+                result[i] = query(i);
+        });
+        return result;
+    }
+}
+
+lgm::PointKDTree::PointKDTree(const std::vector<Point> &points) {
+    auto start = std::chrono::steady_clock::now();
+    if (points.size() > std::numeric_limits<uint32_t>::max())
+        throw std::invalid_argument("PointKDTree supports up to 2^32 - 1 points.");
+    std::vector<uint32_t> order(points.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = static_cast<uint32_t>(i);
+    axes_.assign(points.size(), 0);
+    build(0, points.size(), order, points);
+
+    points_.resize(points.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        points_[i] = points[order[i]];
+    ids_ = std::move(order);
+    buildTime_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void lgm::PointKDTree::build(size_t lo, size_t hi, std::vector<uint32_t> &order, const std::vector<Point> &points) {
+    while (hi - lo > LEAF) {
+        BoundingBox box;
+        for (size_t i = lo; i < hi; ++i)
+            box.add(points[order[i]]);
+        auto axis = static_cast<uint8_t>(box.maxX - box.minX >= box.maxY - box.minY ? 0 : 1);
+        size_t median = lo + (hi - lo) / 2;
+        std::nth_element(order.begin() + lo, order.begin() + median, order.begin() + hi, [&](uint32_t a, uint32_t b) {
+            return coordinate(points[a], axis) < coordinate(points[b], axis);
+        });
+        axes_[median] = axis;
+        build(lo, median, order, points);
+        lo = median + 1;
+    }
+}
+
+template<typename Visit>
+void lgm::PointKDTree::search(const BoundingBox &box, Visit&& visit) const {
+    if (points_.empty())
+        return;
+    Range stack[STACK];
+    size_t depth = 0;
+    stack[depth++] = Range{0, points_.size(), 0};
+    while (depth > 0) {
+        Range range = stack[--depth];
+        if (range.hi - range.lo <= LEAF) {
+            for (size_t i = range.lo; i < range.hi; ++i)
+                if (box.contains(points_[i]))
+                    visit(i);
+            continue;
+        }
+        size_t median = range.lo + (range.hi - range.lo) / 2;
+        uint8_t axis = axes_[median];
+        double split = coordinate(points_[median], axis);
+        if (box.contains(points_[median]))
+            visit(median);
+        if ((axis == 0 ? box.minX : box.minY) <= split)
+            stack[depth++] = Range{range.lo, median, 0};
+        if ((axis == 0 ? box.maxX : box.maxY) >= split)
+            stack[depth++] = Range{median + 1, range.hi, 0};
+    }
+}
+
+std::vector<size_t> lgm::PointKDTree::nearest(const Point &p, size_t k) const {
+    std::vector<size_t> result;
+    k = std::min(k, points_.size());
+    if (k == 0)
+        return result;
+
+    // Max-heap of the best k as (squared distance, input index), so the worst one is on top
+    std::vector<std::pair<double, uint32_t>> heap;
+    heap.reserve(k);
+    auto offer = [&](size_t i) {
+        std::pair<double, uint32_t> candidate(squaredDistance(points_[i], p), ids_[i]);
+        if (heap.size() < k) {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end());
+        } else if (candidate < heap.front()) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = candidate;
+            std::push_heap(heap.begin(), heap.end());
+        }
+    };
+    // A range can only help if it may hold a point at most as far as the worst one kept
+    auto useful = [&](double bound) {
+        return heap.size() < k || bound <= heap.front().first;
+    };
+
+    Range stack[STACK];
+    size_t depth = 0;
+    stack[depth++] = Range{0, points_.size(), 0};
+    while (depth > 0) {
+        Range range = stack[--depth];
+        if (!useful(range.bound))
+            continue;
+        if (range.hi - range.lo <= LEAF) {
+            for (size_t i = range.lo; i < range.hi; ++i)
+                offer(i);
+            continue;
+        }
+        size_t median = range.lo + (range.hi - range.lo) / 2;
+        uint8_t axis = axes_[median];
+        double diff = coordinate(p, axis) - coordinate(points_[median], axis);
+        offer(median);
+        Range left{range.lo, median, range.bound}, right{median + 1, range.hi, range.bound};
+        // The far side is at least |diff| away; the near side is pushed last to be searched first
+        Range& far = diff < 0 ? right : left;
+        far.bound = std::max(far.bound, diff * diff);
+        stack[depth++] = far;
+        stack[depth++] = diff < 0 ? left : right;
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+    result.reserve(heap.size());
+    for (const auto& entry : heap)
+        result.push_back(entry.second);
+    return result;
+}
+
+std::vector<size_t> lgm::PointKDTree::withinRadius(const Point &p, double radius) const {
+    std::vector<size_t> result;
+    const double squared = radius * radius;
+    search(BoundingBox(p.x - radius, p.y - radius, p.x + radius, p.y + radius), [&](size_t i) {
+        if (squaredDistance(points_[i], p) <= squared)
+            result.push_back(ids_[i]);
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<size_t> lgm::PointKDTree::inside(const BoundingBox &box) const {
+    std::vector<size_t> result;
+    search(box, [&](size_t i) {
+        result.push_back(ids_[i]);
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void lgm::PointKDTree::nearestOther(size_t self, double &best, size_t &other) const {
+    const Point& p = points_[self];
+    Range stack[STACK];
+    size_t depth = 0;
+    stack[depth++] = Range{0, points_.size(), 0};
+    auto offer = [&](size_t i) {
+        if (i == self)
+            return;
+        double d = squaredDistance(points_[i], p);
+        if (d < best || (d == best && (other == NONE || ids_[i] < ids_[other]))) {
+            best = d;
+            other = i;
+        }
+    };
+    while (depth > 0) {
+        Range range = stack[--depth];
+        if (range.bound > best)
+            continue;
+        if (range.hi - range.lo <= LEAF) {
+            for (size_t i = range.lo; i < range.hi; ++i)
+                offer(i);
+            continue;
+        }
+        size_t median = range.lo + (range.hi - range.lo) / 2;
+        uint8_t axis = axes_[median];
+        double diff = coordinate(p, axis) - coordinate(points_[median], axis);
+        offer(median);
+        Range left{range.lo, median, range.bound}, right{median + 1, range.hi, range.bound};
+        Range& far = diff < 0 ? right : left;
+        far.bound = std::max(far.bound, diff * diff);
+        stack[depth++] = far;
+        stack[depth++] = diff < 0 ? left : right;
+    }
+}
+
+std::pair<size_t, size_t> lgm::PointKDTree::closestPair() const {
+    if (points_.size() < 2)
+        throw std::logic_error("Closest pair of fewer than two points.");
+    // Every point looks for a neighbour closer than the best pair so far, so most searches end near the point
+    double best = std::numeric_limits<double>::infinity();
+    std::pair<size_t, size_t> result(NONE, NONE);
+    for (size_t i = 0; i < points_.size(); ++i) {
+        double distance = best;
+        size_t other = NONE;
+        nearestOther(i, distance, other);
+        if (other == NONE)
+            continue;
+        std::pair<size_t, size_t> pair(std::min(ids_[i], ids_[other]), std::max(ids_[i], ids_[other]));
+        if (distance < best || (distance == best && pair < result)) {
+            best = distance;
+            result = pair;
+        }
+    }
+    return result;
+}
+
+std::vector<std::vector<size_t>> lgm::PointKDTree::nearest(const std::vector<Point> &queries, size_t k,
+                                                           size_t threads) const {
+    return batch(queries.size(), threads, [&](size_t i) {
+        return nearest(queries[i], k);
+    });
+}
+
+std::vector<std::vector<size_t>> lgm::PointKDTree::withinRadius(const std::vector<Point> &queries, double radius,
+                                                                size_t threads) const {
+    return batch(queries.size(), threads, [&](size_t i) {
+        return withinRadius(queries[i], radius);
+    });
+}
+
+size_t lgm::PointKDTree::size() const {
+    return points_.size();
+}
+
+double lgm::PointKDTree::buildTime() const {
+    return buildTime_;
+}
+
+size_t lgm::PointKDTree::memoryUsage() const {
+    return points_.capacity() * sizeof(Point) + ids_.capacity() * sizeof(uint32_t) +
+           axes_.capacity() * sizeof(uint8_t);
+}
@@ -0,0 +1,150 @@
+//
+// Segment tree point location for lgm::Polygon.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include "../headers/PointLocationIndex.h"
+#include "../headers/Polygon.h"
+
+namespace {
+    using lgm::Point;
+
+    double xAt(const Point& a, const Point& b, double y) {
+        return a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+    }
+}
+
+lgm::PointLocationIndex::PointLocationIndex(const std::vector<Point> &vertices) : leaves_(1) {
+    auto start = std::chrono::steady_clock::now();
+    if (vertices.size() < 3)
+        throw std::logic_error("PointLocationIndex requires 3 or more vertices.");
+    const size_t n = vertices.size();
+    auto edgeStart = [&](uint32_t e) -> const Point& { return vertices[e]; };
+    auto edgeEnd   = [&](uint32_t e) -> const Point& { return vertices[e + 1 == n ? 0 : e + 1]; };
+
+    ys_.reserve(n);
+    for (const auto& v : vertices)
+        ys_.push_back(v.y);
+    std::sort(ys_.begin(), ys_.end());
+    ys_.erase(std::unique(ys_.begin(), ys_.end()), ys_.end());
+    ys_.shrink_to_fit();
+
+    // Leaf j (1 <= j < ys_.size()) is the slab (ys_[j - 1], ys_[j]]; leaf 0 is never covered
+    while (leaves_ < ys_.size())
+        leaves_ *= 2;
+
+    // Every edge covers leaves (index(minY), index(maxY)] - the same half-open range contains() tests
+    auto forEachNode = [&](uint32_t e, auto&& visit) {
+        const Point& a = edgeStart(e);
+        const Point& b = edgeEnd(e);
+        size_t l = std::lower_bound(ys_.begin(), ys_.end(), std::min(a.y, b.y)) - ys_.begin() + 1;
+        size_t r = std::lower_bound(ys_.begin(), ys_.end(), std::max(a.y, b.y)) - ys_.begin() + 1;
+        for (l += leaves_, r += leaves_; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) visit(l++);
+            if (r & 1) visit(--r);
+        }
+    };
+
+    std::vector<uint32_t> counts(2 * leaves_ + 1, 0);
+    for (uint32_t e = 0; e < n; ++e) {
+        if (edgeStart(e).y == edgeEnd(e).y)
+            horizontal_.push_back(e);
+        else
+            forEachNode(e, [&](size_t v) { counts[v + 1]++; });
+    }
+    for (size_t v = 1; v < counts.size(); ++v)
+        counts[v] += counts[v - 1];
+    nodeOffsets_ = counts;
+    edges_.resize(nodeOffsets_.back());
+    for (uint32_t e = 0; e < n; ++e) {
+        if (edgeStart(e).y != edgeEnd(e).y)
+            forEachNode(e, [&](size_t v) { edges_[counts[v]++] = e; });
+    }
+
+    // Edges of a simple polygon spanning a common slab do not cross inside it, so comparing them anywhere in the
+    // overlap of their y ranges gives the same left-to-right order
+    auto leftOf = [&](uint32_t lhs, uint32_t rhs) {
+        const Point& a = edgeStart(lhs);
+        const Point& b = edgeEnd(lhs);
+        const Point& c = edgeStart(rhs);
+        const Point& d = edgeEnd(rhs);
+        double low  = std::max(std::min(a.y, b.y), std::min(c.y, d.y));
+        double high = std::min(std::max(a.y, b.y), std::max(c.y, d.y));
+        double y = (low + high) / 2;
+        return xAt(a, b, y) < xAt(c, d, y);
+    };
+    for (size_t v = 1; v < 2 * leaves_; ++v)
+        std::sort(edges_.begin() + nodeOffsets_[v], edges_.begin() + nodeOffsets_[v + 1], leftOf);
+
+    std::sort(horizontal_.begin(), horizontal_.end(), [&](uint32_t lhs, uint32_t rhs) {
+        return std::make_pair(edgeStart(lhs).y, std::min(edgeStart(lhs).x, edgeEnd(lhs).x)) <
+               std::make_pair(edgeStart(rhs).y, std::min(edgeStart(rhs).x, edgeEnd(rhs).x));
+    });
+    horizontal_.shrink_to_fit();
+
+    sortedVertices_.resize(n);
+    for (uint32_t i = 0; i < n; ++i)
+        sortedVertices_[i] = i;
+    std::sort(sortedVertices_.begin(), sortedVertices_.end(), [&](uint32_t lhs, uint32_t rhs) {
+        return vertices[lhs] < vertices[rhs];
+    });
+
+    buildTime_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+lgm::Location lgm::PointLocationIndex::locate(const std::vector<Point> &vertices, const Point &p) const {
+    const size_t n = vertices.size();
+    auto edgeStart = [&](uint32_t e) -> const Point& { return vertices[e]; };
+    auto edgeEnd   = [&](uint32_t e) -> const Point& { return vertices[e + 1 == n ? 0 : e + 1]; };
+
+    auto vertex = std::lower_bound(sortedVertices_.begin(), sortedVertices_.end(), p, [&](uint32_t i, const Point& q) {
+        return vertices[i] < q;
+    });
+    if (vertex != sortedVertices_.end() && vertices[*vertex] == p)
+        return Location::BOUNDARY;
+
+    auto horizontal = std::upper_bound(horizontal_.begin(), horizontal_.end(), p, [&](const Point& q, uint32_t e) {
+        return std::make_pair(q.y, q.x) < std::make_pair(edgeStart(e).y, std::min(edgeStart(e).x, edgeEnd(e).x));
+    });
+    if (horizontal != horizontal_.begin() && onSegment(edgeStart(*(horizontal - 1)), edgeEnd(*(horizontal - 1)), p))
+        return Location::BOUNDARY;
+
+    size_t leaf = std::lower_bound(ys_.begin(), ys_.end(), p.y) - ys_.begin();
+    if (leaf == 0 || leaf == ys_.size())
+        return Location::OUTSIDE;
+
+    Point left = p;
+    left.x = Polygon::RAY_ORIGIN_X;
+    // Same crossing predicate as Polygon::contains: true for edges between the ray origin and p
+    auto crossed = [&](uint32_t e) {
+        return ccw(edgeStart(e), edgeEnd(e), p) != ccw(edgeStart(e), edgeEnd(e), left);
+    };
+
+    size_t crossings = 0;
+    for (size_t v = leaf + leaves_; v > 0; v >>= 1) {
+        auto first = edges_.begin() + nodeOffsets_[v];
+        auto last  = edges_.begin() + nodeOffsets_[v + 1];
+        auto split = std::partition_point(first, last, crossed);
+        if (split != first) {
+            const Point& a = edgeStart(*(split - 1));
+            const Point& b = edgeEnd(*(split - 1));
+            if (ccw(a, b, p) == Direction::COLLINEAR && onSegment(a, b, p))
+                return Location::BOUNDARY;
+        }
+        crossings += split - first;
+    }
+    return crossings % 2 == 1 ? Location::INSIDE : Location::OUTSIDE;
+}
+
+double lgm::PointLocationIndex::buildTime() const {
+    return buildTime_;
+}
+
+size_t lgm::PointLocationIndex::memoryUsage() const {
+    return ys_.capacity() * sizeof(double) +
+           (nodeOffsets_.capacity() + edges_.capacity() + horizontal_.capacity() + sortedVertices_.capacity()) *
+           sizeof(uint32_t);
+}
@@ -5,112 +5,209 @@
 #include <stdexcept>
 #include <string>
 #include <algorithm>
+#include <cmath>
 #include "../headers/Polygon.h"
+#include "../headers/Metrics.h"
+#include "../headers/Ring.h"
+
+namespace {
+    using lgm::Point;
+
+    std::vector<Point> startVertices(const std::vector<lgm::Segment>& edges) {
+        if (edges.size() <= 2)
+            throw std::logic_error("Polygon must have 3 or more edges. "
+                                   "Number of edges provided: " + std::to_string(edges.size()));
+        if (edges.front().start() != edges.back().end())
+            throw std::invalid_argument("Start vertex of the first edge must be the end vertex of the last edge.");
+
+        std::vector<Point> vertices;
+        vertices.reserve(edges.size());
+        for (const auto& edge : edges)
+            vertices.push_back(edge.start());
+        return vertices;
+    }
+}
 
 lgm::Polygon::Polygon(std::vector<Point> vertices) : vertices_(std::move(vertices)) {
-    if (vertices_.size() < 3)
-        throw std::logic_error("Polygon must have 3 or more vertices. "
-                               "Number of vertices provided: " + std::to_string(vertices.size()));
-    for (size_t i = 0; i < vertices_.size(); ++i) {
-        edges_.emplace_back(vertices_[i], vertices_[(i + 1) % vertices_.size()]);
+    detail::checkRing(vertices_.data(), vertices_.size());
+}
+
+lgm::Polygon::Polygon(const std::vector<Segment>& edges) : Polygon(startVertices(edges)) {}
+
+lgm::Polygon::Polygon(std::vector<Point> vertices, Unchecked) : vertices_(std::move(vertices)) {}
 
-        if (ccw(edges_[i], vertices_[(i + 2) % vertices_.size()]) == Direction::COLLINEAR) {
-            throw std::invalid_argument("Three consecutive collinear points are not supported yet.");
-        }
+lgm::Polygon::Polygon(const Polygon &other)
+        : vertices_(other.vertices_), properties_(std::atomic_load(&other.properties_)), index_(other.index_),
+          grid_(other.grid_) {}
+
+lgm::Polygon &lgm::Polygon::operator=(const Polygon &other) {
+    vertices_ = other.vertices_;
+    properties_ = std::atomic_load(&other.properties_);
+    index_ = other.index_;
+    grid_ = other.grid_;
+    return *this;
+}
+
+lgm::Polygon::Properties::Properties(const Point *vertices, size_t size)
+        : signedArea2(0), centroidX(0), centroidY(0), openPerimeter(0), lowest(0) {
+    boundingBox.add(vertices[0]);
+    for (size_t i = 0; i + 1 < size; ++i) {
+        extend(vertices[0], vertices[i], vertices[i + 1]);
+        if (vertices[i + 1] < vertices[lowest])
+            lowest = i + 1;
     }
-    isClockwise = ccw(edges_.front(), vertices_[2]) == Direction::CW;
 }
 
-lgm::Polygon::Polygon(const std::vector<Segment>& edges) {
-    if (edges_.size() <= 2)
-        throw std::logic_error("Polygon must have 3 or more edges. "
-                               "Number of edges provided: " + std::to_string(edges.size()));
-    if (edges_.front().start() != edges_.back().end())
-        throw std::invalid_argument("Start vertex of the first edge must be the end vertex of the last edge.");
+void lgm::Polygon::Properties::extend(const Point &origin, const Point &a, const Point &b) {
+    const Point u = a - origin, v = b - origin;
+    const double term = cross(u, v);
+    signedArea2 += term;
+    centroidX += (u.x + v.x) * term;
+    centroidY += (u.y + v.y) * term;
+    openPerimeter += distance(a, b);
+    boundingBox.add(b);
+}
 
-    vertices_.reserve(edges_.size());
-    for (size_t i = 0; i < vertices_.size(); ++i) {
-        vertices_[i] = edges[i].start();
+const lgm::Polygon::Properties &lgm::Polygon::properties() const {
+    std::shared_ptr<Properties> properties = std::atomic_load(&properties_);
+    if (!properties) {
+        // Threads racing here compute the same sums, and all of them go on with the ones stored first
+        auto computed = std::make_shared<Properties>(vertices_.data(), vertices_.size());
+        if (std::atomic_compare_exchange_strong(&properties_, &properties, computed))
+            properties = computed;
     }
-    for (size_t i = 0; i < vertices_.size(); ++i) {
-        edges_.emplace_back(vertices_[i], vertices_[(i + 1) % vertices_.size()]);
+    return *properties;
+}
 
-        if (ccw(edges_[i], vertices_[(i + 2) % vertices_.size()]) == Direction::COLLINEAR) {
-            throw std::invalid_argument("Three consecutive collinear points are not supported yet.");
-        }
-    }
-    if (ccw(edges_.front(), vertices_[2]) == Direction::CW)
-        isClockwise = true;
+void lgm::Polygon::dropProperties() {
+    properties_.reset();
 }
 
 double lgm::Polygon::area() const {
-    double area = 0;
-    for (const auto &edge : edges_) {
-        area += cross(edge.start(), edge.end());
-    }
-    return abs(area) / 2;
+    return std::abs(properties().signedArea2) / 2;
 }
 
 double lgm::Polygon::perimeter() const {
-    double perimeter = 0;
-    for (const auto &edge : edges_) {
-        perimeter += edge.length();
-    }
-    return perimeter;
+    return properties().openPerimeter + distance(vertices_.back(), vertices_.front());
 }
 
-bool lgm::Polygon::contains(const lgm::Point &p) const {
-    Point left = p;
-    left.x = -1e5;
-
-    size_t numberOfCrosses = 0;
+const lgm::BoundingBox &lgm::Polygon::boundingBox() const {
+    return properties().boundingBox;
+}
 
-    for (const auto & edge : edges_) {
-        Direction p_sgn    = ccw(edge, p);
-        Direction left_sgn = ccw(edge, left);
+lgm::Point lgm::Polygon::centroid() const {
+    const Properties& properties = this->properties();
+    const double scale = 3 * properties.signedArea2;
+    return Point(vertices_[0].x + properties.centroidX / scale, vertices_[0].y + properties.centroidY / scale);
+}
 
-        // Point is on border
-        if (p_sgn == Direction::COLLINEAR && onSegment(edge, p))
-            return true;
+lgm::Direction lgm::Polygon::orientation() const {
+    const size_t n = vertices_.size(), i = properties().lowest;
+    return ccw(vertices_[i == 0 ? n - 1 : i - 1], vertices_[i], vertices_[i + 1 == n ? 0 : i + 1]);
+}
 
-        if (p_sgn != left_sgn && p.y > std::min(edge.start().y, edge.end().y) &&
-            p.y <= std::max(edge.start().y, edge.end().y)) {
-            numberOfCrosses++;
-        }
-    }
-    return (numberOfCrosses % 2 == 1);
+bool lgm::Polygon::contains(const lgm::Point &p) const {
+    LGM_METRICS_SCOPE(Operation::POLYGON_CONTAINS);
+    if (grid_)
+        return grid_->locate(vertices_, p) != Location::OUTSIDE;
+    if (index_)
+        return index_->locate(vertices_, p) != Location::OUTSIDE;
+    if (!properties().boundingBox.contains(p))
+        return false;
+#ifdef LGM_METRICS
+    size_t edges = 0;
+    bool inside = detail::ringLocate(vertices_.data(), vertices_.size(), p, &edges) != Location::OUTSIDE;
+    LGM_METRICS_EDGES(edges);
+    return inside;
+#else
+    return detail::ringLocate(vertices_.data(), vertices_.size(), p) != Location::OUTSIDE;
+#endif
 }
 
 bool lgm::Polygon::isBoundary(const lgm::Point &p) const {
-    for (const auto & edge : edges_) {
-        Direction p_sgn = ccw(edge, p);
-        if (p_sgn == Direction::COLLINEAR && onSegment(edge, p))
-            return true;
-    }
-    return false;
+    if (grid_)
+        return grid_->locate(vertices_, p) == Location::BOUNDARY;
+    if (index_)
+        return index_->locate(vertices_, p) == Location::BOUNDARY;
+    if (!properties().boundingBox.contains(p))
+        return false;
+    return detail::ringIsBoundary(vertices_.data(), vertices_.size(), p);
 }
 
 void lgm::Polygon::add(const lgm::Point &p) {
-    if (ccw(edges_.back(), p) == Direction::COLLINEAR)
+    if (ccw(vertices_.back(), vertices_.front(), p) == Direction::COLLINEAR)
         throw std::invalid_argument("Three consecutive collinear points are not supported yet");
+    dropIndex();
+    dropGrid();
+    if (properties_) {
+        // Copies of the polygon may share the sums
+        if (properties_.use_count() > 1)
+            properties_ = std::make_shared<Properties>(*properties_);
+        if (p < vertices_[properties_->lowest])
+            properties_->lowest = vertices_.size();
+        properties_->extend(vertices_.front(), vertices_.back(), p);
+    }
     vertices_.emplace_back(p);
-    edges_.pop_back();
-    edges_.emplace_back(vertices_[vertices_.size() - 2], vertices_.back());
-    edges_.emplace_back(vertices_.back(), vertices_.front());
+}
+
+void lgm::Polygon::buildIndex() {
+    index_ = std::make_shared<const PointLocationIndex>(vertices_);
+}
+
+void lgm::Polygon::dropIndex() {
+    index_.reset();
+}
+
+const lgm::PointLocationIndex *lgm::Polygon::index() const {
+    return index_.get();
+}
+
+void lgm::Polygon::buildGrid(size_t memoryBudget) {
+    grid_ = std::make_shared<const ContainmentGrid>(vertices_, memoryBudget);
+}
+
+void lgm::Polygon::dropGrid() {
+    grid_.reset();
+}
+
+const lgm::ContainmentGrid *lgm::Polygon::grid() const {
+    return grid_.get();
 }
 
 const std::vector<lgm::Point> &lgm::Polygon::vertices() const {
     return vertices_;
 }
 
-const std::vector<lgm::RefSegment> &lgm::Polygon::edges() const {
-    return edges_;
+lgm::EdgeView lgm::Polygon::edges() const {
+    return EdgeView(vertices_);
 }
 
 size_t lgm::Polygon::size() const {
     return vertices_.size();
 }
 
+lgm::PolygonView::PolygonView(const Point *vertices, size_t size) : vertices_(vertices), size_(size) {
+    if (size < 3)
+        throw std::logic_error("Polygon must have 3 or more vertices. "
+                               "Number of vertices provided: " + std::to_string(size));
+}
+
+double lgm::PolygonView::area() const {
+    return detail::ringArea(vertices_, size_);
+}
+
+double lgm::PolygonView::perimeter() const {
+    return detail::ringPerimeter(vertices_, size_);
+}
+
+bool lgm::PolygonView::contains(const Point &p) const {
+    return detail::ringLocate(vertices_, size_, p) != Location::OUTSIDE;
+}
+
+bool lgm::PolygonView::isBoundary(const Point &p) const {
+    return detail::ringIsBoundary(vertices_, size_, p);
+}
+
 bool lgm::isConvex(const std::vector<lgm::Point> &vertices) {
     lgm::Direction origin_sgn = ccw(vertices[vertices.size() - 2], vertices.back(), vertices[0]);
     lgm::Direction sgn = ccw(vertices.back(), vertices[0], vertices[1]);
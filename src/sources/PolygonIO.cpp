@@ -0,0 +1,578 @@
+//
+// WKT and GeoJSON polygon reader and writer.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "../headers/PolygonIO.h"
+
+namespace {
+    bool isNumberChar(int c) {
+        return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+    }
+
+    bool isLetter(int c) {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+    }
+
+    void toUpper(std::string& s) {
+        for (auto& c : s)
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+
+    const double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const double MAX_EXACT = 9007199254740992.0;  // 2^53
+
+    /*
+     * Clinger's fast path: a decimal with at most 2^53 as digits and a power of ten up to 10^22 is exactly
+     * representable on both sides, so one division or multiplication gives the correctly rounded double.
+     * Returns false for anything else, strtod handles it then
+     */
+    bool parseFast(const char* s, double& value) {
+        bool negative = *s == '-';
+        if (*s == '-' || *s == '+')
+            ++s;
+        uint64_t mantissa = 0;
+        int digits = 0, exponent = 0;
+        bool any = false;
+        for (; *s >= '0' && *s <= '9'; ++s, any = true) {
+            if (mantissa != 0 && ++digits > 18)
+                return false;
+            mantissa = mantissa * 10 + (*s - '0');
+        }
+        if (*s == '.') {
+            for (++s; *s >= '0' && *s <= '9'; ++s, any = true) {
+                if (mantissa != 0 && ++digits > 18)
+                    return false;
+                mantissa = mantissa * 10 + (*s - '0');
+                --exponent;
+            }
+        }
+        if (!any)
+            return false;
+        if (*s == 'e' || *s == 'E') {
+            ++s;
+            bool negativeExponent = *s == '-';
+            if (*s == '-' || *s == '+')
+                ++s;
+            if (*s < '0' || *s > '9')
+                return false;
+            int e = 0;
+            for (; *s >= '0' && *s <= '9' && e < 1000; ++s)
+                e = e * 10 + (*s - '0');
+            exponent += negativeExponent ? -e : e;
+        }
+        if (*s != '\0' || mantissa > MAX_EXACT || exponent < -22 || exponent > 22)
+            return false;
+        double m = static_cast<double>(mantissa);
+        value = exponent < 0 ? m / POW10[-exponent] : m * POW10[exponent];
+        if (negative)
+            value = -value;
+        return true;
+    }
+
+    /*
+     * Writes value in fixed notation with the fewest decimals, up to 15, for which parsing gives back value exactly
+     * (the same argument as parseFast: r / 10^d is correctly rounded). Returns the length, 0 if there is no such form
+     */
+    int formatFast(double value, char* buffer) {
+        if (!(std::abs(value) < 1e15))
+            return 0;
+        for (int d = 0; d <= 15; ++d) {
+            double r = std::nearbyint(value * POW10[d]);
+            if (std::abs(r) >= MAX_EXACT || r / POW10[d] != value)
+                continue;
+            char digits[24];
+            int n = 0;
+            for (auto u = static_cast<uint64_t>(std::abs(r)); u != 0 || n <= d; u /= 10)
+                digits[n++] = static_cast<char>('0' + u % 10);
+            int length = 0;
+            if (r < 0)
+                buffer[length++] = '-';
+            for (int i = n - 1; i >= 0; --i) {
+                buffer[length++] = digits[i];
+                if (i == d && d > 0)
+                    buffer[length++] = '.';
+            }
+            return length;
+        }
+        return 0;
+    }
+
+    void appendUtf8(std::string& s, unsigned code) {
+        if (code < 0x80) {
+            s += static_cast<char>(code);
+        } else if (code < 0x800) {
+            s += static_cast<char>(0xc0 | code >> 6);
+            s += static_cast<char>(0x80 | (code & 0x3f));
+        } else {
+            s += static_cast<char>(0xe0 | code >> 12);
+            s += static_cast<char>(0x80 | (code >> 6 & 0x3f));
+            s += static_cast<char>(0x80 | (code & 0x3f));
+        }
+    }
+}
+
+lgm::PolygonReader::PolygonReader(std::istream &in, GeometryFormat format, size_t chunkSize)
+        : in_(&in), format_(format), chunk_(std::max<size_t>(chunkSize, 1)), begin_(chunk_.data()),
+          pos_(begin_), end_(begin_), consumed_(0), ready_(0), next_(0), depth_(0) {}
+
+lgm::PolygonReader::PolygonReader(const char *data, size_t size, GeometryFormat format)
+        : in_(nullptr), format_(format), begin_(data), pos_(data), end_(data + size), consumed_(0), ready_(0),
+          next_(0), depth_(0) {}
+
+bool lgm::PolygonReader::refill() {
+    if (!in_)
+        return false;
+    consumed_ += end_ - begin_;
+    in_->read(chunk_.data(), chunk_.size());
+    begin_ = pos_ = chunk_.data();
+    end_ = begin_ + in_->gcount();
+    return pos_ != end_;
+}
+
+int lgm::PolygonReader::peek() {
+    if (pos_ == end_ && !refill())
+        return EOF;
+    return static_cast<unsigned char>(*pos_);
+}
+
+int lgm::PolygonReader::get() {
+    int c = peek();
+    if (c != EOF)
+        ++pos_;
+    return c;
+}
+
+void lgm::PolygonReader::skipWhitespace() {
+    for (int c = peek(); c == ' ' || c == '\n' || c == '\r' || c == '\t'; c = peek())
+        ++pos_;
+}
+
+void lgm::PolygonReader::expect(char c) {
+    skipWhitespace();
+    int found = get();
+    if (found != c)
+        fail(std::string("expected '") + c + "', found " +
+             (found == EOF ? std::string("end of input") : "'" + std::string(1, static_cast<char>(found)) + "'"));
+}
+
+void lgm::PolygonReader::fail(const std::string &message) const {
+    throw std::invalid_argument(std::string(format_ == GeometryFormat::WKT ? "WKT" : "GeoJSON") +
+                                " error at offset " + std::to_string(offset()) + ": " + message + ".");
+}
+
+double lgm::PolygonReader::readNumber() {
+    skipWhitespace();
+    char buffer[64];
+    size_t n = 0;
+    for (int c = peek(); isNumberChar(c); c = peek()) {
+        if (n + 1 == sizeof(buffer))
+            fail("number is too long");
+        buffer[n++] = static_cast<char>(c);
+        ++pos_;
+    }
+    buffer[n] = '\0';
+    double value;
+    if (parseFast(buffer, value))
+        return value;
+    char* parsed;
+    value = std::strtod(buffer, &parsed);
+    if (n == 0 || parsed != buffer + n)
+        fail("expected a number");
+    return value;
+}
+
+void lgm::PolygonReader::readString(std::string &result) {
+    expect('"');
+    result.clear();
+    while (true) {
+        int c = get();
+        if (c == EOF)
+            fail("unterminated string");
+        if (c == '"')
+            return;
+        if (c != '\\') {
+            result += static_cast<char>(c);
+            continue;
+        }
+        c = get();
+        switch (c) {
+            case '"': case '\\': case '/': result += static_cast<char>(c); break;
+            case 'b': result += '\b'; break;
+            case 'f': result += '\f'; break;
+            case 'n': result += '\n'; break;
+            case 'r': result += '\r'; break;
+            case 't': result += '\t'; break;
+            case 'u': {
+                unsigned code = 0;
+                for (int i = 0; i < 4; ++i) {
+                    int h = get();
+                    if (!std::isxdigit(h))
+                        fail("invalid \\u escape");
+                    code = code * 16 + (h <= '9' ? h - '0' : (h | 0x20) - 'a' + 10);
+                }
+                appendUtf8(result, code);
+                break;
+            }
+            default:
+                fail("invalid escape sequence");
+        }
+    }
+}
+
+void lgm::PolygonReader::readWord(std::string &result) {
+    skipWhitespace();
+    result.clear();
+    for (int c = peek(); isLetter(c); c = peek()) {
+        result += static_cast<char>(c);
+        ++pos_;
+    }
+    if (result.empty())
+        fail("expected a keyword");
+}
+
+void lgm::PolygonReader::endRing(size_t start) {
+    if (points_.size() - start >= 2 && points_.back() == points_[start])
+        points_.pop_back();
+    rings_.push_back(points_.size());
+}
+
+bool lgm::PolygonReader::next() {
+    // Everything handed out: start over, keeping the capacity
+    if (next_ == rings_.size()) {
+        points_.clear();
+        rings_.clear();
+        ready_ = next_ = 0;
+    }
+    while (next_ == ready_) {
+        bool more = format_ == GeometryFormat::WKT ? parseWkt() : parseGeoJson();
+        if (!more)
+            return false;
+    }
+    size_t begin = next_ == 0 ? 0 : rings_[next_ - 1];
+    vertices_.assign(points_.begin() + begin, points_.begin() + rings_[next_]);
+    ++next_;
+    return true;
+}
+
+const std::vector<lgm::Point> &lgm::PolygonReader::vertices() const {
+    return vertices_;
+}
+
+lgm::Polygon lgm::PolygonReader::polygon(Validation validation) const {
+    return Polygon(vertices_, validation);
+}
+
+lgm::ConvexPolygon lgm::PolygonReader::convexPolygon() const {
+    return ConvexPolygon(vertices_);
+}
+
+size_t lgm::PolygonReader::offset() const {
+    return consumed_ + (pos_ - begin_);
+}
+
+// WKT: POLYGON [Z|M|ZM] (EMPTY | (ring)), MULTIPOLYGON [Z|M|ZM] (EMPTY | (polygon, ...))
+
+bool lgm::PolygonReader::parseWkt() {
+    skipWhitespace();
+    if (peek() == EOF)
+        return false;
+    readWord(token_);
+    toUpper(token_);
+    bool multi = token_ == "MULTIPOLYGON";
+    if (!multi && token_ != "POLYGON")
+        fail("expected POLYGON or MULTIPOLYGON, found " + token_);
+
+    skipWhitespace();
+    if (isLetter(peek())) {
+        readWord(token_);
+        toUpper(token_);
+        if (token_ == "Z" || token_ == "M" || token_ == "ZM") {
+            skipWhitespace();
+            if (isLetter(peek())) {
+                readWord(token_);
+                toUpper(token_);
+            }
+        }
+        if (token_ == "EMPTY")
+            return true;
+        if (token_ != "Z" && token_ != "M" && token_ != "ZM")
+            fail("unexpected " + token_);
+    }
+
+    if (multi) {
+        expect('(');
+        do {
+            parseWktPolygon();
+            skipWhitespace();
+        } while (peek() == ',' && get());
+        expect(')');
+    } else {
+        parseWktPolygon();
+    }
+    ready_ = rings_.size();
+    return true;
+}
+
+void lgm::PolygonReader::parseWktPolygon() {
+    skipWhitespace();
+    if (isLetter(peek())) {
+        readWord(token_);
+        toUpper(token_);
+        if (token_ != "EMPTY")
+            fail("unexpected " + token_);
+        return;
+    }
+    expect('(');
+    parseWktRing();
+    skipWhitespace();
+    if (peek() == ',')
+        fail("polygons with holes are not supported");
+    expect(')');
+}
+
+void lgm::PolygonReader::parseWktRing() {
+    expect('(');
+    size_t start = points_.size();
+    do {
+        double x = readNumber();
+        double y = readNumber();
+        // Z and M values
+        for (skipWhitespace(); isNumberChar(peek()); skipWhitespace())
+            readNumber();
+        points_.emplace_back(x, y);
+    } while (peek() == ',' && get());
+    expect(')');
+    endRing(start);
+}
+
+// GeoJSON: one token or value per call, so that next() can return as soon as a geometry object closes
+
+bool lgm::PolygonReader::parseGeoJson() {
+    skipWhitespace();
+    int c = peek();
+    if (depth_ == 0) {
+        // Several top level values are accepted, as in newline-delimited GeoJSON
+        if (c == EOF)
+            return false;
+        parseGeoJsonValue(nullptr);
+        return true;
+    }
+    if (c == EOF)
+        fail("unexpected end of input");
+
+    Frame& frame = stack_[depth_ - 1];
+    if (c == (frame.object ? '}' : ']')) {
+        ++pos_;
+        if (frame.object)
+            closeGeoJsonObject();
+        else
+            --depth_;
+        return true;
+    }
+    if (frame.count > 0)
+        expect(',');
+    if (frame.object) {
+        readString(key_);
+        expect(':');
+    }
+    ++frame.count;
+    parseGeoJsonValue(&frame);
+    return true;
+}
+
+void lgm::PolygonReader::parseGeoJsonValue(Frame *parent) {
+    skipWhitespace();
+    int c = peek();
+    bool member = parent && parent->object;
+    if (member && c == '[' && key_ == "coordinates") {
+        if (parent->coordinates)
+            fail("duplicate coordinates");
+        parent->coordinates = true;
+        parent->points = points_.size();
+        parent->rings = rings_.size();
+        parent->depth = parseCoordinates(*parent, 0);
+    } else if (member && c == '"' && key_ == "type") {
+        readString(parent->type);
+    } else if (c == '{' || c == '[') {
+        ++pos_;
+        if (depth_ == stack_.size())
+            stack_.emplace_back();
+        Frame& frame = stack_[depth_++];
+        frame.object = c == '{';
+        frame.count = 0;
+        frame.type.clear();
+        frame.coordinates = false;
+        frame.depth = 0;
+        frame.maxRings = 0;
+    } else if (c == '"') {
+        readString(token_);
+    } else if (c == '-' || (c >= '0' && c <= '9')) {
+        readNumber();
+    } else {
+        readWord(token_);
+        if (token_ != "true" && token_ != "false" && token_ != "null")
+            fail("unexpected " + token_);
+    }
+}
+
+// Nesting depth of the coordinates array: 1 for a position, 2 for a ring, 3 for a polygon, 0 for an empty array
+int lgm::PolygonReader::parseCoordinates(Frame &frame, int level) {
+    if (level > 8)
+        fail("coordinates are nested too deep");
+    expect('[');
+    skipWhitespace();
+    int c = peek();
+    if (c == ']') {
+        ++pos_;
+        return 0;
+    }
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        double x = readNumber();
+        expect(',');
+        double y = readNumber();
+        // Altitude and other values
+        for (skipWhitespace(); peek() == ','; skipWhitespace()) {
+            ++pos_;
+            readNumber();
+        }
+        expect(']');
+        points_.emplace_back(x, y);
+        return 1;
+    }
+
+    size_t start = points_.size();
+    size_t count = 0;
+    int depth = -1;
+    while (true) {
+        int element = parseCoordinates(frame, level + 1);
+        if (depth != -1 && element != depth)
+            fail("coordinates are nested inconsistently");
+        depth = element;
+        ++count;
+        skipWhitespace();
+        if (peek() != ',')
+            break;
+        ++pos_;
+    }
+    expect(']');
+
+    ++depth;
+    if (depth == 2)
+        endRing(start);
+    else if (depth == 3)
+        frame.maxRings = std::max(frame.maxRings, count);
+    return depth;
+}
+
+void lgm::PolygonReader::closeGeoJsonObject() {
+    Frame& frame = stack_[--depth_];
+    if (!frame.coordinates)
+        return;
+    bool polygon = frame.type == "Polygon";
+    if (polygon || frame.type == "MultiPolygon") {
+        int expected = polygon ? 3 : 4;
+        if (frame.depth != 0 && frame.depth != expected)
+            fail(frame.type + " coordinates must be nested " + std::to_string(expected) + " arrays deep");
+        if (frame.maxRings > 1)
+            fail("polygons with holes are not supported");
+        ready_ = rings_.size();
+    } else {
+        // Drop the positions of other geometries
+        points_.resize(std::min(points_.size(), frame.points));
+        rings_.resize(std::min(rings_.size(), frame.rings));
+    }
+}
+
+lgm::PolygonWriter::PolygonWriter(std::ostream &out, GeometryFormat format)
+        : out_(out), format_(format), count_(0), closed_(false) {}
+
+lgm::PolygonWriter::~PolygonWriter() {
+    if (closed_)
+        return;
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void lgm::PolygonWriter::number(double value) {
+    if (!std::isfinite(value))
+        throw std::invalid_argument("Cannot write a non-finite coordinate.");
+    char buffer[32];
+    int n = formatFast(value, buffer);
+    if (n == 0)
+        n = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    line_.append(buffer, n);
+}
+
+void lgm::PolygonWriter::write(const Point *vertices, size_t size) {
+    if (closed_)
+        throw std::logic_error("PolygonWriter is closed.");
+    line_.clear();
+    if (format_ == GeometryFormat::WKT) {
+        line_ += "POLYGON ((";
+        for (size_t i = 0; i <= size; ++i) {
+            const Point& p = vertices[i == size ? 0 : i];
+            number(p.x);
+            line_ += ' ';
+            number(p.y);
+            line_ += i == size ? "))\n" : ", ";
+        }
+    } else {
+        line_ += count_ == 0 ? "{\"type\":\"FeatureCollection\",\"features\":[\n" : ",\n";
+        line_ += "{\"type\":\"Feature\",\"properties\":{},\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[[";
+        for (size_t i = 0; i <= size; ++i) {
+            const Point& p = vertices[i == size ? 0 : i];
+            line_ += '[';
+            number(p.x);
+            line_ += ',';
+            number(p.y);
+            line_ += i == size ? "]" : "],";
+        }
+        line_ += "]]}}";
+    }
+    out_.write(line_.data(), line_.size());
+    ++count_;
+}
+
+void lgm::PolygonWriter::write(const Polygon &polygon) {
+    write(polygon.vertices().data(), polygon.size());
+}
+
+void lgm::PolygonWriter::write(const PolygonView &polygon) {
+    write(polygon.begin(), polygon.size());
+}
+
+void lgm::PolygonWriter::close() {
+    if (closed_)
+        return;
+    closed_ = true;
+    if (format_ == GeometryFormat::GEOJSON)
+        out_ << (count_ == 0 ? "{\"type\":\"FeatureCollection\",\"features\":[\n]}\n" : "\n]}\n");
+    if (!out_)
+        throw std::runtime_error("Cannot write polygons.");
+}
+
+std::vector<lgm::Polygon> lgm::readPolygons(std::istream &in, GeometryFormat format) {
+    std::vector<Polygon> polygons;
+    PolygonReader reader(in, format);
+    while (reader.next())
+        polygons.push_back(reader.polygon());
+    return polygons;
+}
+
+void lgm::writePolygons(std::ostream &out, const std::vector<Polygon> &polygons, GeometryFormat format) {
+    PolygonWriter writer(out, format);
+    for (const auto& polygon : polygons)
+        writer.write(polygon);
+    writer.close();
+}
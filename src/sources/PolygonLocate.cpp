@@ -0,0 +1,262 @@
+//
+// Batch point location for lgm::Polygon.
+//
+// Every kernel below evaluates exactly the same expressions as Polygon::contains()/isBoundary(). The orientation
+// determinants go through the floating-point filter of orient2d(), and the few lanes it cannot decide are handed to
+// orient2d() itself, so SIMD and scalar paths agree exactly.
+//
+
+#include <algorithm>
+
+#include "../headers/Polygon.h"
+#include "../headers/Predicates.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LGM_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define LGM_HAS_AVX2
+#define LGM_AVX2_TARGET
+#include <immintrin.h>
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LGM_HAS_AVX2
+#define LGM_AVX2_DISPATCH
+#define LGM_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+namespace {
+    using lgm::Point;
+    using lgm::Location;
+    using lgm::Direction;
+
+    Location toLocation(bool boundary, bool odd) {
+        if (boundary) return Location::BOUNDARY;
+        return odd ? Location::INSIDE : Location::OUTSIDE;
+    }
+
+    // Replaces det[k] by orient2d(a, b, (x[k], y[k])) for every lane k set in mask
+    void refine(const Point& a, const Point& b, const double* x, const double* y, int mask, double* det) {
+        for (int k = 0; mask != 0; ++k, mask >>= 1) {
+            if (mask & 1)
+                det[k] = lgm::orient2d(a, b, Point(x[k], y[k]));
+        }
+    }
+
+    Location locateScalar(const std::vector<Point>& v, double rayOriginX, double x, double y) {
+        Point p(x, y);
+        Point left(rayOriginX, y);
+
+        bool odd = false;
+        const Point* a = &v.back();
+        for (const Point& b : v) {
+            Direction p_sgn    = ccw(*a, b, p);
+            Direction left_sgn = ccw(*a, b, left);
+
+            double minY = std::min(a->y, b.y);
+            double maxY = std::max(a->y, b.y);
+            if (p_sgn == Direction::COLLINEAR &&
+                p.x <= std::max(a->x, b.x) && p.x >= std::min(a->x, b.x) && p.y <= maxY && p.y >= minY)
+                return Location::BOUNDARY;
+
+            if (p_sgn != left_sgn && p.y > minY && p.y <= maxY)
+                odd = !odd;
+            a = &b;
+        }
+        return odd ? Location::INSIDE : Location::OUTSIDE;
+    }
+
+#ifdef LGM_HAS_AVX2
+    LGM_AVX2_TARGET
+    size_t locateAvx2(const std::vector<Point>& v, double rayOriginX,
+                      const double* x, const double* y, size_t count, Location* result) {
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d signBit = _mm256_set1_pd(-0.0);
+        const __m256d errBound = _mm256_set1_pd(lgm::ORIENT2D_ERRBOUND);
+        const double leftX[4] = {rayOriginX, rayOriginX, rayOriginX, rayOriginX};
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256d px = _mm256_loadu_pd(x + i);
+            __m256d py = _mm256_loadu_pd(y + i);
+            __m256d boundary = zero;
+            __m256d odd = zero;
+
+            const Point* a = &v.back();
+            for (const Point& b : v) {
+                __m256d ax = _mm256_set1_pd(a->x);
+                __m256d ay = _mm256_set1_pd(a->y);
+                __m256d bx = _mm256_set1_pd(b.x);
+                __m256d by = _mm256_set1_pd(b.y);
+                __m256d minX = _mm256_set1_pd(std::min(a->x, b.x));
+                __m256d maxX = _mm256_set1_pd(std::max(a->x, b.x));
+                __m256d minY = _mm256_set1_pd(std::min(a->y, b.y));
+                __m256d maxY = _mm256_set1_pd(std::max(a->y, b.y));
+
+                // orient2d(a, b, p) and orient2d(a, b, left), left = (rayOriginX, p.y)
+                __m256d bcy = _mm256_sub_pd(by, py);
+                __m256d acy = _mm256_sub_pd(ay, py);
+                __m256d pLeft = _mm256_mul_pd(_mm256_sub_pd(ax, px), bcy);
+                __m256d pRight = _mm256_mul_pd(acy, _mm256_sub_pd(bx, px));
+                __m256d lLeft = _mm256_mul_pd(_mm256_set1_pd(a->x - rayOriginX), bcy);
+                __m256d lRight = _mm256_mul_pd(acy, _mm256_set1_pd(b.x - rayOriginX));
+                __m256d detP = _mm256_sub_pd(pLeft, pRight);
+                __m256d detL = _mm256_sub_pd(lLeft, lRight);
+
+                __m256d pBound = _mm256_mul_pd(errBound, _mm256_add_pd(_mm256_andnot_pd(signBit, pLeft),
+                                                                       _mm256_andnot_pd(signBit, pRight)));
+                __m256d lBound = _mm256_mul_pd(errBound, _mm256_add_pd(_mm256_andnot_pd(signBit, lLeft),
+                                                                       _mm256_andnot_pd(signBit, lRight)));
+                int pUncertain = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_andnot_pd(signBit, detP), pBound, _CMP_LT_OQ));
+                int lUncertain = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_andnot_pd(signBit, detL), lBound, _CMP_LT_OQ));
+                if (pUncertain) {
+                    double det[4];
+                    _mm256_storeu_pd(det, detP);
+                    refine(*a, b, x + i, y + i, pUncertain, det);
+                    detP = _mm256_loadu_pd(det);
+                }
+                if (lUncertain) {
+                    double det[4];
+                    _mm256_storeu_pd(det, detL);
+                    refine(*a, b, leftX, y + i, lUncertain, det);
+                    detL = _mm256_loadu_pd(det);
+                }
+
+                __m256d pPos = _mm256_cmp_pd(detP, zero, _CMP_GT_OQ);
+                __m256d pNeg = _mm256_cmp_pd(detP, zero, _CMP_LT_OQ);
+                __m256d lPos = _mm256_cmp_pd(detL, zero, _CMP_GT_OQ);
+                __m256d lNeg = _mm256_cmp_pd(detL, zero, _CMP_LT_OQ);
+
+                __m256d collinear = _mm256_cmp_pd(detP, zero, _CMP_EQ_OQ);
+                __m256d inBox = _mm256_and_pd(
+                        _mm256_and_pd(_mm256_cmp_pd(px, minX, _CMP_GE_OQ), _mm256_cmp_pd(px, maxX, _CMP_LE_OQ)),
+                        _mm256_and_pd(_mm256_cmp_pd(py, minY, _CMP_GE_OQ), _mm256_cmp_pd(py, maxY, _CMP_LE_OQ)));
+                boundary = _mm256_or_pd(boundary, _mm256_and_pd(collinear, inBox));
+
+                __m256d differ = _mm256_or_pd(_mm256_xor_pd(pPos, lPos), _mm256_xor_pd(pNeg, lNeg));
+                __m256d inSlab = _mm256_and_pd(_mm256_cmp_pd(py, minY, _CMP_GT_OQ), _mm256_cmp_pd(py, maxY, _CMP_LE_OQ));
+                odd = _mm256_xor_pd(odd, _mm256_and_pd(differ, inSlab));
+                a = &b;
+            }
+            int boundaryMask = _mm256_movemask_pd(boundary);
+            int oddMask = _mm256_movemask_pd(odd);
+            for (int k = 0; k < 4; ++k)
+                result[i + k] = toLocation((boundaryMask >> k) & 1, (oddMask >> k) & 1);
+        }
+        return i;
+    }
+#endif
+
+#ifdef LGM_HAS_SSE2
+    size_t locateSse2(const std::vector<Point>& v, double rayOriginX,
+                      const double* x, const double* y, size_t count, Location* result) {
+        const __m128d zero = _mm_setzero_pd();
+        const __m128d signBit = _mm_set1_pd(-0.0);
+        const __m128d errBound = _mm_set1_pd(lgm::ORIENT2D_ERRBOUND);
+        const double leftX[2] = {rayOriginX, rayOriginX};
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2) {
+            __m128d px = _mm_loadu_pd(x + i);
+            __m128d py = _mm_loadu_pd(y + i);
+            __m128d boundary = zero;
+            __m128d odd = zero;
+
+            const Point* a = &v.back();
+            for (const Point& b : v) {
+                __m128d ax = _mm_set1_pd(a->x);
+                __m128d ay = _mm_set1_pd(a->y);
+                __m128d bx = _mm_set1_pd(b.x);
+                __m128d by = _mm_set1_pd(b.y);
+                __m128d minX = _mm_set1_pd(std::min(a->x, b.x));
+                __m128d maxX = _mm_set1_pd(std::max(a->x, b.x));
+                __m128d minY = _mm_set1_pd(std::min(a->y, b.y));
+                __m128d maxY = _mm_set1_pd(std::max(a->y, b.y));
+
+                __m128d bcy = _mm_sub_pd(by, py);
+                __m128d acy = _mm_sub_pd(ay, py);
+                __m128d pLeft = _mm_mul_pd(_mm_sub_pd(ax, px), bcy);
+                __m128d pRight = _mm_mul_pd(acy, _mm_sub_pd(bx, px));
+                __m128d lLeft = _mm_mul_pd(_mm_set1_pd(a->x - rayOriginX), bcy);
+                __m128d lRight = _mm_mul_pd(acy, _mm_set1_pd(b.x - rayOriginX));
+                __m128d detP = _mm_sub_pd(pLeft, pRight);
+                __m128d detL = _mm_sub_pd(lLeft, lRight);
+
+                __m128d pBound = _mm_mul_pd(errBound, _mm_add_pd(_mm_andnot_pd(signBit, pLeft),
+                                                                 _mm_andnot_pd(signBit, pRight)));
+                __m128d lBound = _mm_mul_pd(errBound, _mm_add_pd(_mm_andnot_pd(signBit, lLeft),
+                                                                 _mm_andnot_pd(signBit, lRight)));
+                int pUncertain = _mm_movemask_pd(_mm_cmplt_pd(_mm_andnot_pd(signBit, detP), pBound));
+                int lUncertain = _mm_movemask_pd(_mm_cmplt_pd(_mm_andnot_pd(signBit, detL), lBound));
+                if (pUncertain) {
+                    double det[2];
+                    _mm_storeu_pd(det, detP);
+                    refine(*a, b, x + i, y + i, pUncertain, det);
+                    detP = _mm_loadu_pd(det);
+                }
+                if (lUncertain) {
+                    double det[2];
+                    _mm_storeu_pd(det, detL);
+                    refine(*a, b, leftX, y + i, lUncertain, det);
+                    detL = _mm_loadu_pd(det);
+                }
+
+                __m128d pPos = _mm_cmpgt_pd(detP, zero);
+                __m128d pNeg = _mm_cmplt_pd(detP, zero);
+                __m128d lPos = _mm_cmpgt_pd(detL, zero);
+                __m128d lNeg = _mm_cmplt_pd(detL, zero);
+
+                __m128d collinear = _mm_cmpeq_pd(detP, zero);
+                __m128d inBox = _mm_and_pd(_mm_and_pd(_mm_cmpge_pd(px, minX), _mm_cmple_pd(px, maxX)),
+                                           _mm_and_pd(_mm_cmpge_pd(py, minY), _mm_cmple_pd(py, maxY)));
+                boundary = _mm_or_pd(boundary, _mm_and_pd(collinear, inBox));
+
+                __m128d differ = _mm_or_pd(_mm_xor_pd(pPos, lPos), _mm_xor_pd(pNeg, lNeg));
+                __m128d inSlab = _mm_and_pd(_mm_cmpgt_pd(py, minY), _mm_cmple_pd(py, maxY));
+                odd = _mm_xor_pd(odd, _mm_and_pd(differ, inSlab));
+                a = &b;
+            }
+            int boundaryMask = _mm_movemask_pd(boundary);
+            int oddMask = _mm_movemask_pd(odd);
+            for (int k = 0; k < 2; ++k)
+                result[i + k] = toLocation((boundaryMask >> k) & 1, (oddMask >> k) & 1);
+        }
+        return i;
+    }
+#endif
+
+#ifdef LGM_HAS_AVX2
+    bool hasAvx2() {
+#ifdef LGM_AVX2_DISPATCH
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+#else
+        return true;
+#endif
+    }
+#endif
+}
+
+void lgm::Polygon::locate(const double *x, const double *y, size_t count, lgm::Location *result) const {
+    if (grid_) {
+        for (size_t i = 0; i < count; ++i)
+            result[i] = grid_->locate(vertices_, Point(x[i], y[i]));
+        return;
+    }
+    if (index_) {
+        for (size_t i = 0; i < count; ++i)
+            result[i] = index_->locate(vertices_, Point(x[i], y[i]));
+        return;
+    }
+
+    size_t done = 0;
+#ifdef LGM_HAS_AVX2
+    if (hasAvx2())
+        done = locateAvx2(vertices_, RAY_ORIGIN_X, x, y, count, result);
+#endif
+#ifdef LGM_HAS_SSE2
+    done += locateSse2(vertices_, RAY_ORIGIN_X, x + done, y + done, count - done, result + done);
+#endif
+    for (size_t i = done; i < count; ++i)
+        result[i] = locateScalar(vertices_, RAY_ORIGIN_X, x[i], y[i]);
+}
@@ -0,0 +1,261 @@
+//
+// Hilbert packed R-tree over polygons.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+#include "../headers/PolygonRTree.h"
+
+namespace {
+    using lgm::Point;
+
+    const float INF = std::numeric_limits<float>::infinity();
+
+    // Single precision bounds containing the double ones
+    float roundDown(double v) {
+        float f = static_cast<float>(v);
+        return f > v ? std::nextafter(f, -INF) : f;
+    }
+
+    float roundUp(double v) {
+        float f = static_cast<float>(v);
+        return f < v ? std::nextafter(f, INF) : f;
+    }
+
+    // Position of (x, y) along the Hilbert curve filling the 2^16 x 2^16 grid
+    uint64_t hilbert(uint32_t x, uint32_t y) {
+        const uint32_t n = 1u << 16;
+        uint64_t d = 0;
+        for (uint32_t s = n / 2; s > 0; s /= 2) {
+            uint32_t rx = (x & s) ? 1 : 0;
+            uint32_t ry = (y & s) ? 1 : 0;
+            d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = n - 1 - x;
+                    y = n - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    }
+
+    double polygonDistance(const lgm::Polygon& polygon, const Point& p) {
+        if (polygon.contains(p))
+            return 0;
+        double result = std::numeric_limits<double>::infinity();
+        const Point* a = &polygon.vertices().back();
+        for (const Point& b : polygon.vertices()) {
+            Point ab = b - *a;
+            double t = std::min(std::max(lgm::dot(p - *a, ab) / lgm::dot(ab, ab), 0.0), 1.0);
+            result = std::min(result, lgm::distance(p, *a + t * ab));
+            a = &b;
+        }
+        return result;
+    }
+
+    template<typename PolygonT>
+    std::vector<const lgm::Polygon*> pointers(const std::vector<PolygonT>& polygons) {
+        std::vector<const lgm::Polygon*> result;
+        result.reserve(polygons.size());
+        for (const auto& polygon : polygons)
+            result.push_back(&polygon);
+        return result;
+    }
+}
+
+lgm::PolygonRTree::PolygonRTree(const std::vector<const Polygon *> &polygons) : polygons_(polygons) {
+    build();
+}
+
+lgm::PolygonRTree::PolygonRTree(const std::vector<Polygon> &polygons) : polygons_(pointers(polygons)) {
+    build();
+}
+
+lgm::PolygonRTree::PolygonRTree(const std::vector<ConvexPolygon> &polygons) : polygons_(pointers(polygons)) {
+    build();
+}
+
+void lgm::PolygonRTree::build() {
+    auto start = std::chrono::steady_clock::now();
+    const size_t n = polygons_.size();
+    if (n >= std::numeric_limits<uint32_t>::max())
+        throw std::invalid_argument("PolygonRTree supports up to 2^32 - 1 polygons.");
+
+    BoundingBox bounds;
+    std::vector<BoundingBox> boxes;
+    boxes.reserve(n);
+    for (const Polygon* polygon : polygons_) {
+        boxes.emplace_back(polygon->vertices());
+        bounds.add(boxes.back());
+    }
+
+    // Sort by the Hilbert index of the box centers so that consecutive polygons are close to each other
+    std::vector<std::pair<uint64_t, uint32_t>> order(n);
+    double width = std::max(bounds.maxX - bounds.minX, std::numeric_limits<double>::min());
+    double height = std::max(bounds.maxY - bounds.minY, std::numeric_limits<double>::min());
+    for (uint32_t i = 0; i < n; ++i) {
+        Point c = boxes[i].center();
+        auto x = static_cast<uint32_t>((c.x - bounds.minX) / width * 65535);
+        auto y = static_cast<uint32_t>((c.y - bounds.minY) / height * 65535);
+        order[i] = std::make_pair(hilbert(x, y), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<const Polygon*> polygons(n);
+    boxes_.resize(n);
+    ids_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        ids_[i] = order[i].second;
+        polygons[i] = polygons_[ids_[i]];
+        boxes_[i] = boxes[ids_[i]];
+    }
+    polygons_ = std::move(polygons);
+
+    // Pack every level into nodes of FANOUT consecutive entries of the level below
+    levels_.assign(1, 0);
+    size_t below = n;
+    do {
+        size_t count = (below + FANOUT - 1) / FANOUT;
+        size_t first = nodes_.size();
+        Node empty;
+        std::fill(std::begin(empty.minX), std::end(empty.minX), INF);
+        std::fill(std::begin(empty.minY), std::end(empty.minY), INF);
+        std::fill(std::begin(empty.maxX), std::end(empty.maxX), -INF);
+        std::fill(std::begin(empty.maxY), std::end(empty.maxY), -INF);
+        nodes_.resize(first + count, empty);
+        for (size_t child = 0; child < below; ++child) {
+            Node& node = nodes_[first + child / FANOUT];
+            size_t k = child % FANOUT;
+            if (levels_.size() == 1) {
+                node.minX[k] = roundDown(boxes_[child].minX);
+                node.minY[k] = roundDown(boxes_[child].minY);
+                node.maxX[k] = roundUp(boxes_[child].maxX);
+                node.maxY[k] = roundUp(boxes_[child].maxY);
+            } else {
+                const Node& c = nodes_[levels_[levels_.size() - 2] + child];
+                node.minX[k] = *std::min_element(std::begin(c.minX), std::end(c.minX));
+                node.minY[k] = *std::min_element(std::begin(c.minY), std::end(c.minY));
+                node.maxX[k] = *std::max_element(std::begin(c.maxX), std::end(c.maxX));
+                node.maxY[k] = *std::max_element(std::begin(c.maxY), std::end(c.maxY));
+            }
+        }
+        levels_.push_back(nodes_.size());
+        below = count;
+    } while (below > 1);
+    if (n == 0)
+        levels_.assign(1, 0);
+
+    buildTime_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename Visit>
+void lgm::PolygonRTree::search(const BoundingBox &box, Visit &&visit) const {
+    if (nodes_.empty())
+        return;
+    // (level, node) pairs; every level adds at most FANOUT - 1 pending siblings
+    std::pair<size_t, size_t> stack[64 * FANOUT];
+    size_t top = 0;
+    stack[top++] = std::make_pair(levels_.size() - 2, 0);
+    while (top > 0) {
+        size_t level = stack[--top].first;
+        size_t index = stack[top].second;
+        const Node& node = nodes_[levels_[level] + index];
+        for (size_t k = 0; k < FANOUT; ++k) {
+            if (node.minX[k] > box.maxX || node.maxX[k] < box.minX || node.minY[k] > box.maxY || node.maxY[k] < box.minY)
+                continue;
+            size_t child = index * FANOUT + k;
+            if (level == 0) {
+                if (boxes_[child].intersects(box))
+                    visit(child);
+            } else {
+                stack[top++] = std::make_pair(level - 1, child);
+            }
+        }
+    }
+}
+
+std::vector<size_t> lgm::PolygonRTree::containing(const Point &p) const {
+    std::vector<size_t> result;
+    search(BoundingBox(p.x, p.y, p.x, p.y), [&](size_t i) {
+        if (polygons_[i]->contains(p))
+            result.push_back(ids_[i]);
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<size_t> lgm::PolygonRTree::overlapping(const BoundingBox &box) const {
+    std::vector<size_t> result;
+    search(box, [&](size_t i) {
+        result.push_back(ids_[i]);
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<size_t> lgm::PolygonRTree::nearest(const Point &p, size_t k) const {
+    std::vector<size_t> result;
+    if (nodes_.empty() || k == 0)
+        return result;
+
+    // Best-first search. Kinds: 0 - node, 1 - polygon box, 2 - polygon at its exact distance.
+    // Equal distances expand nodes and boxes first, so ties come out by input index
+    struct Entry {
+        double distance;
+        int kind;
+        size_t level;
+        size_t index;
+        bool operator>(const Entry& rhs) const {
+            if (distance != rhs.distance) return distance > rhs.distance;
+            if (kind != rhs.kind) return kind > rhs.kind;
+            return index > rhs.index;
+        }
+    };
+    auto nodeDistance = [&](const Node& node, size_t k) {
+        return BoundingBox(node.minX[k], node.minY[k], node.maxX[k], node.maxY[k]).distance(p);
+    };
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    queue.push(Entry{0, 0, levels_.size() - 2, 0});
+    while (!queue.empty() && result.size() < k) {
+        Entry entry = queue.top();
+        queue.pop();
+        if (entry.kind == 2) {
+            result.push_back(entry.index);
+        } else if (entry.kind == 1) {
+            queue.push(Entry{polygonDistance(*polygons_[entry.index], p), 2, 0, ids_[entry.index]});
+        } else {
+            const Node& node = nodes_[levels_[entry.level] + entry.index];
+            for (size_t slot = 0; slot < FANOUT; ++slot) {
+                size_t child = entry.index * FANOUT + slot;
+                if (node.minX[slot] > node.maxX[slot])
+                    continue;
+                if (entry.level == 0)
+                    queue.push(Entry{boxes_[child].distance(p), 1, 0, child});
+                else
+                    queue.push(Entry{nodeDistance(node, slot), 0, entry.level - 1, child});
+            }
+        }
+    }
+    return result;
+}
+
+size_t lgm::PolygonRTree::size() const {
+    return polygons_.size();
+}
+
+double lgm::PolygonRTree::buildTime() const {
+    return buildTime_;
+}
+
+size_t lgm::PolygonRTree::memoryUsage() const {
+    return polygons_.capacity() * sizeof(const Polygon*) + boxes_.capacity() * sizeof(BoundingBox) +
+           ids_.capacity() * sizeof(uint32_t) + nodes_.capacity() * sizeof(Node) + levels_.capacity() * sizeof(size_t);
+}
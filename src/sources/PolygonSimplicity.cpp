@@ -0,0 +1,167 @@
+//
+// Shamos-Hoey simplicity test of a ring of edges.
+//
+// Consecutive edges are checked on their own first, in one pass: they must meet only at their common vertex.
+// The sweep then only has to find two edges that are not consecutive and meet at all. Until it finds them no two
+// edges cross, so the order of the status never changes between events and every comparison is an orientation
+// test between vertices. Edges starting at a point are inserted before the ones ending there are removed, so
+// edges touching at a point are neighbours in the status at some event.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+#include "../headers/Polygon.h"
+
+namespace {
+    using lgm::Point;
+    using lgm::Segment;
+    using lgm::Direction;
+    using lgm::EdgePair;
+
+    EdgePair ordered(size_t a, size_t b) {
+        return a < b ? EdgePair{a, b} : EdgePair{b, a};
+    }
+
+    class SimplicitySweep {
+    public:
+        explicit SimplicitySweep(const std::vector<Point>& vertices);
+
+        bool run(EdgePair* offending);
+    private:
+        struct Order {
+            const SimplicitySweep* sweep;
+            bool operator()(uint32_t lhs, uint32_t rhs) const {
+                return sweep->below(lhs, rhs);
+            }
+        };
+        using Status = std::set<uint32_t, Order>;
+
+        bool below(uint32_t lhs, uint32_t rhs) const;
+        bool meet(Status::iterator lower, Status::iterator upper, EdgePair* offending) const;
+
+        const size_t n_;
+        std::vector<Point> left_;
+        std::vector<Point> right_;
+        Status status_;
+        std::vector<Status::iterator> position_;
+    };
+
+    SimplicitySweep::SimplicitySweep(const std::vector<Point> &vertices)
+            : n_(vertices.size()), status_(Order{this}) {
+        left_.reserve(n_);
+        right_.reserve(n_);
+        for (size_t i = 0; i < n_; ++i) {
+            const Point& a = vertices[i];
+            const Point& b = vertices[i + 1 == n_ ? 0 : i + 1];
+            left_.push_back(std::min(a, b));
+            right_.push_back(std::max(a, b));
+        }
+        position_.resize(n_, status_.end());
+    }
+
+    // Edges ordered bottom to top where they both cross the sweep line, decided on the line of the one starting first
+    bool SimplicitySweep::below(uint32_t lhs, uint32_t rhs) const {
+        if (lhs == rhs)
+            return false;
+        if (left_[lhs] <= left_[rhs]) {
+            Direction d = ccw(left_[lhs], right_[lhs], left_[rhs]);
+            if (d == Direction::COLLINEAR)
+                d = ccw(left_[lhs], right_[lhs], right_[rhs]);
+            if (d != Direction::COLLINEAR)
+                return d == Direction::CCW;
+        } else {
+            Direction d = ccw(left_[rhs], right_[rhs], left_[lhs]);
+            if (d == Direction::COLLINEAR)
+                d = ccw(left_[rhs], right_[rhs], right_[lhs]);
+            if (d != Direction::COLLINEAR)
+                return d == Direction::CW;
+        }
+        // Overlapping edges, which meet() reports as soon as they are neighbours
+        return lhs < rhs;
+    }
+
+    bool SimplicitySweep::meet(Status::iterator lower, Status::iterator upper, EdgePair* offending) const {
+        const uint32_t a = *lower, b = *upper;
+        if (a + 1 == b || b + 1 == a || (a == 0 && b + 1 == n_) || (b == 0 && a + 1 == n_))
+            return false;
+        if (!intersects(Segment(left_[a], right_[a]), Segment(left_[b], right_[b])))
+            return false;
+        if (offending)
+            *offending = ordered(a, b);
+        return true;
+    }
+
+    bool SimplicitySweep::run(EdgePair* offending) {
+        // Event 2i starts edge i and 2i + 1 ends it; at one point every start comes before every end
+        std::vector<uint32_t> events(2 * n_);
+        for (uint32_t e = 0; e < events.size(); ++e)
+            events[e] = e;
+        auto point = [&](uint32_t e) -> const Point& {
+            return e % 2 == 0 ? left_[e / 2] : right_[e / 2];
+        };
+        std::sort(events.begin(), events.end(), [&](uint32_t lhs, uint32_t rhs) {
+            const Point& p = point(lhs);
+            const Point& q = point(rhs);
+            if (p != q)
+                return p < q;
+            return lhs % 2 < rhs % 2;
+        });
+
+        for (uint32_t e : events) {
+            const uint32_t edge = e / 2;
+            if (e % 2 == 0) {
+                auto it = status_.insert(edge).first;
+                position_[edge] = it;
+                if (it != status_.begin() && meet(std::prev(it), it, offending))
+                    return false;
+                if (std::next(it) != status_.end() && meet(it, std::next(it), offending))
+                    return false;
+            } else {
+                auto it = position_[edge];
+                if (it != status_.begin() && std::next(it) != status_.end() &&
+                    meet(std::prev(it), std::next(it), offending))
+                    return false;
+                status_.erase(it);
+            }
+        }
+        return true;
+    }
+}
+
+bool lgm::isSimple(const std::vector<Point> &vertices, EdgePair *offending) {
+    const size_t n = vertices.size();
+    if (n < 3)
+        throw std::logic_error("Polygon must have 3 or more vertices. "
+                               "Number of vertices provided: " + std::to_string(n));
+    if (n > UINT32_MAX / 2)
+        throw std::length_error("Simplicity test takes up to 2^31 - 1 vertices.");
+
+    // Edges i and i + 1 share vertices[i + 1]; they overlap when they fold back along one line
+    for (size_t i = 0; i < n; ++i) {
+        const size_t j = i + 1 == n ? 0 : i + 1;
+        const Point& a = vertices[i];
+        const Point& b = vertices[j];
+        const Point& c = vertices[j + 1 == n ? 0 : j + 1];
+        if (ccw(a, b, c) == Direction::COLLINEAR && (onSegment(Segment(a, b), c) || onSegment(Segment(b, c), a))) {
+            if (offending)
+                *offending = ordered(i, j);
+            return false;
+        }
+    }
+    return SimplicitySweep(vertices).run(offending);
+}
+
+bool lgm::Polygon::isSimple(EdgePair *offending) const {
+    return lgm::isSimple(vertices_, offending);
+}
+
+lgm::Polygon::Polygon(std::vector<Point> vertices, Validation validation) : Polygon(std::move(vertices)) {
+    EdgePair offending{};
+    if (validation == Validation::SIMPLE && !isSimple(&offending))
+        throw std::invalid_argument("Polygon is not simple: edges " + std::to_string(offending.first) + " and " +
+                                    std::to_string(offending.second) + " intersect.");
+}
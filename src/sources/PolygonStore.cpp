@@ -0,0 +1,254 @@
+//
+// Memory-mapped binary polygon store.
+//
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../headers/PolygonStore.h"
+
+namespace {
+    using lgm::Point;
+
+    const char MAGIC[8] = {'L', 'G', 'M', 'P', 'O', 'L', 'Y', '\0'};
+    const uint32_t VERSION = 1;
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t polygons;
+        uint64_t vertices;
+        uint64_t verticesOffset;
+        uint64_t offsetsOffset;
+        uint64_t checksum;        // of everything after the header
+        uint64_t headerChecksum;  // of the fields above
+    };
+    static_assert(sizeof(Header) == 64, "Header must take 64 bytes");
+    // Vertices are used in place as Point arrays
+    static_assert(sizeof(Point) == 2 * sizeof(double) && std::is_standard_layout<Point>::value,
+                  "Point must be laid out as two doubles");
+
+    // Order dependent hash of 64-bit words, several times faster than byte-wise FNV on large files
+    uint64_t checksum(uint64_t seed, const void* data, size_t bytes) {
+        const char* p = static_cast<const char*>(data);
+        uint64_t h = seed;
+        for (size_t i = 0; i + 8 <= bytes; i += 8) {
+            uint64_t w;
+            std::memcpy(&w, p + i, 8);
+            h ^= w;
+            h = (h << 29 | h >> 35) * 0x9e3779b97f4a7c15ull;
+        }
+        return h;
+    }
+
+    const uint64_t CHECKSUM_SEED = 0x6c676d706f6c7921ull;
+
+    uint64_t headerChecksum(const Header& header) {
+        return checksum(CHECKSUM_SEED, &header, offsetof(Header, headerChecksum));
+    }
+}
+
+lgm::PolygonStoreWriter::PolygonStoreWriter(const std::string &path)
+        : path_(path), out_(path, std::ios::binary | std::ios::trunc), offsets_(1, 0), checksum_(CHECKSUM_SEED),
+          closed_(false) {
+    if (!out_)
+        throw std::invalid_argument("Cannot open " + path + " for writing.");
+    // Placeholder, rewritten by close()
+    Header header = {};
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+lgm::PolygonStoreWriter::~PolygonStoreWriter() {
+    if (closed_)
+        return;
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void lgm::PolygonStoreWriter::write(const void *data, size_t bytes) {
+    out_.write(static_cast<const char*>(data), bytes);
+    if (!out_)
+        throw std::runtime_error("Cannot write to " + path_ + ".");
+    checksum_ = checksum(checksum_, data, bytes);
+}
+
+void lgm::PolygonStoreWriter::add(const std::vector<Point> &vertices) {
+    if (closed_)
+        throw std::logic_error("PolygonStoreWriter is closed.");
+    if (vertices.size() < 3)
+        throw std::logic_error("Polygon must have 3 or more vertices. "
+                               "Number of vertices provided: " + std::to_string(vertices.size()));
+    write(vertices.data(), vertices.size() * sizeof(Point));
+    offsets_.push_back(offsets_.back() + vertices.size());
+}
+
+void lgm::PolygonStoreWriter::add(const Polygon &polygon) {
+    add(polygon.vertices());
+}
+
+void lgm::PolygonStoreWriter::close() {
+    if (closed_)
+        return;
+    closed_ = true;
+    write(offsets_.data(), offsets_.size() * sizeof(uint64_t));
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.polygons = offsets_.size() - 1;
+    header.vertices = offsets_.back();
+    header.verticesOffset = sizeof(Header);
+    header.offsetsOffset = sizeof(Header) + header.vertices * sizeof(Point);
+    header.checksum = checksum_;
+    header.headerChecksum = headerChecksum(header);
+
+    out_.seekp(0);
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out_.close();
+    if (!out_)
+        throw std::runtime_error("Cannot write to " + path_ + ".");
+}
+
+lgm::PolygonStore::PolygonStore(const std::string &path)
+        : data_(nullptr), bytes_(0), vertices_(nullptr), offsets_(nullptr), size_(0), vertexCount_(0) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::invalid_argument("Cannot open " + path + ".");
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    bytes_ = static_cast<size_t>(size.QuadPart);
+    HANDLE mapping = bytes_ > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    CloseHandle(file);
+    if (mapping) {
+        data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::invalid_argument("Cannot open " + path + ".");
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        bytes_ = static_cast<size_t>(st.st_size);
+        void* data = ::mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+        data_ = data == MAP_FAILED ? nullptr : static_cast<const char*>(data);
+    }
+    ::close(fd);
+#endif
+    if (!data_ || bytes_ < sizeof(Header)) {
+        unmap();
+        throw std::invalid_argument(path + " is not a polygon store.");
+    }
+
+    Header header;
+    std::memcpy(&header, data_, sizeof(header));
+    std::string error;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+        error = " is not a polygon store.";
+    else if (header.byteOrder != BYTE_ORDER_MARK)
+        error = " was written on a machine with another byte order.";
+    else if (header.version != VERSION)
+        error = " has unsupported version " + std::to_string(header.version) + ".";
+    else if (header.headerChecksum != headerChecksum(header))
+        error = " has a corrupted header.";
+    else if (header.verticesOffset != sizeof(Header) ||
+             header.vertices > (bytes_ - sizeof(Header)) / sizeof(Point) ||
+             header.offsetsOffset != sizeof(Header) + header.vertices * sizeof(Point) ||
+             header.polygons + 1 != (bytes_ - header.offsetsOffset) / sizeof(uint64_t) ||
+             (bytes_ - header.offsetsOffset) % sizeof(uint64_t) != 0)
+        error = " is truncated or has a corrupted header.";
+    if (!error.empty()) {
+        unmap();
+        throw std::invalid_argument(path + error);
+    }
+
+    vertices_ = reinterpret_cast<const Point*>(data_ + header.verticesOffset);
+    offsets_ = reinterpret_cast<const uint64_t*>(data_ + header.offsetsOffset);
+    size_ = header.polygons;
+    vertexCount_ = header.vertices;
+}
+
+lgm::PolygonStore::~PolygonStore() {
+    unmap();
+}
+
+lgm::PolygonStore::PolygonStore(PolygonStore &&other) noexcept
+        : data_(other.data_), bytes_(other.bytes_), vertices_(other.vertices_), offsets_(other.offsets_),
+          size_(other.size_), vertexCount_(other.vertexCount_) {
+    other.data_ = nullptr;
+    other.bytes_ = other.size_ = other.vertexCount_ = 0;
+}
+
+lgm::PolygonStore &lgm::PolygonStore::operator=(PolygonStore &&other) noexcept {
+    if (this != &other) {
+        unmap();
+        std::swap(data_, other.data_);
+        std::swap(bytes_, other.bytes_);
+        std::swap(vertices_, other.vertices_);
+        std::swap(offsets_, other.offsets_);
+        std::swap(size_, other.size_);
+        std::swap(vertexCount_, other.vertexCount_);
+    }
+    return *this;
+}
+
+void lgm::PolygonStore::unmap() {
+    if (!data_)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    ::munmap(const_cast<char*>(data_), bytes_);
+#endif
+    data_ = nullptr;
+}
+
+lgm::PolygonView lgm::PolygonStore::operator[](size_t i) const {
+    if (i >= size_)
+        throw std::out_of_range("Polygon " + std::to_string(i) + " is out of range.");
+    uint64_t begin = offsets_[i], end = offsets_[i + 1];
+    // Offsets are covered by the data checksum only, which is not checked on open
+    if (begin > end || end > vertexCount_)
+        throw std::runtime_error("Polygon store has corrupted offsets.");
+    return PolygonView(vertices_ + begin, end - begin);
+}
+
+size_t lgm::PolygonStore::size() const {
+    return size_;
+}
+
+size_t lgm::PolygonStore::vertexCount() const {
+    return vertexCount_;
+}
+
+bool lgm::PolygonStore::verify() const {
+    Header header;
+    std::memcpy(&header, data_, sizeof(header));
+    return checksum(CHECKSUM_SEED, data_ + sizeof(Header), bytes_ - sizeof(Header)) == header.checksum;
+}
+
+void lgm::PolygonStore::write(const std::string &path, const std::vector<Polygon> &polygons) {
+    PolygonStoreWriter writer(path);
+    for (const auto& polygon : polygons)
+        writer.add(polygon);
+    writer.close();
+}
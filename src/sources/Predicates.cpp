@@ -0,0 +1,414 @@
+//
+// Adaptive orientation predicate, after J. R. Shewchuk's predicates.c.
+//
+// Expansion arithmetic relies on exactly rounded IEEE double operations: this file must not be compiled with
+// contracted multiply-adds or -ffast-math (see CMakeLists.txt).
+//
+
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#include "../headers/Point.h"
+#include "../headers/Predicates.h"
+
+namespace {
+    constexpr double EPSILON = 1.0 / (1ull << 53);          // half an ulp of 1
+    constexpr double SPLITTER = (1ull << 27) + 1.0;
+    constexpr double RESULT_ERRBOUND = (3.0 + 8.0 * EPSILON) * EPSILON;
+    constexpr double CCW_ERRBOUND_B = (2.0 + 12.0 * EPSILON) * EPSILON;
+    constexpr double CCW_ERRBOUND_C = (9.0 + 64.0 * EPSILON) * EPSILON * EPSILON;
+
+    std::atomic<uint64_t> adaptiveCalls(0);
+    std::atomic<uint64_t> exactCalls(0);
+
+    // x + y == a + b exactly, |a| >= |b|
+    inline void fastTwoSum(double a, double b, double& x, double& y) {
+        x = a + b;
+        y = b - (x - a);
+    }
+
+    // x + y == a + b exactly
+    inline void twoSum(double a, double b, double& x, double& y) {
+        x = a + b;
+        double bVirtual = x - a;
+        double aVirtual = x - bVirtual;
+        y = (a - aVirtual) + (b - bVirtual);
+    }
+
+    // Rounding error of x = a - b
+    inline double twoDiffTail(double a, double b, double x) {
+        double bVirtual = a - x;
+        double aVirtual = x + bVirtual;
+        return (a - aVirtual) + (bVirtual - b);
+    }
+
+    inline void twoDiff(double a, double b, double& x, double& y) {
+        x = a - b;
+        y = twoDiffTail(a, b, x);
+    }
+
+    // hi + lo == a with both halves fitting in 26 bits
+    inline void split(double a, double& hi, double& lo) {
+        double c = SPLITTER * a;
+        hi = c - (c - a);
+        lo = a - hi;
+    }
+
+    // x + y == a * b exactly
+    inline void twoProduct(double a, double b, double& x, double& y) {
+        x = a * b;
+        double aHi, aLo, bHi, bLo;
+        split(a, aHi, aLo);
+        split(b, bHi, bLo);
+        y = aLo * bLo - (((x - aHi * bHi) - aLo * bHi) - aHi * bLo);
+    }
+
+    // Expansion h[0..3] == (a1 + a0) - (b1 + b0), increasing magnitude
+    inline void twoTwoDiff(double a1, double a0, double b1, double b0, double* h) {
+        double i, j, k;
+        twoDiff(a0, b0, i, h[0]);
+        twoSum(a1, i, j, k);
+        twoDiff(k, b1, i, h[1]);
+        twoSum(j, i, h[3], h[2]);
+    }
+
+    double estimate(const double* e, int length) {
+        double sum = e[0];
+        for (int i = 1; i < length; ++i)
+            sum += e[i];
+        return sum;
+    }
+
+    // h = e + f for nonoverlapping expansions sorted by increasing magnitude, zero components removed
+    int fastExpansionSumZeroElim(const double* e, int eLength, const double* f, int fLength, double* h) {
+        int ei = 0, fi = 0, hi = 0;
+        auto nextE = [&] { return ++ei < eLength ? e[ei] : 0.0; };
+        auto nextF = [&] { return ++fi < fLength ? f[fi] : 0.0; };
+        double eNow = e[0];
+        double fNow = f[0];
+        double q, qNew, hh;
+        if ((fNow > eNow) == (fNow > -eNow)) {
+            q = eNow;
+            eNow = nextE();
+        } else {
+            q = fNow;
+            fNow = nextF();
+        }
+        if (ei < eLength && fi < fLength) {
+            if ((fNow > eNow) == (fNow > -eNow)) {
+                fastTwoSum(eNow, q, qNew, hh);
+                eNow = nextE();
+            } else {
+                fastTwoSum(fNow, q, qNew, hh);
+                fNow = nextF();
+            }
+            q = qNew;
+            if (hh != 0.0)
+                h[hi++] = hh;
+            while (ei < eLength && fi < fLength) {
+                if ((fNow > eNow) == (fNow > -eNow)) {
+                    twoSum(q, eNow, qNew, hh);
+                    eNow = nextE();
+                } else {
+                    twoSum(q, fNow, qNew, hh);
+                    fNow = nextF();
+                }
+                q = qNew;
+                if (hh != 0.0)
+                    h[hi++] = hh;
+            }
+        }
+        while (ei < eLength) {
+            twoSum(q, eNow, qNew, hh);
+            eNow = nextE();
+            q = qNew;
+            if (hh != 0.0)
+                h[hi++] = hh;
+        }
+        while (fi < fLength) {
+            twoSum(q, fNow, qNew, hh);
+            fNow = nextF();
+            q = qNew;
+            if (hh != 0.0)
+                h[hi++] = hh;
+        }
+        if (q != 0.0 || hi == 0)
+            h[hi++] = q;
+        return hi;
+    }
+
+    double orient2dAdaptive(const lgm::Point& a, const lgm::Point& b, const lgm::Point& c, double detSum) {
+        adaptiveCalls.fetch_add(1, std::memory_order_relaxed);
+
+        double acx = a.x - c.x;
+        double bcx = b.x - c.x;
+        double acy = a.y - c.y;
+        double bcy = b.y - c.y;
+
+        double detLeft, detLeftTail, detRight, detRightTail;
+        twoProduct(acx, bcy, detLeft, detLeftTail);
+        twoProduct(acy, bcx, detRight, detRightTail);
+        double B[4];
+        twoTwoDiff(detLeft, detLeftTail, detRight, detRightTail, B);
+
+        double det = estimate(B, 4);
+        double errBound = CCW_ERRBOUND_B * detSum;
+        if (det >= errBound || -det >= errBound)
+            return det;
+
+        double acxTail = twoDiffTail(a.x, c.x, acx);
+        double bcxTail = twoDiffTail(b.x, c.x, bcx);
+        double acyTail = twoDiffTail(a.y, c.y, acy);
+        double bcyTail = twoDiffTail(b.y, c.y, bcy);
+        if (acxTail == 0.0 && acyTail == 0.0 && bcxTail == 0.0 && bcyTail == 0.0)
+            return det;
+
+        errBound = CCW_ERRBOUND_C * detSum + RESULT_ERRBOUND * std::fabs(det);
+        det += (acx * bcyTail + bcy * acxTail) - (acy * bcxTail + bcx * acyTail);
+        if (det >= errBound || -det >= errBound)
+            return det;
+
+        exactCalls.fetch_add(1, std::memory_order_relaxed);
+        double s1, s0, t1, t0, u[4];
+        double C1[8], C2[12], D[16];
+
+        twoProduct(acxTail, bcy, s1, s0);
+        twoProduct(acyTail, bcx, t1, t0);
+        twoTwoDiff(s1, s0, t1, t0, u);
+        int c1Length = fastExpansionSumZeroElim(B, 4, u, 4, C1);
+
+        twoProduct(acx, bcyTail, s1, s0);
+        twoProduct(acy, bcxTail, t1, t0);
+        twoTwoDiff(s1, s0, t1, t0, u);
+        int c2Length = fastExpansionSumZeroElim(C1, c1Length, u, 4, C2);
+
+        twoProduct(acxTail, bcyTail, s1, s0);
+        twoProduct(acyTail, bcxTail, t1, t0);
+        twoTwoDiff(s1, s0, t1, t0, u);
+        int dLength = fastExpansionSumZeroElim(C2, c2Length, u, 4, D);
+
+        return D[dLength - 1];
+    }
+}
+
+namespace {
+    using lgm::Point;
+
+    // h = b * e for a nonoverlapping expansion e sorted by increasing magnitude, zero components removed
+    int scaleExpansionZeroElim(const double* e, int eLength, double b, double* h) {
+        double q, hh;
+        twoProduct(e[0], b, q, hh);
+        int hi = 0;
+        if (hh != 0.0)
+            h[hi++] = hh;
+        for (int ei = 1; ei < eLength; ++ei) {
+            double product1, product0, sum;
+            twoProduct(e[ei], b, product1, product0);
+            twoSum(q, product0, sum, hh);
+            if (hh != 0.0)
+                h[hi++] = hh;
+            fastTwoSum(product1, sum, q, hh);
+            if (hh != 0.0)
+                h[hi++] = hh;
+        }
+        if (q != 0.0 || hi == 0)
+            h[hi++] = q;
+        return hi;
+    }
+
+    const int UNCERTAIN = 2;
+
+    /*
+     * Exact value as an expansion: nonoverlapping components sorted by increasing magnitude, the last one
+     * carrying the sign
+     */
+    class Expansion {
+    public:
+        explicit Expansion(double a) : terms_(1, a) {}
+
+        friend Expansion operator+(const Expansion& e, const Expansion& f) {
+            Expansion h;
+            h.terms_.resize(e.terms_.size() + f.terms_.size());
+            h.terms_.resize(fastExpansionSumZeroElim(e.terms_.data(), static_cast<int>(e.terms_.size()),
+                                                     f.terms_.data(), static_cast<int>(f.terms_.size()),
+                                                     h.terms_.data()));
+            return h;
+        }
+
+        friend Expansion operator-(const Expansion& e, Expansion f) {
+            for (double& term : f.terms_)
+                term = -term;
+            return e + f;
+        }
+
+        friend Expansion operator*(const Expansion& e, const Expansion& f) {
+            Expansion product = e.scaled(f.terms_[0]);
+            for (size_t i = 1; i < f.terms_.size(); ++i)
+                product = product + e.scaled(f.terms_[i]);
+            return product;
+        }
+
+        friend int sign(const Expansion& e) {
+            const double top = e.terms_.back();
+            return (top > 0) - (top < 0);
+        }
+    private:
+        Expansion() = default;
+
+        Expansion scaled(double b) const {
+            Expansion h;
+            h.terms_.resize(2 * terms_.size());
+            h.terms_.resize(scaleExpansionZeroElim(terms_.data(), static_cast<int>(terms_.size()), b,
+                                                   h.terms_.data()));
+            return h;
+        }
+
+        std::vector<double> terms_;
+    };
+
+    /*
+     * Floating-point value with a bound on its absolute error. Every operation adds the error it inherits and
+     * twice the rounding error of its result; the slack in sign() covers the rounding of the bounds themselves.
+     */
+    struct Approximation {
+        double value;
+        double error;
+
+        explicit Approximation(double a) : value(a), error(0) {}
+        Approximation(double value, double error) : value(value), error(error) {}
+
+        friend Approximation operator+(const Approximation& a, const Approximation& b) {
+            const double value = a.value + b.value;
+            return Approximation(value, a.error + b.error + 2 * EPSILON * std::fabs(value));
+        }
+
+        friend Approximation operator-(const Approximation& a, const Approximation& b) {
+            const double value = a.value - b.value;
+            return Approximation(value, a.error + b.error + 2 * EPSILON * std::fabs(value));
+        }
+
+        friend Approximation operator*(const Approximation& a, const Approximation& b) {
+            const double value = a.value * b.value;
+            return Approximation(value, std::fabs(a.value) * b.error + std::fabs(b.value) * a.error +
+                                        a.error * b.error + 2 * EPSILON * std::fabs(value));
+        }
+
+        // Only for |b.value| > b.error, which leaves b away from 0
+        friend Approximation operator/(const Approximation& a, const Approximation& b) {
+            const double value = a.value / b.value;
+            return Approximation(value, (a.error + std::fabs(value) * b.error) / (std::fabs(b.value) - b.error) +
+                                        2 * EPSILON * std::fabs(value));
+        }
+
+        // UNCERTAIN unless the error bound proves the sign
+        friend int sign(const Approximation& a) {
+            if (!(std::fabs(a.value) > a.error * (1 + 1e-12)))
+                return UNCERTAIN;
+            return a.value > 0 ? 1 : -1;
+        }
+    };
+
+    int product(int lhs, int rhs) {
+        return lhs == UNCERTAIN || rhs == UNCERTAIN ? UNCERTAIN : lhs * rhs;
+    }
+
+    // X = p + (n / d) (q - p), the crossing point of the lines through p, q and through r, s
+    template<typename Number>
+    struct Crossing {
+        Number rx, ry, d, n;
+
+        Crossing(const Point& p, const Point& q, const Point& r, const Point& s)
+                : rx(Number(q.x) - Number(p.x)), ry(Number(q.y) - Number(p.y)), d(0), n(0) {
+            const Number sx = Number(s.x) - Number(r.x), sy = Number(s.y) - Number(r.y);
+            d = rx * sy - ry * sx;
+            n = (Number(r.x) - Number(p.x)) * sy - (Number(r.y) - Number(p.y)) * sx;
+        }
+    };
+
+    // X - c = (p - c) + (n / d) r, compared by the sign of d (X - c)
+    template<typename Number>
+    int compareCrossing(const Point& p, const Point& q, const Point& r, const Point& s, const Point& c) {
+        const Crossing<Number> x(p, q, r, s);
+        const int sd = sign(x.d);
+        const int sx = product(sign((Number(p.x) - Number(c.x)) * x.d + x.n * x.rx), sd);
+        if (sx != 0)
+            return sx;
+        return product(sign((Number(p.y) - Number(c.y)) * x.d + x.n * x.ry), sd);
+    }
+
+    // X - Y = (p - t) + (n1 / d1) r1 - (n2 / d2) r2, compared by the sign of d1 d2 (X - Y)
+    template<typename Number>
+    int compareCrossings(const Point& p, const Point& q, const Point& r, const Point& s,
+                         const Point& t, const Point& u, const Point& v, const Point& w) {
+        const Crossing<Number> x(p, q, r, s), y(t, u, v, w);
+        const int sd = product(sign(x.d), sign(y.d));
+        const Number dd = x.d * y.d;
+        const int sx = product(sign((Number(p.x) - Number(t.x)) * dd + x.n * x.rx * y.d - y.n * y.rx * x.d), sd);
+        if (sx != 0)
+            return sx;
+        return product(sign((Number(p.y) - Number(t.y)) * dd + x.n * x.ry * y.d - y.n * y.ry * x.d), sd);
+    }
+
+    // (b - a) x (X - a) = ((b - a) x (p - a) d + n (b - a) x r) / d
+    template<typename Number>
+    int orient2dCrossing(const Point& a, const Point& b, const Point& p, const Point& q, const Point& r,
+                         const Point& s) {
+        const Crossing<Number> x(p, q, r, s);
+        const Number bx = Number(b.x) - Number(a.x), by = Number(b.y) - Number(a.y);
+        const Number px = Number(p.x) - Number(a.x), py = Number(p.y) - Number(a.y);
+        return product(sign((bx * py - by * px) * x.d + x.n * (bx * x.ry - by * x.rx)), sign(x.d));
+    }
+}
+
+bool lgm::approximateCrossing(const Point &p, const Point &q, const Point &r, const Point &s, Point &x,
+                              Point &error) {
+    const Crossing<Approximation> crossing(p, q, r, s);
+    if (sign(crossing.d) == UNCERTAIN)
+        return false;
+    const Approximation t = crossing.n / crossing.d;
+    const Approximation cx = Approximation(p.x) + t * crossing.rx, cy = Approximation(p.y) + t * crossing.ry;
+    // With the slack of sign(), and room for rounding x +- error in comparisons
+    x = Point(cx.value, cy.value);
+    error = Point((cx.error + 2 * EPSILON * std::fabs(cx.value)) * (1 + 1e-12),
+                  (cy.error + 2 * EPSILON * std::fabs(cy.value)) * (1 + 1e-12));
+    return std::isfinite(error.x) && std::isfinite(error.y);
+}
+
+int lgm::compareCrossing(const Point &p, const Point &q, const Point &r, const Point &s, const Point &c) {
+    const int result = ::compareCrossing<Approximation>(p, q, r, s, c);
+    return result != UNCERTAIN ? result : ::compareCrossing<Expansion>(p, q, r, s, c);
+}
+
+int lgm::compareCrossings(const Point &p, const Point &q, const Point &r, const Point &s,
+                          const Point &t, const Point &u, const Point &v, const Point &w) {
+    const int result = ::compareCrossings<Approximation>(p, q, r, s, t, u, v, w);
+    return result != UNCERTAIN ? result : ::compareCrossings<Expansion>(p, q, r, s, t, u, v, w);
+}
+
+int lgm::orient2dCrossing(const Point &a, const Point &b, const Point &p, const Point &q, const Point &r,
+                          const Point &s) {
+    const int result = ::orient2dCrossing<Approximation>(a, b, p, q, r, s);
+    return result != UNCERTAIN ? result : ::orient2dCrossing<Expansion>(a, b, p, q, r, s);
+}
+
+double lgm::orient2d(const Point &a, const Point &b, const Point &c) {
+    double detLeft = (a.x - c.x) * (b.y - c.y);
+    double detRight = (a.y - c.y) * (b.x - c.x);
+    double det = detLeft - detRight;
+
+    // One predictable branch instead of the sign cases of predicates.c: the bound is the same
+    double detSum = std::fabs(detLeft) + std::fabs(detRight);
+    if (std::fabs(det) >= ORIENT2D_ERRBOUND * detSum)
+        return det;
+    return orient2dAdaptive(a, b, c, detSum);
+}
+
+lgm::PredicateCounters lgm::predicateCounters() {
+    return PredicateCounters{adaptiveCalls.load(std::memory_order_relaxed), exactCalls.load(std::memory_order_relaxed)};
+}
+
+void lgm::resetPredicateCounters() {
+    adaptiveCalls.store(0, std::memory_order_relaxed);
+    exactCalls.store(0, std::memory_order_relaxed);
+}
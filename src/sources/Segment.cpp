@@ -8,25 +8,8 @@
 #include "../headers/Segment.h"
 
 namespace lgm {
-    Segment::Segment(Point start, Point end) : start_(start), end_(end) {}
-    RefSegment::RefSegment(Point &start, Point &end) : start_(start), end_(end) {}
-
-    double AbstractSegment::length() const {
-        return distance(start(), end());
-    }
-
     bool intersects(const AbstractSegment &lhs, const AbstractSegment &rhs) {
-        Direction o1 = ccw(lhs.start(), lhs.end(), rhs.start());
-        Direction o2 = ccw(lhs.start(), lhs.end(), rhs.end());
-        Direction o3 = ccw(rhs.start(), rhs.end(), rhs.start());
-        Direction o4 = ccw(rhs.start(), rhs.end(), rhs.end());
-
-        if (o1 == Direction::COLLINEAR && onSegment(lhs, rhs.start())) return true;
-        if (o2 == Direction::COLLINEAR && onSegment(lhs, rhs.end()))   return true;
-        if (o3 == Direction::COLLINEAR && onSegment(rhs, lhs.start())) return true;
-        if (o4 == Direction::COLLINEAR && onSegment(rhs, lhs.end()))   return true;
-
-        return o1 != o2 && o3 != o4;
+        return intersects(lhs.start(), lhs.end(), rhs.start(), rhs.end());
     }
 
     Point calculateIntersection(const Segment &lhs, const Segment &rhs) {
@@ -60,8 +43,7 @@ namespace lgm {
 
     bool onSegment(const AbstractSegment &pq, const Point &r)
     {
-        return r.x <= std::max(pq.start().x, pq.end().x) && r.x >= std::min(pq.start().x, pq.end().x) &&
-               r.y <= std::max(pq.start().y, pq.end().y) && r.y >= std::min(pq.start().y, pq.end().y);
+        return onSegment(pq.start(), pq.end(), r);
     }
 
     Direction ccw(const AbstractSegment& pq, const Point &r) {
@@ -86,36 +68,4 @@ namespace lgm {
     bool operator>=(const AbstractSegment &lhs, const AbstractSegment &rhs) {
         return std::tie(lhs.start(), lhs.end()) >= std::tie(rhs.start(), rhs.end());
     }
-
-    Point &RefSegment::start() {
-        return start_;
-    }
-
-    Point &RefSegment::end() {
-        return end_;
-    }
-
-    const Point &RefSegment::start() const {
-        return start_;
-    }
-
-    const Point &RefSegment::end() const {
-        return end_;
-    }
-
-    Point &Segment::start() {
-        return start_;
-    }
-
-    Point &Segment::end() {
-        return end_;
-    }
-
-    const Point &Segment::start() const {
-        return start_;
-    }
-
-    const Point &Segment::end() const {
-        return end_;
-    }
-}
\ No newline at end of file
+}
@@ -0,0 +1,473 @@
+//
+// Bentley-Ottmann sweep over a set of segments.
+//
+// The sweep line moves in lexicographic (x, then y) order of points. The status keeps the segments crossing the
+// sweep line ordered from bottom to top. Crossing points are never rounded for the sweep: an event is either an
+// input point or the crossing of two segments, and events, and segments against an event, are compared with the
+// exact predicates of Predicates.h. All crossings at one point make one event, so near-concurrent segments still
+// meet in a consistent order and every pair is reported once. Rounded crossing points are only computed for the
+// callback.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <queue>
+#include <set>
+#include <vector>
+
+#include "../headers/SegmentIntersections.h"
+
+namespace {
+    using lgm::Point;
+    using lgm::Segment;
+    using lgm::Direction;
+    using lgm::SegmentIntersection;
+
+    const uint32_t PROBE = UINT32_MAX;
+
+    /*
+     * Same formula as calculateIntersection() for two properly crossing segments, with the parameter clamped
+     * instead of throwing when rounding pushes it slightly outside of the segment
+     */
+    Point crossingPoint(const Segment& lhs, const Segment& rhs) {
+        Point r = lhs.end() - lhs.start();
+        Point s = rhs.end() - rhs.start();
+        double t = lgm::cross(rhs.start() - lhs.start(), s) / lgm::cross(r, s);
+        return lhs.start() + std::min(std::max(t, 0.0), 1.0) * r;
+    }
+
+    Direction direction(int sign) {
+        return sign > 0 ? Direction::CCW : (sign < 0 ? Direction::CW : Direction::COLLINEAR);
+    }
+
+    /*
+     * Linear probing set of segment pairs. It only ever holds the pending crossings, so it stays small enough for
+     * the cache, where a node based set would not
+     */
+    class PairSet {
+    public:
+        PairSet() : slots_(16, EMPTY), size_(0) {}
+
+        // False if the pair was in the set already
+        bool insert(uint32_t first, uint32_t second) {
+            if (2 * (size_ + 1) > slots_.size())
+                grow();
+            if (!place(slots_, key(first, second)))
+                return false;
+            size_++;
+            return true;
+        }
+
+        void erase(uint32_t first, uint32_t second) {
+            const size_t mask = slots_.size() - 1;
+            const uint64_t k = key(first, second);
+            size_t i = home(k, mask);
+            while (slots_[i] != k) {
+                if (slots_[i] == EMPTY)
+                    return;
+                i = (i + 1) & mask;
+            }
+            // Shift back the keys after the hole that could not be placed at or before it
+            for (size_t j = (i + 1) & mask; slots_[j] != EMPTY; j = (j + 1) & mask) {
+                if (((j - home(slots_[j], mask)) & mask) >= ((j - i) & mask)) {
+                    slots_[i] = slots_[j];
+                    i = j;
+                }
+            }
+            slots_[i] = EMPTY;
+            size_--;
+        }
+    private:
+        static const uint64_t EMPTY = UINT64_MAX;
+
+        static uint64_t key(uint32_t first, uint32_t second) {
+            return static_cast<uint64_t>(first) << 32 | second;
+        }
+
+        static size_t home(uint64_t key, size_t mask) {
+            return lgm::detail::mix64(key) & mask;
+        }
+
+        static bool place(std::vector<uint64_t>& slots, uint64_t key) {
+            const size_t mask = slots.size() - 1;
+            for (size_t i = home(key, mask);; i = (i + 1) & mask) {
+                if (slots[i] == key)
+                    return false;
+                if (slots[i] == EMPTY) {
+                    slots[i] = key;
+                    return true;
+                }
+            }
+        }
+
+        void grow() {
+            std::vector<uint64_t> slots(2 * slots_.size(), EMPTY);
+            for (uint64_t key : slots_) {
+                if (key != EMPTY)
+                    place(slots, key);
+            }
+            slots_.swap(slots);
+        }
+
+        std::vector<uint64_t> slots_;
+        size_t size_;
+    };
+
+    const uint64_t PairSet::EMPTY;
+
+    class Sweep {
+    public:
+        Sweep(const std::vector<Segment>& segments, const std::function<void(const SegmentIntersection&)>& callback);
+
+        void run();
+    private:
+        struct Order {
+            const Sweep* sweep;
+            bool operator()(uint32_t lhs, uint32_t rhs) const {
+                return sweep->below(lhs, rhs);
+            }
+        };
+        using Status = std::set<uint32_t, Order>;
+
+        struct Endpoint {
+            Point point;
+            uint32_t segment;
+            bool start;
+        };
+
+        // Crossing point of two segments that properly cross, first < second
+        struct Crossing {
+            uint32_t first;
+            uint32_t second;
+            // The point lies within approximation +- error, which decides most comparisons without exact arithmetic
+            Point approximation;
+            Point error;
+        };
+        struct Later {
+            const Sweep* sweep;
+            bool operator()(const Crossing& lhs, const Crossing& rhs) const {
+                return sweep->compare(rhs, lhs) < 0;
+            }
+        };
+
+        // Current event point: an input point, or the crossing of two segments when crossing is set
+        struct Event {
+            Point point;        // only for input points
+            bool crossing;
+            Crossing segments;
+        };
+
+        bool below(uint32_t lhsSlot, uint32_t rhsSlot) const;
+        bool belowPast(uint32_t a, uint32_t b) const;
+        Direction side(uint32_t segment, const Point& p) const;
+        Direction side(uint32_t segment, const Event& event) const;
+        int compare(const Crossing& lhs, const Crossing& rhs) const;
+        int compare(const Crossing& crossing, const Point& p) const;
+        int compare(const Crossing& crossing, const Event& event) const;
+        bool proper(uint32_t a, uint32_t b) const;
+
+        void handleEndpoints(size_t first, size_t last);
+        void handleCrossing();
+        void reportAll(const std::vector<uint32_t>& involved);
+        void report(uint32_t a, uint32_t b, const Point& p);
+        void check(Status::iterator lower, Status::iterator upper);
+
+        Status::iterator insert(uint32_t segment);
+        void erase(uint32_t segment);
+
+        const std::vector<Segment>& segments_;
+        const std::function<void(const SegmentIntersection&)>& callback_;
+
+        std::vector<Point> left_;
+        std::vector<Point> right_;
+        std::vector<Endpoint> endpoints_;
+        std::priority_queue<Crossing, std::vector<Crossing>, Later> crossings_;
+        /*
+         * Pairs on crossings_. A pair gets off it only once the sweep has passed its crossing, and check() never
+         * schedules a crossing it has passed, so no pair is ever scheduled twice
+         */
+        PairSet scheduled_;
+
+        Status status_;
+        std::vector<uint32_t> slotSegment_;
+        std::vector<Status::iterator> position_;
+        std::vector<char> inBatch_;
+        std::vector<uint32_t> freeSlots_;
+        Event event_;
+    };
+
+    Sweep::Sweep(const std::vector<Segment> &segments, const std::function<void(const SegmentIntersection&)>& callback)
+            : segments_(segments), callback_(callback), crossings_(Later{this}), status_(Order{this}) {
+        const size_t n = segments.size();
+        left_.reserve(n);
+        right_.reserve(n);
+        endpoints_.reserve(2 * n);
+        for (uint32_t i = 0; i < n; ++i) {
+            left_.push_back(std::min(segments[i].start(), segments[i].end()));
+            right_.push_back(std::max(segments[i].start(), segments[i].end()));
+            endpoints_.push_back(Endpoint{left_[i], i, true});
+            endpoints_.push_back(Endpoint{right_[i], i, false});
+        }
+        std::sort(endpoints_.begin(), endpoints_.end(), [](const Endpoint& lhs, const Endpoint& rhs) {
+            return lhs.point < rhs.point;
+        });
+
+        slotSegment_.resize(n);
+        position_.resize(n, status_.end());
+        inBatch_.assign(n, 0);
+        freeSlots_.reserve(n);
+        for (uint32_t slot = static_cast<uint32_t>(n); slot-- > 0;)
+            freeSlots_.push_back(slot);
+    }
+
+    Direction Sweep::side(uint32_t segment, const Point &p) const {
+        return lgm::ccw(left_[segment], right_[segment], p);
+    }
+
+    Direction Sweep::side(uint32_t segment, const Event &event) const {
+        if (!event.crossing)
+            return side(segment, event.point);
+        const Crossing& c = event.segments;
+        if (segment == c.first || segment == c.second)
+            return Direction::COLLINEAR;
+        return direction(lgm::orient2dCrossing(left_[segment], right_[segment], left_[c.first], right_[c.first],
+                                               left_[c.second], right_[c.second]));
+    }
+
+    int Sweep::compare(const Crossing &lhs, const Crossing &rhs) const {
+        if (lhs.first == rhs.first && lhs.second == rhs.second)
+            return 0;
+        if (lhs.approximation.x + lhs.error.x < rhs.approximation.x - rhs.error.x)
+            return -1;
+        if (lhs.approximation.x - lhs.error.x > rhs.approximation.x + rhs.error.x)
+            return 1;
+        return lgm::compareCrossings(left_[lhs.first], right_[lhs.first], left_[lhs.second], right_[lhs.second],
+                                     left_[rhs.first], right_[rhs.first], left_[rhs.second], right_[rhs.second]);
+    }
+
+    int Sweep::compare(const Crossing &crossing, const Point &p) const {
+        if (crossing.approximation.x + crossing.error.x < p.x)
+            return -1;
+        if (crossing.approximation.x - crossing.error.x > p.x)
+            return 1;
+        return lgm::compareCrossing(left_[crossing.first], right_[crossing.first], left_[crossing.second],
+                                    right_[crossing.second], p);
+    }
+
+    int Sweep::compare(const Crossing &crossing, const Event &event) const {
+        return event.crossing ? compare(crossing, event.segments) : compare(crossing, event.point);
+    }
+
+    // No endpoint of either segment on the other one, so they meet at a single point inside both
+    bool Sweep::proper(uint32_t a, uint32_t b) const {
+        Direction o1 = side(a, left_[b]);
+        Direction o2 = side(a, right_[b]);
+        Direction o3 = side(b, left_[a]);
+        Direction o4 = side(b, right_[a]);
+        return o1 != Direction::COLLINEAR && o2 != Direction::COLLINEAR && o1 != o2 &&
+               o3 != Direction::COLLINEAR && o4 != Direction::COLLINEAR && o3 != o4;
+    }
+
+    // Order of two segments through the event point just past it, by direction
+    bool Sweep::belowPast(uint32_t a, uint32_t b) const {
+        Direction d = side(a, right_[b]);
+        if (d == Direction::COLLINEAR)
+            return a < b;
+        return d == Direction::CCW;
+    }
+
+    bool Sweep::below(uint32_t lhsSlot, uint32_t rhsSlot) const {
+        if (lhsSlot == PROBE)
+            return side(slotSegment_[rhsSlot], event_) == Direction::CW;
+        if (rhsSlot == PROBE)
+            return side(slotSegment_[lhsSlot], event_) == Direction::CCW;
+
+        uint32_t a = slotSegment_[lhsSlot];
+        uint32_t b = slotSegment_[rhsSlot];
+        // New segments pass through the event point; one already in the status lies strictly above or below it
+        if (inBatch_[a] && !inBatch_[b])
+            return side(b, event_) == Direction::CW;
+        if (!inBatch_[a] && inBatch_[b])
+            return side(a, event_) == Direction::CCW;
+        return belowPast(a, b);
+    }
+
+    Sweep::Status::iterator Sweep::insert(uint32_t segment) {
+        uint32_t slot = freeSlots_.back();
+        freeSlots_.pop_back();
+        slotSegment_[slot] = segment;
+        auto it = status_.insert(slot).first;
+        position_[segment] = it;
+        return it;
+    }
+
+    void Sweep::erase(uint32_t segment) {
+        freeSlots_.push_back(*position_[segment]);
+        status_.erase(position_[segment]);
+    }
+
+    void Sweep::report(uint32_t a, uint32_t b, const Point &p) {
+        if (a > b)
+            std::swap(a, b);
+        callback_(SegmentIntersection{a, b, Segment(p, p)});
+    }
+
+    void Sweep::run() {
+        size_t next = 0;
+        while (next < endpoints_.size() || !crossings_.empty()) {
+            if (!crossings_.empty() &&
+                (next == endpoints_.size() || compare(crossings_.top(), endpoints_[next].point) < 0)) {
+                const Crossing& c = crossings_.top();
+                event_ = Event{Point(), true, c};
+                handleCrossing();
+            } else {
+                event_ = Event{endpoints_[next].point, false, Crossing{0, 0, Point(), Point()}};
+                size_t last = next;
+                while (last < endpoints_.size() && endpoints_[last].point == event_.point)
+                    last++;
+                handleEndpoints(next, last);
+                next = last;
+            }
+            // Every crossing at the event point has been handled with it
+            while (!crossings_.empty() && compare(crossings_.top(), event_) == 0) {
+                scheduled_.erase(crossings_.top().first, crossings_.top().second);
+                crossings_.pop();
+            }
+        }
+    }
+
+    // Every pair of segments through the event point meets there, except collinear ones reported elsewhere
+    void Sweep::reportAll(const std::vector<uint32_t> &involved) {
+        if (event_.crossing && involved.size() == 2) {
+            report(involved[0], involved[1], crossingPoint(segments_[event_.segments.first],
+                                                           segments_[event_.segments.second]));
+            return;
+        }
+        for (size_t i = 0; i < involved.size(); ++i) {
+            for (size_t j = i + 1; j < involved.size(); ++j) {
+                uint32_t a = involved[i];
+                uint32_t b = involved[j];
+                bool collinear = side(a, left_[b]) == Direction::COLLINEAR && side(a, right_[b]) == Direction::COLLINEAR;
+                if (collinear) {
+                    // Collinear segments are reported once, where their common part starts
+                    Point overlapStart = std::max(left_[a], left_[b]);
+                    if (!event_.crossing && overlapStart == event_.point)
+                        callback_(SegmentIntersection{std::min(a, b), std::max(a, b),
+                                                      Segment(overlapStart, std::min(right_[a], right_[b]))});
+                    continue;
+                }
+                // Segments through a crossing point that is not an input point cross there
+                if (event_.crossing || proper(a, b))
+                    report(a, b, crossingPoint(segments_[std::min(a, b)], segments_[std::max(a, b)]));
+                else
+                    report(a, b, event_.point);
+            }
+        }
+    }
+
+    void Sweep::handleEndpoints(size_t first, size_t last) {
+        // All segments through the event point: a contiguous run of the status, bottom to top, and the ones starting here
+        std::vector<uint32_t> involved;
+        for (auto it = status_.lower_bound(PROBE), end = status_.upper_bound(PROBE); it != end; ++it)
+            involved.push_back(slotSegment_[*it]);
+        size_t passing = involved.size();
+        for (size_t i = first; i < last; ++i) {
+            if (endpoints_[i].start)
+                involved.push_back(endpoints_[i].segment);
+        }
+
+        // Re-insert the segments continuing past the event point, ordered by their direction
+        std::vector<uint32_t> batch;
+        for (size_t i = 0; i < involved.size(); ++i) {
+            if (i < passing)
+                erase(involved[i]);
+            if (right_[involved[i]] != event_.point)
+                batch.push_back(involved[i]);
+        }
+        for (uint32_t segment : batch)
+            inBatch_[segment] = 1;
+        for (uint32_t segment : batch)
+            insert(segment);
+        reportAll(involved);
+
+        if (batch.empty()) {
+            auto upper = status_.lower_bound(PROBE);
+            if (upper != status_.begin() && upper != status_.end())
+                check(std::prev(upper), upper);
+        } else {
+            auto lowest = position_[batch.front()];
+            while (lowest != status_.begin() && inBatch_[slotSegment_[*std::prev(lowest)]])
+                --lowest;
+            auto highest = position_[batch.front()];
+            while (std::next(highest) != status_.end() && inBatch_[slotSegment_[*std::next(highest)]])
+                ++highest;
+            if (lowest != status_.begin())
+                check(std::prev(lowest), lowest);
+            if (std::next(highest) != status_.end())
+                check(highest, std::next(highest));
+        }
+        for (uint32_t segment : batch)
+            inBatch_[segment] = 0;
+    }
+
+    /*
+     * No segment starts or ends at a crossing point that is not an input point, so the segments through it keep
+     * their run of slots: walking out from the crossing pair finds the run, and the segments are put back into it
+     * in their order past the point
+     */
+    void Sweep::handleCrossing() {
+        auto lowest = position_[event_.segments.first], highest = lowest;
+        while (lowest != status_.begin() && side(slotSegment_[*std::prev(lowest)], event_) == Direction::COLLINEAR)
+            --lowest;
+        while (std::next(highest) != status_.end() &&
+               side(slotSegment_[*std::next(highest)], event_) == Direction::COLLINEAR)
+            ++highest;
+
+        std::vector<uint32_t> involved;
+        for (auto it = lowest; it != std::next(highest); ++it)
+            involved.push_back(slotSegment_[*it]);
+        reportAll(involved);
+        std::sort(involved.begin(), involved.end(), [&](uint32_t a, uint32_t b) { return belowPast(a, b); });
+        auto it = lowest;
+        for (uint32_t segment : involved) {
+            slotSegment_[*it] = segment;
+            position_[segment] = it++;
+        }
+
+        if (lowest != status_.begin())
+            check(std::prev(lowest), lowest);
+        if (std::next(highest) != status_.end())
+            check(highest, std::next(highest));
+    }
+
+    void Sweep::check(Status::iterator lower, Status::iterator upper) {
+        uint32_t a = std::min(slotSegment_[*lower], slotSegment_[*upper]);
+        uint32_t b = std::max(slotSegment_[*lower], slotSegment_[*upper]);
+        // Only proper crossings are scheduled; every other contact involves an endpoint and is found there
+        if (!proper(a, b))
+            return;
+        Crossing crossing{a, b, Point(), Point()};
+        if (!lgm::approximateCrossing(left_[a], right_[a], left_[b], right_[b], crossing.approximation,
+                                      crossing.error))
+            crossing.error = Point(INFINITY, INFINITY);
+        // Neighbours that crossed at or before the event point have been handled already
+        if (compare(crossing, event_) <= 0)
+            return;
+        if (scheduled_.insert(a, b))
+            crossings_.push(crossing);
+    }
+}
+
+void lgm::calculateIntersections(const std::vector<Segment> &segments,
+                                 const std::function<void(const SegmentIntersection &)> &callback) {
+    Sweep(segments, callback).run();
+}
+
+std::vector<lgm::SegmentIntersection> lgm::calculateIntersections(const std::vector<Segment> &segments) {
+    std::vector<SegmentIntersection> result;
+    calculateIntersections(segments, [&](const SegmentIntersection& intersection) {
+        result.push_back(intersection);
+    });
+    return result;
+}
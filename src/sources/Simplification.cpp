@@ -0,0 +1,245 @@
+//
+// Polygon simplification: vertices are ranked once, every tolerance is a threshold on the ranks.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+#include "../headers/Simplification.h"
+#include "../headers/SegmentIntersections.h"
+
+namespace {
+    using lgm::Point;
+
+    const double KEEP = std::numeric_limits<double>::infinity();
+
+    // The tolerance up to which each vertex is kept; three anchors are never removed
+    struct Ranking {
+        std::vector<double> importance;
+        size_t anchors[3];
+    };
+
+    double segmentDistance(const Point& p, const Point& a, const Point& b) {
+        const Point ab = b - a;
+        const double squared = lgm::dot(ab, ab);
+        double t = squared > 0 ? lgm::dot(p - a, ab) / squared : 0;
+        t = std::max(0.0, std::min(1.0, t));
+        return lgm::distance(p, a + t * ab);
+    }
+
+    /*
+     * Top-down splits of both chains between vertex 0 and the vertex farthest from it. A vertex is ranked by its
+     * distance from the chord it splits, capped by the rank of the vertex that made the chord, so every threshold
+     * keeps exactly the vertices Douglas-Peucker keeps with that tolerance
+     */
+    Ranking douglasPeucker(const std::vector<Point>& v) {
+        const size_t n = v.size();
+        Ranking ranking;
+        ranking.importance.assign(n, 0);
+        size_t far = 1;
+        for (size_t i = 2; i < n; ++i)
+            if (lgm::distance(v[0], v[i]) > lgm::distance(v[0], v[far]))
+                far = i;
+        ranking.importance[0] = ranking.importance[far] = KEEP;
+
+        // Chords between ring positions i < j, which may run past n - 1 and wrap around
+        struct Chord {
+            size_t i;
+            size_t j;
+            double cap;
+        };
+        std::vector<Chord> stack{Chord{0, far, KEEP}, Chord{far, n, KEEP}};
+        double first = -1;
+        size_t third = far == 1 ? 2 : 1;
+        while (!stack.empty()) {
+            Chord chord = stack.back();
+            stack.pop_back();
+            if (chord.j - chord.i < 2)
+                continue;
+            const Point& a = v[chord.i % n];
+            const Point& b = v[chord.j % n];
+            size_t best = chord.i + 1;
+            double bestDistance = -1;
+            for (size_t k = chord.i + 1; k < chord.j; ++k) {
+                double d = segmentDistance(v[k % n], a, b);
+                if (d > bestDistance) {
+                    bestDistance = d;
+                    best = k;
+                }
+            }
+            double rank = std::min(bestDistance, chord.cap);
+            ranking.importance[best % n] = rank;
+            if (chord.cap == KEEP && bestDistance > first) {
+                first = bestDistance;
+                third = best % n;
+            }
+            stack.push_back(Chord{chord.i, best, rank});
+            stack.push_back(Chord{best, chord.j, rank});
+        }
+        ranking.anchors[0] = 0;
+        ranking.anchors[1] = far;
+        ranking.anchors[2] = third;
+        return ranking;
+    }
+
+    /*
+     * Bottom-up removal of the vertex with the smallest triangle, from a heap with stale entries skipped.
+     * Ranks never decrease along the removal order (a vertex whose triangle shrank below the last one removed
+     * goes at that rank), so every threshold keeps the vertices that outlast it
+     */
+    Ranking visvalingamWhyatt(const std::vector<Point>& v) {
+        const size_t n = v.size();
+        std::vector<size_t> prev(n), next(n);
+        std::vector<double> area(n);
+        for (size_t i = 0; i < n; ++i) {
+            prev[i] = i == 0 ? n - 1 : i - 1;
+            next[i] = i + 1 == n ? 0 : i + 1;
+        }
+        auto triangle = [&](size_t i) {
+            return std::abs(lgm::cross(v[i] - v[prev[i]], v[next[i]] - v[prev[i]])) / 2;
+        };
+        using Entry = std::pair<double, size_t>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+        for (size_t i = 0; i < n; ++i) {
+            area[i] = triangle(i);
+            heap.emplace(area[i], i);
+        }
+
+        Ranking ranking;
+        ranking.importance.assign(n, KEEP);
+        std::vector<char> removed(n, 0);
+        double last = 0;
+        for (size_t remaining = n; remaining > 3;) {
+            Entry top = heap.top();
+            heap.pop();
+            size_t i = top.second;
+            if (removed[i] || top.first != area[i])
+                continue;
+            last = std::max(last, top.first);
+            ranking.importance[i] = last;
+            removed[i] = 1;
+            --remaining;
+            next[prev[i]] = next[i];
+            prev[next[i]] = prev[i];
+            for (size_t j : {prev[i], next[i]}) {
+                area[j] = triangle(j);
+                heap.emplace(area[j], j);
+            }
+        }
+        size_t k = 0;
+        for (size_t i = 0; i < n && k < 3; ++i)
+            if (!removed[i])
+                ranking.anchors[k++] = i;
+        return ranking;
+    }
+
+    Ranking rank(const std::vector<Point>& v, lgm::Simplification method) {
+        return method == lgm::Simplification::DOUGLAS_PEUCKER ? douglasPeucker(v) : visvalingamWhyatt(v);
+    }
+
+    std::vector<Point> select(const std::vector<Point>& v, const Ranking& ranking, double tolerance) {
+        const size_t n = v.size();
+        std::vector<char> keep(n, 0), dropped(n, 0);
+        for (size_t i = 0; i < n; ++i)
+            keep[i] = ranking.importance[i] > tolerance;
+        for (size_t anchor : ranking.anchors)
+            keep[anchor] = 1;
+
+        std::vector<size_t> ring;
+        std::vector<lgm::Segment> edges;
+        // Puts back the best ranked vertex under edge e of the ring, if there is one
+        auto restore = [&](size_t e) {
+            size_t from = ring[e], to = ring[e + 1 == ring.size() ? 0 : e + 1];
+            size_t best = n;
+            for (size_t i = from + 1 == n ? 0 : from + 1; i != to; i = i + 1 == n ? 0 : i + 1)
+                if (!dropped[i] && (best == n || ranking.importance[i] > ranking.importance[best]))
+                    best = i;
+            if (best == n)
+                return false;
+            keep[best] = 1;
+            return true;
+        };
+
+        while (true) {
+            ring.clear();
+            for (size_t i = 0; i < n; ++i)
+                if (keep[i])
+                    ring.push_back(i);
+            const size_t m = ring.size();
+            edges.clear();
+            for (size_t e = 0; e < m; ++e)
+                edges.emplace_back(v[ring[e]], v[ring[e + 1 == m ? 0 : e + 1]]);
+
+            // Neighbouring edges may only meet at their common vertex
+            bool restored = false;
+            for (const auto& meeting : lgm::calculateIntersections(edges)) {
+                size_t a = meeting.first, b = meeting.second;
+                bool adjacent = b == a + 1 || (a == 0 && b == m - 1);
+                const Point& shared = v[ring[b == a + 1 ? b : 0]];
+                if (adjacent && meeting.intersection.start() == shared && meeting.intersection.end() == shared)
+                    continue;
+                bool first = restore(a), second = restore(b);
+                restored = restored || first || second;
+            }
+            if (restored)
+                continue;
+
+            // The ring is simple now, so a vertex collinear with its neighbours lies between them
+            std::vector<size_t> kept;
+            for (size_t k = 0; k < m; ++k) {
+                const Point& p = v[kept.empty() ? ring[m - 1] : kept.back()];
+                const Point& q = v[k + 1 < m ? ring[k + 1] : (kept.empty() ? ring[0] : kept.front())];
+                if (ccw(p, v[ring[k]], q) == lgm::Direction::COLLINEAR) {
+                    keep[ring[k]] = 0;
+                    dropped[ring[k]] = 1;
+                } else {
+                    kept.push_back(ring[k]);
+                }
+            }
+            if (kept.size() == m)
+                break;
+        }
+
+        std::vector<Point> result;
+        result.reserve(ring.size());
+        for (size_t i : ring)
+            result.push_back(v[i]);
+        return result;
+    }
+}
+
+lgm::Polygon lgm::simplify(const Polygon &polygon, double tolerance, Simplification method) {
+    const std::vector<Point>& v = polygon.vertices();
+    return Polygon(select(v, rank(v, method), tolerance));
+}
+
+lgm::PolygonLevels::PolygonLevels(const Polygon &polygon, std::vector<double> tolerances, Simplification method)
+        : original_(polygon), tolerances_(std::move(tolerances)) {
+    std::sort(tolerances_.begin(), tolerances_.end());
+    const std::vector<Point>& v = original_.vertices();
+    Ranking ranking = rank(v, method);
+    levels_.reserve(tolerances_.size());
+    for (double tolerance : tolerances_)
+        levels_.emplace_back(select(v, ranking, tolerance));
+}
+
+size_t lgm::PolygonLevels::size() const {
+    return levels_.size();
+}
+
+const lgm::Polygon& lgm::PolygonLevels::operator[](size_t i) const {
+    return levels_[i];
+}
+
+double lgm::PolygonLevels::tolerance(size_t i) const {
+    return tolerances_[i];
+}
+
+const lgm::Polygon& lgm::PolygonLevels::forTolerance(double tolerance) const {
+    auto it = std::upper_bound(tolerances_.begin(), tolerances_.end(), tolerance);
+    if (it == tolerances_.begin())
+        return original_;
+    return levels_[it - tolerances_.begin() - 1];
+}
@@ -0,0 +1,194 @@
+//
+// Uniform grid over an open-addressing hash table of cells.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "../headers/SpatialHash.h"
+
+namespace {
+    using lgm::Point;
+
+    // Cell numbers must fit in int64_t
+    const double CELL_LIMIT = 4e18;
+
+    uint64_t hashKey(uint64_t x, uint64_t y) {
+        return lgm::detail::mix64(x ^ lgm::detail::mix64(y + 0x9e3779b97f4a7c15ULL));
+    }
+}
+
+const size_t lgm::SpatialHash::NONE;
+const uint32_t lgm::SpatialHash::EMPTY;
+
+lgm::SpatialHash::SpatialHash(double cellSize, size_t expected) : cellSize_(cellSize) {
+    if (!(cellSize >= 0) || std::isinf(cellSize))
+        throw std::invalid_argument("Cell size must be finite and non-negative.");
+    rehash(16);
+    reserve(expected);
+}
+
+int64_t lgm::SpatialHash::cell(double v) const {
+    double q = std::floor(v / cellSize_);
+    if (!(std::abs(q) < CELL_LIMIT))
+        throw std::invalid_argument("Coordinate too far from the origin for the cell size.");
+    return static_cast<int64_t>(q);
+}
+
+lgm::SpatialHash::Key lgm::SpatialHash::key(const Point &p) const {
+    if (cellSize_ == 0)
+        return Key{detail::bits(p.x), detail::bits(p.y)};
+    return Key{static_cast<uint64_t>(cell(p.x)), static_cast<uint64_t>(cell(p.y))};
+}
+
+size_t lgm::SpatialHash::slot(const Key &k) const {
+    const uint64_t h = hashKey(k.x, k.y);
+    const auto tag = static_cast<uint32_t>(h >> 32);
+    const size_t mask = slots_.size() - 1;
+    size_t i = static_cast<size_t>(h) & mask;
+    // The key of a cell is not stored: the tag rules out almost every other cell, the first point confirms
+    while (slots_[i].head != EMPTY) {
+        if (slots_[i].tag == tag) {
+            Key other = key(points_[slots_[i].head]);
+            if (other.x == k.x && other.y == k.y)
+                break;
+        }
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+void lgm::SpatialHash::rehash(size_t capacity) {
+    std::vector<Slot> old(capacity, Slot{EMPTY, 0});
+    old.swap(slots_);
+    const size_t mask = capacity - 1;
+    for (const auto& s : old) {
+        if (s.head == EMPTY)
+            continue;
+        Key k = key(points_[s.head]);
+        size_t i = static_cast<size_t>(hashKey(k.x, k.y)) & mask;
+        while (slots_[i].head != EMPTY)
+            i = (i + 1) & mask;
+        slots_[i] = s;
+    }
+}
+
+size_t lgm::SpatialHash::insert(const Point &p) {
+    if (points_.size() >= EMPTY)
+        throw std::length_error("SpatialHash holds up to 2^32 - 1 points.");
+    if ((cells_ + 1) * 2 > slots_.size())
+        rehash(slots_.size() * 2);
+    const Key k = key(p);
+    const auto index = static_cast<uint32_t>(points_.size());
+    Slot& s = slots_[slot(k)];
+    if (s.head == EMPTY) {
+        s = Slot{index, static_cast<uint32_t>(hashKey(k.x, k.y) >> 32)};
+        next_.push_back(EMPTY);
+        ++cells_;
+    } else {
+        next_.push_back(s.head);
+        s.head = index;
+    }
+    points_.push_back(p);
+    return index;
+}
+
+template<typename Visit>
+void lgm::SpatialHash::around(const Point &p, double eps, Visit visit) const {
+    auto chain = [&](uint64_t x, uint64_t y) {
+        for (uint32_t i = slots_[slot(Key{x, y})].head; i != EMPTY; i = next_[i])
+            visit(i);
+    };
+    if (cellSize_ == 0) {
+        if (eps != 0)
+            throw std::invalid_argument("SpatialHash without cells only finds exact matches.");
+        chain(detail::bits(p.x), detail::bits(p.y));
+        return;
+    }
+    if (!(eps >= 0) || eps > cellSize_)
+        throw std::invalid_argument("eps must be between 0 and the cell size.");
+    // One ulp further out than p -/+ eps, so rounding of the subtraction never drops a cell
+    const double inf = std::numeric_limits<double>::infinity();
+    int64_t x0 = cell(std::nextafter(p.x - eps, -inf)), x1 = cell(std::nextafter(p.x + eps, inf));
+    int64_t y0 = cell(std::nextafter(p.y - eps, -inf)), y1 = cell(std::nextafter(p.y + eps, inf));
+    for (int64_t x = x0; x <= x1; ++x)
+        for (int64_t y = y0; y <= y1; ++y)
+            chain(static_cast<uint64_t>(x), static_cast<uint64_t>(y));
+}
+
+size_t lgm::SpatialHash::find(const Point &p, double eps) const {
+    size_t best = NONE;
+    const double squared = eps * eps;
+    around(p, eps, [&](uint32_t i) {
+        const Point& q = points_[i];
+        double dx = q.x - p.x, dy = q.y - p.y;
+        if (i < best && (q == p || dx * dx + dy * dy <= squared))
+            best = i;
+    });
+    return best;
+}
+
+bool lgm::SpatialHash::containsWithin(const Point &p, double eps) const {
+    return find(p, eps) != NONE;
+}
+
+size_t lgm::SpatialHash::insertUnique(const Point &p, double eps) {
+    size_t found = find(p, eps);
+    return found != NONE ? found : insert(p);
+}
+
+const std::vector<lgm::Point>& lgm::SpatialHash::points() const {
+    return points_;
+}
+
+size_t lgm::SpatialHash::size() const {
+    return points_.size();
+}
+
+double lgm::SpatialHash::cellSize() const {
+    return cellSize_;
+}
+
+void lgm::SpatialHash::reserve(size_t count) {
+    points_.reserve(count);
+    next_.reserve(count);
+    size_t capacity = slots_.size();
+    while (capacity < 2 * count)
+        capacity *= 2;
+    if (capacity > slots_.size())
+        rehash(capacity);
+}
+
+void lgm::SpatialHash::clear() {
+    points_.clear();
+    next_.clear();
+    std::fill(slots_.begin(), slots_.end(), Slot{EMPTY, 0});
+    cells_ = 0;
+}
+
+size_t lgm::SpatialHash::memoryUsage() const {
+    return slots_.capacity() * sizeof(Slot) + points_.capacity() * sizeof(Point) +
+           next_.capacity() * sizeof(uint32_t);
+}
+
+std::vector<lgm::Point> lgm::deduplicate(const std::vector<Point> &points, double eps) {
+    SpatialHash hash(eps, points.size());
+    for (const auto& p : points)
+        hash.insertUnique(p, eps);
+    return hash.points();
+}
+
+lgm::Point lgm::snap(const Point &p, double step) {
+    if (!(step > 0))
+        throw std::invalid_argument("Grid step must be positive.");
+    return Point(std::round(p.x / step) * step, std::round(p.y / step) * step);
+}
+
+std::vector<lgm::Point> lgm::snapToGrid(const std::vector<Point> &points, double step) {
+    SpatialHash hash(0, points.size());
+    for (const auto& p : points)
+        hash.insertUnique(snap(p, step));
+    return hash.points();
+}
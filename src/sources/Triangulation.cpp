@@ -0,0 +1,386 @@
+//
+// Triangulation of simple polygons.
+//
+// Both algorithms walk the vertices counter-clockwise through ring, an array of indices into vertices(), so clockwise
+// polygons are handled without reordering their vertices. The sweep runs from top to bottom; vertices at the same
+// height are ordered left to right, which is the same as turning the plane by an infinitesimal angle, so no two
+// vertices are ever level and no edge is horizontal. Orientation tests do not change under rotation.
+//
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+
+#include "../headers/Triangulation.h"
+
+namespace {
+    using lgm::Point;
+    using lgm::Direction;
+    using lgm::Triangle;
+    using lgm::detail::pseudoAngle;
+
+    const uint32_t NONE = UINT32_MAX;
+
+    bool above(const Point& p, const Point& q) {
+        return p.y > q.y || (p.y == q.y && p.x < q.x);
+    }
+
+    // Indices of the vertices in counter-clockwise order
+    std::vector<uint32_t> counterClockwise(const lgm::Polygon& polygon) {
+        const auto n = static_cast<uint32_t>(polygon.size());
+        const bool reversed = polygon.orientation() == Direction::CW;
+        std::vector<uint32_t> ring(n);
+        for (uint32_t i = 0; i < n; ++i)
+            ring[i] = reversed ? n - 1 - i : i;
+        return ring;
+    }
+
+    class Triangulator {
+    public:
+        Triangulator(const lgm::Polygon& polygon, std::vector<Triangle>& result)
+                : v_(polygon.vertices()), ring_(counterClockwise(polygon)), n_(static_cast<uint32_t>(polygon.size())),
+                  result_(result) {
+            result_.reserve(result_.size() + n_ - 2);
+        }
+
+        void earClipping();
+        void monotone();
+    private:
+        const Point& at(uint32_t k) const {
+            return v_[ring_[k]];
+        }
+        uint32_t next(uint32_t k) const {
+            return k + 1 == n_ ? 0 : k + 1;
+        }
+        uint32_t prev(uint32_t k) const {
+            return k == 0 ? n_ - 1 : k - 1;
+        }
+        void emit(uint32_t a, uint32_t b, uint32_t c);
+
+        // Edge k runs from vertex k to vertex k + 1; its upper end comes first in the sweep
+        uint32_t upper(uint32_t edge) const {
+            return above(at(edge), at(next(edge))) ? edge : next(edge);
+        }
+        uint32_t lower(uint32_t edge) const {
+            return above(at(edge), at(next(edge))) ? next(edge) : edge;
+        }
+
+        /*
+         * Edges crossing the sweep line, left to right. Edges in the status never cross, so an edge is only ever
+         * compared with the current vertex, or with an edge starting there: PROBE stands for the vertex itself
+         */
+        static const uint32_t PROBE = UINT32_MAX - 1;
+        struct LeftToRight {
+            const Triangulator* t;
+            bool operator()(uint32_t a, uint32_t b) const {
+                if (a == b)
+                    return false;
+                const Point& p = t->at(t->current_);
+                if (a == PROBE || t->upper(a) == t->current_)
+                    return ccw(t->at(t->lower(b)), t->at(t->upper(b)), p) == Direction::CCW;
+                return ccw(t->at(t->lower(a)), t->at(t->upper(a)), p) == Direction::CW;
+            }
+        };
+
+        void decompose(std::vector<std::pair<uint32_t, uint32_t>>& diagonals);
+        void triangulateFace(const std::vector<uint32_t>& face, std::vector<uint32_t>& sorted,
+                             std::vector<char>& left, std::vector<uint32_t>& stack);
+
+        const std::vector<Point>& v_;
+        std::vector<uint32_t> ring_;
+        uint32_t n_;
+        std::vector<Triangle>& result_;
+        uint32_t current_ = 0;
+    };
+
+    const uint32_t Triangulator::PROBE;
+
+    void Triangulator::emit(uint32_t a, uint32_t b, uint32_t c) {
+        if (ccw(at(a), at(b), at(c)) == Direction::CW)
+            std::swap(b, c);
+        result_.push_back(Triangle{ring_[a], ring_[b], ring_[c]});
+    }
+
+    void Triangulator::earClipping() {
+        std::vector<uint32_t> prev(n_), next(n_);
+        std::vector<char> reflex(n_);
+        std::vector<uint32_t> reflexes;
+        for (uint32_t k = 0; k < n_; ++k) {
+            prev[k] = this->prev(k);
+            next[k] = this->next(k);
+            reflex[k] = ccw(at(prev[k]), at(k), at(next[k])) == Direction::CW;
+            if (reflex[k])
+                reflexes.push_back(k);
+        }
+
+        // Only a reflex vertex can lie in a convex corner of the polygon; clipping never makes a vertex reflex
+        auto isEar = [&](uint32_t k, bool strict) {
+            const Point& a = at(prev[k]);
+            const Point& b = at(k);
+            const Point& c = at(next[k]);
+            Direction turn = ccw(a, b, c);
+            if (turn == Direction::CW || (strict && turn == Direction::COLLINEAR))
+                return false;
+            for (uint32_t r : reflexes) {
+                if (!reflex[r] || r == prev[k] || r == next[k])
+                    continue;
+                const Point& p = at(r);
+                if (ccw(a, b, p) != Direction::CW && ccw(b, c, p) != Direction::CW && ccw(c, a, p) != Direction::CW)
+                    return false;
+            }
+            return true;
+        };
+
+        uint32_t k = 0, remaining = n_, misses = 0;
+        // A simple polygon always has an ear; collinear leftovers only pass the relaxed test
+        bool strict = true;
+        while (remaining > 3) {
+            if (isEar(k, strict) || misses > 2 * remaining) {
+                uint32_t a = prev[k], c = next[k];
+                emit(a, k, c);
+                next[a] = c;
+                prev[c] = a;
+                reflex[k] = 0;
+                for (uint32_t x : {a, c})
+                    if (reflex[x] && ccw(at(prev[x]), at(x), at(next[x])) != Direction::CW)
+                        reflex[x] = 0;
+                reflexes.erase(std::remove_if(reflexes.begin(), reflexes.end(), [&](uint32_t r) {
+                    return !reflex[r];
+                }), reflexes.end());
+                --remaining;
+                misses = 0;
+                strict = true;
+                k = a;
+            } else {
+                k = next[k];
+                if (++misses > remaining)
+                    strict = false;
+            }
+        }
+        emit(prev[k], k, next[k]);
+    }
+
+    void Triangulator::decompose(std::vector<std::pair<uint32_t, uint32_t>>& diagonals) {
+        std::vector<uint32_t> events(n_);
+        for (uint32_t k = 0; k < n_; ++k)
+            events[k] = k;
+        std::sort(events.begin(), events.end(), [&](uint32_t a, uint32_t b) {
+            return above(at(a), at(b));
+        });
+
+        std::set<uint32_t, LeftToRight> status(LeftToRight{this});
+        std::vector<std::set<uint32_t, LeftToRight>::iterator> position(n_, status.end());
+        // Lowest vertex above the sweep line that a diagonal from below may connect to, for each edge in the status
+        std::vector<uint32_t> helper(n_, NONE);
+        std::vector<char> merge(n_, 0);
+
+        auto insert = [&](uint32_t edge) {
+            position[edge] = status.insert(edge).first;
+            helper[edge] = current_;
+        };
+        auto remove = [&](uint32_t edge) {
+            if (position[edge] == status.end())
+                throw std::invalid_argument("Polygon is not simple.");
+            if (merge[helper[edge]])
+                diagonals.emplace_back(current_, helper[edge]);
+            status.erase(position[edge]);
+            position[edge] = status.end();
+        };
+        // The edge directly left of the current vertex takes it as its helper
+        auto left = [&]() {
+            auto it = status.lower_bound(PROBE);
+            if (it == status.begin())
+                throw std::invalid_argument("Polygon is not simple.");
+            uint32_t edge = *--it;
+            if (merge[helper[edge]])
+                diagonals.emplace_back(current_, helper[edge]);
+            return edge;
+        };
+
+        for (uint32_t k : events) {
+            current_ = k;
+            uint32_t p = prev(k), q = next(k);
+            bool pBelow = above(at(k), at(p)), qBelow = above(at(k), at(q));
+            bool convex = ccw(at(p), at(k), at(q)) == Direction::CCW;
+            if (pBelow && qBelow) {
+                if (!convex) {
+                    // Split vertex: joined to the helper of the edge on its left, whatever kind that is
+                    auto it = status.lower_bound(PROBE);
+                    if (it == status.begin())
+                        throw std::invalid_argument("Polygon is not simple.");
+                    uint32_t edge = *--it;
+                    diagonals.emplace_back(k, helper[edge]);
+                    helper[edge] = k;
+                }
+                insert(k);
+            } else if (!pBelow && !qBelow) {
+                remove(p);
+                if (!convex) {
+                    merge[k] = 1;
+                    helper[left()] = k;
+                }
+            } else if (!pBelow) {
+                // Left chain: the interior lies to the right
+                remove(p);
+                insert(k);
+            } else {
+                helper[left()] = k;
+            }
+        }
+    }
+
+    void Triangulator::monotone() {
+        std::vector<std::pair<uint32_t, uint32_t>> diagonals;
+        decompose(diagonals);
+
+        // Half-edges bounding the pieces: polygon edges counter-clockwise, diagonals both ways
+        std::vector<uint32_t> offsets(n_ + 1, 0);
+        for (uint32_t k = 0; k < n_; ++k)
+            offsets[k + 1]++;
+        for (const auto& d : diagonals) {
+            offsets[d.first + 1]++;
+            offsets[d.second + 1]++;
+        }
+        for (uint32_t k = 0; k < n_; ++k)
+            offsets[k + 1] += offsets[k];
+        std::vector<uint32_t> target(offsets[n_]);
+        std::vector<double> angle(offsets[n_]);
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        auto add = [&](uint32_t from, uint32_t to) {
+            target[fill[from]++] = to;
+        };
+        for (uint32_t k = 0; k < n_; ++k)
+            add(k, next(k));
+        for (const auto& d : diagonals) {
+            add(d.first, d.second);
+            add(d.second, d.first);
+        }
+        // Outgoing half-edges of every vertex by angle
+        std::vector<uint32_t> order(target.size());
+        for (uint32_t k = 0; k < n_; ++k) {
+            for (uint32_t h = offsets[k]; h < offsets[k + 1]; ++h)
+                angle[h] = pseudoAngle(at(target[h]) - at(k));
+            if (offsets[k + 1] - offsets[k] > 1) {
+                std::vector<std::pair<double, uint32_t>> sorted;
+                for (uint32_t h = offsets[k]; h < offsets[k + 1]; ++h)
+                    sorted.emplace_back(angle[h], target[h]);
+                std::sort(sorted.begin(), sorted.end());
+                for (uint32_t h = offsets[k]; h < offsets[k + 1]; ++h) {
+                    angle[h] = sorted[h - offsets[k]].first;
+                    target[h] = sorted[h - offsets[k]].second;
+                }
+            }
+        }
+
+        std::vector<char> used(target.size(), 0);
+        std::vector<uint32_t> face, sorted, stack;
+        std::vector<char> left;
+        for (uint32_t start = 0; start < n_; ++start) {
+            for (uint32_t h0 = offsets[start]; h0 < offsets[start + 1]; ++h0) {
+                if (used[h0])
+                    continue;
+                face.clear();
+                uint32_t from = start, h = h0;
+                while (!used[h]) {
+                    used[h] = 1;
+                    face.push_back(from);
+                    uint32_t to = target[h];
+                    // Sharpest left turn: the first half-edge clockwise from the way back
+                    double back = pseudoAngle(at(from) - at(to));
+                    auto first = angle.begin() + offsets[to], last = angle.begin() + offsets[to + 1];
+                    auto it = std::lower_bound(first, last, back);
+                    h = static_cast<uint32_t>((it == first ? last : it) - angle.begin()) - 1;
+                    from = to;
+                }
+                if (face.size() < 3)
+                    throw std::invalid_argument("Polygon is not simple.");
+                triangulateFace(face, sorted, left, stack);
+            }
+        }
+    }
+
+    void Triangulator::triangulateFace(const std::vector<uint32_t>& face, std::vector<uint32_t>& sorted,
+                                       std::vector<char>& left, std::vector<uint32_t>& stack) {
+        const size_t k = face.size();
+        if (k == 3) {
+            emit(face[0], face[1], face[2]);
+            return;
+        }
+        size_t top = 0, bottom = 0;
+        for (size_t i = 1; i < k; ++i) {
+            if (above(at(face[i]), at(face[top])))
+                top = i;
+            if (above(at(face[bottom]), at(face[i])))
+                bottom = i;
+        }
+        // Counter-clockwise from the top, the left chain goes down to the bottom; the right chain comes back up
+        sorted.clear();
+        left.clear();
+        size_t l = top, r = top == 0 ? k - 1 : top - 1;
+        sorted.push_back(face[top]);
+        left.push_back(1);
+        l = l + 1 == k ? 0 : l + 1;
+        while (sorted.size() < k) {
+            bool takeLeft = r == bottom || (l != bottom && above(at(face[l]), at(face[r])));
+            if (l == bottom && r == bottom)
+                takeLeft = true;
+            if (takeLeft) {
+                sorted.push_back(face[l]);
+                left.push_back(1);
+                if (l == bottom)
+                    break;
+                l = l + 1 == k ? 0 : l + 1;
+            } else {
+                sorted.push_back(face[r]);
+                left.push_back(0);
+                r = r == 0 ? k - 1 : r - 1;
+            }
+        }
+
+        stack.clear();
+        stack.push_back(0);
+        stack.push_back(1);
+        for (size_t j = 2; j + 1 < k; ++j) {
+            if (left[j] != left[stack.back()]) {
+                // Opposite chain: fan to every vertex on the stack
+                for (size_t s = 0; s + 1 < stack.size(); ++s)
+                    emit(sorted[j], sorted[stack[s]], sorted[stack[s + 1]]);
+                uint32_t last = stack.back();
+                stack.clear();
+                stack.push_back(last);
+                stack.push_back(static_cast<uint32_t>(j));
+            } else {
+                // Same chain: cut off corners while the diagonal stays inside
+                uint32_t last = stack.back();
+                stack.pop_back();
+                Direction inside = left[j] ? Direction::CW : Direction::CCW;
+                while (!stack.empty() &&
+                       ccw(at(sorted[j]), at(sorted[last]), at(sorted[stack.back()])) == inside) {
+                    emit(sorted[j], sorted[last], sorted[stack.back()]);
+                    last = stack.back();
+                    stack.pop_back();
+                }
+                stack.push_back(last);
+                stack.push_back(static_cast<uint32_t>(j));
+            }
+        }
+        for (size_t s = 0; s + 1 < stack.size(); ++s)
+            emit(sorted[k - 1], sorted[stack[s]], sorted[stack[s + 1]]);
+    }
+}
+
+std::vector<lgm::Triangle> lgm::triangulate(const Polygon &polygon) {
+    return polygon.size() > EAR_CLIPPING_LIMIT ? triangulateMonotone(polygon) : triangulateEarClipping(polygon);
+}
+
+std::vector<lgm::Triangle> lgm::triangulateMonotone(const Polygon &polygon) {
+    std::vector<Triangle> result;
+    Triangulator(polygon, result).monotone();
+    return result;
+}
+
+std::vector<lgm::Triangle> lgm::triangulateEarClipping(const Polygon &polygon) {
+    std::vector<Triangle> result;
+    Triangulator(polygon, result).earClipping();
+    return result;
+}